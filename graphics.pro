@@ -1,9 +1,12 @@
 TEMPLATE = subdirs
 
 SUBDIRS = library \
-          example
+          example \
+          benchmark
 
 library.subdir  = graphics_library
 example.subdir  = graphics_example
+benchmark.subdir  = graphics_benchmark
 
 example.depends = library
+benchmark.depends = library
@@ -0,0 +1,155 @@
+#include <cstdlib>
+#include <new>
+#include <QAtomicInt>
+
+#include "allocationcounter.h"
+
+namespace {
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)) && defined(Q_ATOMIC_INT64_IS_SUPPORTED)
+
+//! Общее количество выделений памяти.
+QAtomicInteger<quint64> allocation_count;
+//! Общий объем выделенной памяти.
+QAtomicInteger<quint64> allocation_bytes;
+
+inline void countAllocation(std::size_t size)
+{
+    allocation_count.fetchAndAddRelaxed(1);
+    allocation_bytes.fetchAndAddRelaxed(size);
+}
+
+inline void loadCounters(quint64 *count, quint64 *bytes)
+{
+    *count = allocation_count.load();
+    *bytes = allocation_bytes.load();
+}
+
+#else
+
+// 64-разрядные атомарные счетчики недоступны, поэтому обычные счетчики защищаются
+// спин-блокировкой; мьютекс не подходит, так как сам выделяет память
+QBasicAtomicInt counter_lock = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+//! Общее количество выделений памяти.
+quint64 allocation_count = 0;
+//! Общий объем выделенной памяти.
+quint64 allocation_bytes = 0;
+
+inline void lockCounters()
+{
+    while (!counter_lock.testAndSetAcquire(0, 1))
+        ;
+}
+
+inline void unlockCounters()
+{
+    counter_lock.fetchAndStoreRelease(0);
+}
+
+inline void countAllocation(std::size_t size)
+{
+    lockCounters();
+    ++ allocation_count;
+    allocation_bytes += size;
+    unlockCounters();
+}
+
+inline void loadCounters(quint64 *count, quint64 *bytes)
+{
+    lockCounters();
+    *count = allocation_count;
+    *bytes = allocation_bytes;
+    unlockCounters();
+}
+
+#endif
+
+} // namespace
+
+
+// __libc_malloc и остальные точки входа есть только в glibc
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+
+extern "C" {
+
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+
+void *malloc(std::size_t size) __THROW
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) __THROW
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, std::size_t size) __THROW
+{
+    countAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+} // extern "C"
+
+#else
+
+void *operator new(std::size_t size)
+{
+    countAllocation(size);
+
+    void *ptr = std::malloc(size ? size : 1);
+    if (ptr == 0)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) Q_DECL_NOTHROW
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) Q_DECL_NOTHROW
+{
+    std::free(ptr);
+}
+
+#endif
+
+
+AllocationCounter::AllocationCounter()
+{
+    restart();
+}
+
+quint64 AllocationCounter::allocations() const
+{
+    quint64 count, bytes;
+    loadCounters(&count, &bytes);
+
+    return count - start_allocations;
+}
+
+quint64 AllocationCounter::bytes() const
+{
+    quint64 count, bytes;
+    loadCounters(&count, &bytes);
+
+    return bytes - start_bytes;
+}
+
+void AllocationCounter::restart()
+{
+    loadCounters(&start_allocations, &start_bytes);
+}
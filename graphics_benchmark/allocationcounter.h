@@ -0,0 +1,31 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief Счетчик выделений динамической памяти с момента создания объекта.
+ *
+ * На Linux с glibc перехватываются malloc/calloc/realloc, что учитывает и контейнеры Qt;
+ * на остальных платформах учитываются только глобальные operator new.
+ */
+class AllocationCounter {
+public:
+    //! Конструктор, запоминающий текущие значения счетчиков.
+    AllocationCounter();
+
+    //! Количество выделений памяти с момента создания.
+    quint64 allocations() const;
+    //! Объем выделенной памяти в байтах с момента создания.
+    quint64 bytes() const;
+
+    //! Сброс счетчика к текущим значениям.
+    void restart();
+private:
+    //! Количество выделений при создании.
+    quint64 start_allocations;
+    //! Объем выделенной памяти при создании.
+    quint64 start_bytes;
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,56 @@
+#ifndef BENCHMARKITEM_H
+#define BENCHMARKITEM_H
+
+#include <QPainter>
+#include <standardplotitem.h>
+#include <abstractplotitemfactory.h>
+
+class BenchmarkItem : public Graphics::StandardPlotItem {
+public:
+    BenchmarkItem() : Graphics::StandardPlotItem() {}
+    ~BenchmarkItem() {}
+
+    //! Количество отрисовок элементов с момента последнего сброса.
+    static int &paintedCount()
+    {
+        static int painted_count = 0;
+        return painted_count;
+    }
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+    {
+        Q_UNUSED(option);
+        Q_UNUSED(widget);
+
+        ++ paintedCount();
+
+        painter->fillRect(boundingRect().adjusted(0.5, 0.5, -0.5, -0.5), Qt::gray);
+    }
+};
+
+//! Фабрика элементов для сцены, подгружающей расписание из файла.
+class BenchmarkItemFactory : public Graphics::AbstractPlotItemFactory {
+public:
+    BenchmarkItemFactory() : Graphics::AbstractPlotItemFactory() {}
+
+    Graphics::AbstractPlotItem *createPlotItem(const Graphics::TimelineRecord &record, Qt::Orientation orientation)
+    {
+        BenchmarkItem *item = new BenchmarkItem();
+
+        if (orientation == Qt::Horizontal) {
+            item->setBeginCoordinates(record.begin_value, record.section);
+            item->setEndCoordinates(record.end_value, record.section);
+        }
+        else {
+            item->setBeginCoordinates(record.section, record.begin_value);
+            item->setEndCoordinates(record.section, record.end_value);
+        }
+
+        item->setWidthCalculated(true);
+        item->setHeightCalculated(true);
+
+        return item;
+    }
+};
+
+#endif // BENCHMARKITEM_H
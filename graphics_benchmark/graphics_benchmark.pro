@@ -0,0 +1,33 @@
+QT = core gui testlib
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TEMPLATE = app
+TARGET = graphics-benchmark
+
+CONFIG += console
+CONFIG -= app_bundle
+
+HEADERS = \
+    allocationcounter.h \
+    benchmarkitem.h \
+    plotbenchmark.h \
+    renderbenchmark.h \
+    schedulegenerator.h
+
+SOURCES = \
+    allocationcounter.cpp \
+    main.cpp \
+    plotbenchmark.cpp \
+    renderbenchmark.cpp \
+    schedulegenerator.cpp
+
+
+
+unix|win32: LIBS += -L$$PWD/../graphics_library/source/lib/ -lgraphics
+
+INCLUDEPATH += $$PWD/../graphics_library/source/include
+DEPENDPATH += $$PWD/../graphics_library/source/include
+
+win32:!win32-g++: PRE_TARGETDEPS += $$PWD/../graphics_library/source/lib/graphics.lib
+else:unix|win32-g++: PRE_TARGETDEPS += $$PWD/../graphics_library/source/lib/libgraphics.a
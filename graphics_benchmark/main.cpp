@@ -0,0 +1,85 @@
+#include <QtTest>
+#include <QApplication>
+
+#include "plotbenchmark.h"
+#include "renderbenchmark.h"
+
+
+//! Проверка наличия значения после параметра QTest \c option.
+static bool hasOptionValue(const QString &option)
+{
+    static const QStringList value_options = QStringList()
+            << QLatin1String("-o") << QLatin1String("-maxwarnings") << QLatin1String("-eventdelay")
+            << QLatin1String("-keydelay") << QLatin1String("-mousedelay") << QLatin1String("-iterations")
+            << QLatin1String("-minimumvalue") << QLatin1String("-minimumtotal") << QLatin1String("-median")
+            << QLatin1String("-perfcounter") << QLatin1String("-seed");
+
+    return value_options.contains(option);
+}
+
+//! Проверка наличия у объекта \c benchmark функции теста \c function (возможно, с тегом данных).
+static bool hasFunction(const QObject *benchmark, const QString &function)
+{
+    const QString name = function.section(QLatin1Char(':'), 0, 0) + QLatin1String("()");
+    return benchmark->metaObject()->indexOfMethod(QMetaObject::normalizedSignature(qPrintable(name))) != -1;
+}
+
+/*!
+ * \brief Запуск тестов объекта \c benchmark с аргументами командной строки \c arguments.
+ *
+ * Из имен функций в аргументах объекту передаются только его собственные; если имена заданы,
+ * но ни одно не принадлежит объекту, его тесты не запускаются.
+ */
+static int execBenchmark(QObject *benchmark, const QStringList &arguments)
+{
+    QStringList benchmark_arguments;
+
+    bool has_functions = false;
+    bool has_own_functions = false;
+
+    for (int i = 0; i < arguments.size(); ++ i) {
+        const QString &argument = arguments.at(i);
+
+        if ((i == 0) || argument.startsWith(QLatin1Char('-'))) {
+            benchmark_arguments << argument;
+
+            if (hasOptionValue(argument) && ((i + 1) < arguments.size()))
+                benchmark_arguments << arguments.at(++ i);
+
+            continue;
+        }
+
+        has_functions = true;
+
+        if (hasFunction(benchmark, argument)) {
+            benchmark_arguments << argument;
+            has_own_functions = true;
+        }
+    }
+
+    if (has_functions && !has_own_functions)
+        return 0;
+
+    return QTest::qExec(benchmark, benchmark_arguments);
+}
+
+int main(int argc, char *argv[])
+{
+    // измерения не требуют дисплея
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    const QStringList arguments = app.arguments();
+
+    int status = 0;
+
+    PlotBenchmark plot_benchmark;
+    status |= execBenchmark(&plot_benchmark, arguments);
+
+    RenderBenchmark render_benchmark;
+    status |= execBenchmark(&render_benchmark, arguments);
+
+    return status;
+}
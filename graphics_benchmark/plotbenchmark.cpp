@@ -0,0 +1,609 @@
+#include <algorithm>
+#include <QtTest>
+#include <QFont>
+#include <QFontMetrics>
+#include <QDir>
+
+#include <converter.h>
+#include <datetimescale.h>
+#include <datetimescaleengine.h>
+#include <standardplotscene.h>
+#include <infiniteplotscene.h>
+#include <sectionscale.h>
+#include <standardplotlayout.h>
+#include <standardplotlayoutt.h>
+#include <plotitemupdatequeue.h>
+#include <timelinefile.h>
+#include <timelineplotscene.h>
+#include <scheduleimporter.h>
+#include <tasktable.h>
+
+#include "plotbenchmark.h"
+#include "schedulegenerator.h"
+#include "allocationcounter.h"
+#include "benchmarkitem.h"
+
+using namespace Graphics;
+
+
+namespace {
+
+//! Количество шагов масштабирования в одну сторону.
+const int zoom_sweep_steps = 10;
+//! Количество шагов прокрутки в одну сторону.
+const int scroll_sweep_steps = 10;
+//! Количество запросов элементов по точке.
+const int point_queries_count = 1000;
+//! Количество запросов элементов по прямоугольнику.
+const int rect_queries_count = 100;
+//! Ширина видимой области сцены.
+const double visible_width = 1300.0;
+
+//! Заполнение сцены \c scene элементами \c items.
+void populateScene(StandardPlotScene *scene, const QList<AbstractPlotItem *> &items)
+{
+    foreach (AbstractPlotItem *item, items)
+        scene->addPlotItem(item);
+}
+
+//! Сравнение элементов \c left и \c right по концу на временной шкале.
+bool lessEndValue(const AbstractPlotItem *left, const AbstractPlotItem *right)
+{
+    return left->endCoordinateX() < right->endCoordinateX();
+}
+
+//! Увеличение и последующее уменьшение масштаба сцены \c scene.
+void runZoomSweep(StandardPlotScene *scene)
+{
+    for (int i = 0; i < zoom_sweep_steps; ++ i) {
+        scene->zoomIn();
+        scene->refresh();
+    }
+
+    for (int i = 0; i < zoom_sweep_steps; ++ i) {
+        scene->zoomOut();
+        scene->refresh();
+    }
+}
+
+//! Прокрутка сцены \c scene вперед и обратно.
+void runScrollSweep(StandardPlotScene *scene)
+{
+    // видимая область прижата к краю сцены, поэтому каждый шаг сдвигает диапазон шкалы
+    for (int i = 0; i < scroll_sweep_steps; ++ i) {
+        const QRectF scene_rect = scene->sceneRect();
+        scene->scrollForward(QRectF(scene_rect.right() - visible_width, scene_rect.top(),
+                                    visible_width, scene_rect.height()));
+    }
+
+    for (int i = 0; i < scroll_sweep_steps; ++ i) {
+        const QRectF scene_rect = scene->sceneRect();
+        scene->scrollBack(QRectF(scene_rect.left(), scene_rect.top(),
+                                 visible_width, scene_rect.height()));
+    }
+}
+
+//! Поиск элементов сцены \c scene по точкам \c points и прямоугольникам \c rects.
+int runItemQueries(StandardPlotScene *scene, const QList<QPointF> &points, const QList<QRectF> &rects)
+{
+    int found_count = 0;
+
+    foreach (const QPointF &point, points)
+        found_count += scene->plotItems(point).size();
+
+    foreach (const QRectF &rect, rects)
+        found_count += scene->plotItems(rect).size();
+
+    return found_count;
+}
+
+} // namespace
+
+
+
+PlotBenchmark::PlotBenchmark(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void PlotBenchmark::addScheduleRows()
+{
+    QTest::addColumn<int>("items_count");
+    QTest::addColumn<int>("sections_count");
+
+    const int sections_count = ScheduleGenerator::configuredSectionsCount();
+
+    foreach (int items_count, ScheduleGenerator::configuredItemsCounts()) {
+        const QByteArray name = QByteArray::number(items_count) + " items/" +
+                                QByteArray::number(sections_count) + " sections";
+        QTest::newRow(name.constData()) << items_count << sections_count;
+    }
+}
+
+void PlotBenchmark::reportAllocations(const AllocationCounter &counter)
+{
+    qDebug("allocations: %llu (%llu bytes)", counter.allocations(), counter.bytes());
+}
+
+void PlotBenchmark::addPlotItem_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::addPlotItem()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(false);
+    const QList<AbstractPlotItem *> items = generator.createItems();
+
+    AllocationCounter counter;
+    QBENCHMARK_ONCE {
+        populateScene(scene, items);
+    }
+    reportAllocations(counter);
+
+    delete scene;
+}
+
+void PlotBenchmark::addPlotItems_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::addPlotItems()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(false);
+    const QList<AbstractPlotItem *> items = generator.createItems();
+
+    AllocationCounter counter;
+    QBENCHMARK_ONCE {
+        scene->addPlotItems(items);
+    }
+    reportAllocations(counter);
+
+    delete scene;
+}
+
+void PlotBenchmark::refresh_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::refresh()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(false);
+    populateScene(scene, generator.createItems());
+
+    AllocationCounter counter;
+    scene->refresh();
+    reportAllocations(counter);
+
+    QBENCHMARK {
+        scene->refresh();
+    }
+
+    delete scene;
+}
+
+void PlotBenchmark::refreshConcurrent_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::refreshConcurrent()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(false);
+
+    StandardPlotLayout *layout = static_cast<StandardPlotLayout *>(scene->layout());
+    layout->setConcurrent(true);
+    layout->setConcurrentThreshold(1);
+
+    populateScene(scene, generator.createItems());
+
+    AllocationCounter counter;
+    scene->refresh();
+    reportAllocations(counter);
+
+    QBENCHMARK {
+        scene->refresh();
+    }
+
+    delete scene;
+}
+
+void PlotBenchmark::refreshSpecialized_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::refreshSpecialized()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(false);
+    // прежний объект позиционирования отвязывается от сцены в setLayout(), поэтому удаляется после замены
+    AbstractPlotLayout *old_layout = scene->layout();
+    scene->setLayout(new StandardPlotLayoutT<DateTimeScale, SectionScale>());
+    delete old_layout;
+    populateScene(scene, generator.createItems());
+
+    AllocationCounter counter;
+    scene->refresh();
+    reportAllocations(counter);
+
+    QBENCHMARK {
+        scene->refresh();
+    }
+
+    delete scene;
+}
+
+void PlotBenchmark::queuedUpdates_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::queuedUpdates()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(false);
+    const QList<AbstractPlotItem *> items = generator.createItems();
+    scene->addPlotItems(items);
+
+    PlotItemUpdateQueue *queue = scene->updateQueue();
+    double shift = 0.0;
+
+    // каждый элемент изменяется дважды, в сцену попадает одно объединенное изменение
+    QBENCHMARK {
+        shift = (shift > 0.0) ? 0.0 : 1.0;
+
+        foreach (AbstractPlotItem *item, items) {
+            queue->setBeginCoordinates(item, item->beginCoordinates() + QPointF(shift, 0.0));
+            queue->setEndCoordinates(item, item->endCoordinates() + QPointF(shift, 0.0));
+        }
+
+        QCoreApplication::processEvents();
+    }
+
+    delete scene;
+}
+
+void PlotBenchmark::zoomSweep_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::zoomSweep()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(false);
+    populateScene(scene, generator.createItems());
+    scene->refresh();
+
+    AllocationCounter counter;
+    runZoomSweep(scene);
+    reportAllocations(counter);
+
+    QBENCHMARK {
+        runZoomSweep(scene);
+    }
+
+    delete scene;
+}
+
+void PlotBenchmark::scrollSweep_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::scrollSweep()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(true);
+    populateScene(scene, generator.createItems());
+    scene->refresh();
+
+    AllocationCounter counter;
+    runScrollSweep(scene);
+    reportAllocations(counter);
+
+    QBENCHMARK {
+        runScrollSweep(scene);
+    }
+
+    delete scene;
+}
+
+void PlotBenchmark::streamAppend_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::streamAppend()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    InfinitePlotScene *scene = static_cast<InfinitePlotScene *>(generator.createScene(true));
+    scene->setRetention((generator.endValue() - generator.beginValue()) * 0.25);
+
+    QList<AbstractPlotItem *> items = generator.createItems();
+    std::sort(items.begin(), items.end(), lessEndValue);
+
+    // вышедшие за окно хранения элементы уничтожаются сценой, поэтому проход однократный
+    AllocationCounter counter;
+    QBENCHMARK_ONCE {
+        foreach (AbstractPlotItem *item, items)
+            scene->appendPlotItem(item);
+    }
+    reportAllocations(counter);
+
+    delete scene;
+}
+
+void PlotBenchmark::timelinePopulate_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::timelinePopulate()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+
+    const QString file_name = QDir::temp().filePath(QLatin1String("graphics_benchmark.timeline"));
+    QString error_string;
+    QVERIFY2(TimelineFile::write(file_name, generator.createRecords(), 1024, &error_string),
+             qPrintable(error_string));
+
+    TimelineFile file;
+    QVERIFY2(file.open(file_name), qPrintable(file.errorString()));
+
+    TimelinePlotScene *scene = new TimelinePlotScene();
+    generator.setupScene(scene, true);
+    scene->setPlotItemFactory(new BenchmarkItemFactory());
+
+    // элементы создаются только для видимого диапазона шкалы и добавляются из очереди подгрузки
+    AllocationCounter counter;
+    scene->setTimelineFile(&file);
+    while (scene->pendingPlotItemsCount() > 0)
+        QCoreApplication::processEvents();
+    reportAllocations(counter);
+
+    qDebug("materialized items: %d of %d", scene->plotItems().size(), items_count);
+
+    QBENCHMARK {
+        scene->reload();
+        while (scene->pendingPlotItemsCount() > 0)
+            QCoreApplication::processEvents();
+    }
+
+    delete scene;
+
+    file.close();
+    QFile::remove(file_name);
+}
+
+void PlotBenchmark::scheduleImport_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::scheduleImport()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+
+    const QString file_name = QDir::temp().filePath(QLatin1String("graphics_benchmark.csv"));
+    {
+        QFile file(file_name);
+        QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable(file.errorString()));
+
+        file.write("section,begin,end,label\n");
+        foreach (const TimelineRecord &record, generator.createRecords()) {
+            const QByteArray line = QByteArray::number(record.section) + ',' +
+                                    Converter::fromScale(record.begin_value).toUTC().toString(Qt::ISODate).toLatin1() + ',' +
+                                    Converter::fromScale(record.end_value).toUTC().toString(Qt::ISODate).toLatin1() + ',' +
+                                    "task " + QByteArray::number(record.id) + '\n';
+            file.write(line);
+        }
+    }
+
+    qint64 imported_count = 0;
+    QBENCHMARK_ONCE {
+        QScopedPointer<StandardPlotScene> scene(generator.createScene(false));
+
+        ScheduleImporter importer;
+        importer.setPlotScene(scene.data());
+        importer.setPlotItemFactory(new BenchmarkItemFactory());
+        importer.setTimeSpec(Qt::UTC);
+        importer.start(file_name, ScheduleImporter::FormatCsv);
+
+        while (importer.isRunning())
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+
+        imported_count = importer.importedCount();
+    }
+
+    QFile::remove(file_name);
+
+    QCOMPARE(imported_count, qint64(items_count));
+}
+
+void PlotBenchmark::itemQueries_data()
+{
+    QTest::addColumn<int>("items_count");
+    QTest::addColumn<int>("sections_count");
+    QTest::addColumn<int>("index_method");
+
+    const int sections_count = ScheduleGenerator::configuredSectionsCount();
+
+    QList<QPair<QByteArray, int> > methods;
+    methods << qMakePair(QByteArray("bsp"), int(StandardPlotScene::PlotIndexBspTree))
+            << qMakePair(QByteArray("none"), int(StandardPlotScene::PlotIndexNone))
+            << qMakePair(QByteArray("rows"), int(StandardPlotScene::PlotIndexRows));
+
+    foreach (int items_count, ScheduleGenerator::configuredItemsCounts()) {
+        for (int i = 0; i < methods.size(); ++ i) {
+            const QByteArray name = QByteArray::number(items_count) + " items/" +
+                                    QByteArray::number(sections_count) + " sections/" +
+                                    methods.at(i).first;
+            QTest::newRow(name.constData()) << items_count << sections_count << methods.at(i).second;
+        }
+    }
+}
+
+void PlotBenchmark::itemQueries()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+    QFETCH(int, index_method);
+
+    ScheduleGenerator generator(items_count, sections_count);
+    StandardPlotScene *scene = generator.createScene(false);
+    scene->setPlotIndexMethod(StandardPlotScene::PlotIndexMethod(index_method));
+    populateScene(scene, generator.createItems());
+    scene->refresh();
+
+    QList<QPointF> points;
+    QList<QRectF> rects;
+
+    for (int i = 0; i < point_queries_count; ++ i)
+        points.append(QPointF(generator.randomValue(), generator.randomSection() + 0.5));
+
+    for (int i = 0; i < rect_queries_count; ++ i) {
+        const double begin = generator.randomValue();
+        const int section = generator.randomSection();
+        rects.append(QRectF(QPointF(begin, section), QPointF(begin + 4 * 3600.0, section + 3)));
+    }
+
+    // первый запрос достраивает индекс сцены
+    scene->plotItems(points.first());
+
+    AllocationCounter counter;
+    const int found_count = runItemQueries(scene, points, rects);
+    reportAllocations(counter);
+
+    qDebug("items found: %d", found_count);
+
+    QBENCHMARK {
+        runItemQueries(scene, points, rects);
+    }
+
+    delete scene;
+}
+
+void PlotBenchmark::taskTableQueries_data()
+{
+    addScheduleRows();
+}
+
+void PlotBenchmark::taskTableQueries()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+
+    ScheduleGenerator generator(items_count, sections_count);
+
+    AllocationCounter counter;
+    TaskTable table;
+    table.reserve(items_count);
+    foreach (const TimelineRecord &record, generator.createRecords())
+        table.append(record.section, record.begin_value, record.end_value, record.kind, record.id);
+    table.buildIndex();
+    reportAllocations(counter);
+
+    QList<QPair<double, uint> > points;
+    for (int i = 0; i < point_queries_count; ++ i)
+        points.append(qMakePair(generator.randomValue(), uint(generator.randomSection())));
+
+    QList<QPair<double, uint> > rects;
+    for (int i = 0; i < rect_queries_count; ++ i)
+        rects.append(qMakePair(generator.randomValue(), uint(generator.randomSection())));
+
+    int found_count = 0;
+
+    QBENCHMARK {
+        found_count = 0;
+
+        for (int i = 0; i < points.size(); ++ i)
+            found_count += table.find(points.at(i).first, points.at(i).first, points.at(i).second, points.at(i).second).size();
+
+        for (int i = 0; i < rects.size(); ++ i)
+            found_count += table.find(rects.at(i).first, rects.at(i).first + 4 * 3600.0,
+                                      rects.at(i).second, rects.at(i).second + 2).size();
+    }
+
+    qDebug("tasks found: %d", found_count);
+}
+
+void PlotBenchmark::scaleEngineUpdate_data()
+{
+    QTest::addColumn<double>("range");
+
+    QTest::newRow("1 minute") << 60.0;
+    QTest::newRow("1 hour") << 3600.0;
+    QTest::newRow("1 day") << 86400.0;
+    QTest::newRow("1 month") << 30 * 86400.0;
+    QTest::newRow("1 year") << 365 * 86400.0;
+    QTest::newRow("10 years") << 3650 * 86400.0;
+}
+
+void PlotBenchmark::scaleEngineUpdate()
+{
+    QFETCH(double, range);
+
+    ScheduleGenerator generator(0, 1);
+
+    DateTimeScale scale;
+    scale.setOrientation(Qt::Horizontal);
+    scale.setLength(4000);
+    scale.setRange(generator.beginValue(), generator.beginValue() + range);
+
+    DateTimeScaleEngine engine;
+    engine.setScale(&scale);
+
+    const QFontMetrics font_metrics((QFont()));
+    const QRectF scale_rect(0.0, 0.0, scale.length(), 40.0);
+
+    AllocationCounter counter;
+    engine.update(font_metrics, scale_rect, false);
+    reportAllocations(counter);
+
+    QBENCHMARK {
+        engine.update(font_metrics, scale_rect, false);
+    }
+
+    qDebug("ticks: %d, labels: %d", engine.tickPositions().size(), engine.majorTickLabels().size());
+}
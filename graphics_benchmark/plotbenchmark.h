@@ -0,0 +1,81 @@
+#ifndef PLOTBENCHMARK_H
+#define PLOTBENCHMARK_H
+
+#include <QObject>
+
+class AllocationCounter;
+
+/*!
+ * \brief Набор измерений производительности сцены графика на синтетическом расписании.
+ *
+ * Размеры расписания задаются переменными окружения, см. ScheduleGenerator.
+ */
+class PlotBenchmark : public QObject {
+    Q_OBJECT
+public:
+    //! Конструктор с установкой родительского объекта \c parent.
+    explicit PlotBenchmark(QObject *parent = 0);
+private:
+    //! Заполнение строк данных размерами расписания.
+    void addScheduleRows();
+    //! Вывод количества выделений памяти за один проход, учтенных счетчиком \c counter.
+    void reportAllocations(const AllocationCounter &counter);
+private slots:
+    void addPlotItem_data();
+    //! Добавление элементов в сцену.
+    void addPlotItem();
+
+    void addPlotItems_data();
+    //! Добавление элементов в сцену одним вызовом с расчетом их положения.
+    void addPlotItems();
+
+    void refresh_data();
+    //! Полное обновление расположения элементов.
+    void refresh();
+
+    void refreshConcurrent_data();
+    //! Полное обновление расположения элементов с расчетом геометрии в рабочих потоках.
+    void refreshConcurrent();
+
+    void refreshSpecialized_data();
+    //! Полное обновление расположения элементов шаблонным позиционированием без виртуальных вызовов шкал.
+    void refreshSpecialized();
+
+    void queuedUpdates_data();
+    //! Применение изменений координат всех элементов через очередь изменений сцены.
+    void queuedUpdates();
+
+    void zoomSweep_data();
+    //! Последовательное увеличение и уменьшение масштаба с обновлением расположения.
+    void zoomSweep();
+
+    void scrollSweep_data();
+    //! Последовательная прокрутка бесконечной сцены вперед и назад.
+    void scrollSweep();
+
+    void streamAppend_data();
+    //! Добавление элементов в поток бесконечной сцены со следованием и окном хранения.
+    void streamAppend();
+
+    void timelinePopulate_data();
+    //! Подгрузка элементов видимого диапазона из файла расписания.
+    void timelinePopulate();
+
+    void scheduleImport_data();
+    //! Импорт расписания из CSV в рабочем потоке с добавлением элементов пачками.
+    void scheduleImport();
+
+    void itemQueries_data();
+    //! Поиск элементов по значениям шкал при разных способах индексирования.
+    void itemQueries();
+
+    void taskTableQueries_data();
+    //! Поиск задач плоской таблицы по значениям шкалы и диапазону секций.
+    void taskTableQueries();
+
+    void scaleEngineUpdate_data();
+    //! Расчет засечек и подписей временной шкалы для разных диапазонов.
+    void scaleEngineUpdate();
+};
+
+#endif // PLOTBENCHMARK_H
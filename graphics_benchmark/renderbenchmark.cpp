@@ -0,0 +1,206 @@
+#include <QtTest>
+#include <QImage>
+#include <QElapsedTimer>
+#include <algorithm>
+
+#include <datetimescale.h>
+#include <datetimescaleplotitem.h>
+#include <standardplotscene.h>
+#include <standardplotview.h>
+#include <plotstatistics.h>
+
+#include "renderbenchmark.h"
+#include "schedulegenerator.h"
+#include "benchmarkitem.h"
+
+using namespace Graphics;
+
+
+namespace {
+
+//! Количество кадров сценария прокрутки и переходов.
+const int script_frames_count = 100;
+//! Количество шагов масштабирования в одну сторону.
+const int zoom_steps_count = 20;
+//! Размер области просмотра.
+const QSize viewport_size(1300, 600);
+
+//! Выполнение шага \c frame сценария \c script для виджета \c view.
+void performStep(StandardPlotView *view, RenderBenchmark::Script script, int frame,
+                 ScheduleGenerator *generator)
+{
+    AbstractPlotScene *scene = view->plotScene();
+
+    switch (script) {
+    case RenderBenchmark::ScrollScript:
+        view->scrollPlot(-1);
+        break;
+    case RenderBenchmark::ZoomRelayoutScript:
+    case RenderBenchmark::ZoomTransformScript:
+    case RenderBenchmark::ZoomDeferredScript:
+        // как при прокрутке колеса с клавишей-модификатором
+        if ((frame % (2 * zoom_steps_count)) < zoom_steps_count)
+            view->zoomIn();
+        else
+            view->zoomOut();
+
+        if (scene->zoomMode() == AbstractPlotScene::ZoomRelayout)
+            scene->refresh();
+
+        // применение геометрии, рассчитанной фоновым пересчетом к этому кадру
+        if (scene->zoomMode() == AbstractPlotScene::ZoomDeferred)
+            QCoreApplication::processEvents();
+        break;
+    case RenderBenchmark::JumpScript:
+        view->scrollTo(QPointF(generator->randomValue(), generator->randomSection()));
+        break;
+    }
+}
+
+} // namespace
+
+
+
+RenderBenchmark::RenderBenchmark(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void RenderBenchmark::reportSamples(const char *name, QVector<qint64> samples, const char *unit)
+{
+    if (samples.isEmpty())
+        return;
+
+    std::sort(samples.begin(), samples.end());
+
+    qint64 sum = 0;
+    foreach (qint64 sample, samples)
+        sum += sample;
+
+    const int p95_index = qMax(0, (samples.size() * 95 + 99) / 100 - 1);
+
+    qDebug("%s: avg %.3f, p95 %lld, max %lld %s", name, double(sum) / samples.size(),
+           samples.at(p95_index), samples.last(), unit);
+}
+
+void RenderBenchmark::frameTimes_data()
+{
+    QTest::addColumn<int>("items_count");
+    QTest::addColumn<int>("sections_count");
+    QTest::addColumn<int>("script");
+
+    const int sections_count = ScheduleGenerator::configuredSectionsCount();
+
+    QList<QPair<QByteArray, int> > scripts;
+    scripts << qMakePair(QByteArray("scroll"), int(ScrollScript))
+            << qMakePair(QByteArray("zoom relayout"), int(ZoomRelayoutScript))
+            << qMakePair(QByteArray("zoom transform"), int(ZoomTransformScript))
+            << qMakePair(QByteArray("zoom deferred"), int(ZoomDeferredScript))
+            << qMakePair(QByteArray("jump"), int(JumpScript));
+
+    foreach (int items_count, ScheduleGenerator::configuredItemsCounts()) {
+        for (int i = 0; i < scripts.size(); ++ i) {
+            const QByteArray name = QByteArray::number(items_count) + " items/" +
+                                    QByteArray::number(sections_count) + " sections/" +
+                                    scripts.at(i).first;
+            QTest::newRow(name.constData()) << items_count << sections_count << scripts.at(i).second;
+        }
+    }
+}
+
+void RenderBenchmark::frameTimes()
+{
+    QFETCH(int, items_count);
+    QFETCH(int, sections_count);
+    QFETCH(int, script);
+
+    ScheduleGenerator generator(items_count, sections_count);
+
+    StandardPlotScene *scene = generator.createScene(true);
+    if (script == ZoomTransformScript)
+        scene->setZoomMode(AbstractPlotScene::ZoomTransform);
+    if (script == ZoomDeferredScript)
+        scene->setZoomMode(AbstractPlotScene::ZoomDeferred);
+
+    DateTimeScale *x_scale = static_cast<DateTimeScale *>(scene->xScale());
+
+    DateTimeScalePlotItem *scale_item = new DateTimeScalePlotItem(x_scale);
+    scale_item->setBeginCoordinates(x_scale->minimum(), 0);
+    scale_item->setEndCoordinates(x_scale->maximum(), 0);
+    scale_item->setWidthCalculated(true);
+    scale_item->setHeightCalculated(true);
+    scene->addPlotItem(scale_item);
+
+    foreach (AbstractPlotItem *item, generator.createItems())
+        scene->addPlotItem(item);
+
+    scene->refresh();
+
+    StandardPlotView view;
+    view.setPlotScene(scene);
+    view.setZoomEnabled(true);
+    view.resize(viewport_size);
+    view.show();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+#else
+    QVERIFY(QTest::qWaitForWindowShown(&view));
+#endif
+
+    QImage image(view.viewport()->size(), QImage::Format_ARGB32_Premultiplied);
+
+    const int frames_count = (script == ZoomRelayoutScript || script == ZoomTransformScript ||
+                              script == ZoomDeferredScript)
+                             ? 2 * zoom_steps_count
+                             : script_frames_count;
+
+    QVector<qint64> layout_times;
+    QVector<qint64> paint_times;
+    QVector<qint64> frame_times;
+    QVector<qint64> painted_counts;
+
+    QElapsedTimer timer;
+
+    scene->resetStatistics();
+
+    for (int frame = 0; frame < frames_count; ++ frame) {
+        timer.start();
+        performStep(&view, RenderBenchmark::Script(script), frame, &generator);
+        const qint64 layout_time = timer.nsecsElapsed() / 1000;
+
+        BenchmarkItem::paintedCount() = 0;
+
+        timer.start();
+        view.viewport()->render(&image);
+        const qint64 paint_time = timer.nsecsElapsed() / 1000;
+
+        layout_times.append(layout_time);
+        paint_times.append(paint_time);
+        frame_times.append(layout_time + paint_time);
+        painted_counts.append(BenchmarkItem::paintedCount());
+    }
+
+    reportSamples("layout", layout_times, "us");
+    reportSamples("paint", paint_times, "us");
+    reportSamples("frame", frame_times, "us");
+    reportSamples("items painted", painted_counts, "items");
+
+    // счетчики библиотеки, собранной с CONFIG+=graphics_statistics
+    if (PlotStatistics::isEnabled()) {
+        const PlotStatistics &statistics = scene->statistics();
+        qDebug("layout refreshes: %lld, items laid out: %lld, scale engine updates: %lld, ticks: %lld",
+               statistics.counter(PlotStatistics::LayoutRefreshes),
+               statistics.counter(PlotStatistics::ItemsLaidOut),
+               statistics.counter(PlotStatistics::ScaleEngineUpdates),
+               statistics.counter(PlotStatistics::TicksGenerated));
+    }
+
+    qint64 total_time = 0;
+    foreach (qint64 frame_time, frame_times)
+        total_time += frame_time;
+
+    QTest::setBenchmarkResult(double(total_time) / frames_count / 1000.0, QTest::WalltimeMilliseconds);
+
+    view.setScene(0);
+    delete scene;
+}
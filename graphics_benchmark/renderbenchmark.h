@@ -0,0 +1,43 @@
+#ifndef RENDERBENCHMARK_H
+#define RENDERBENCHMARK_H
+
+#include <QObject>
+#include <QVector>
+
+/*!
+ * \brief Измерение времени кадра виджета графика при отрисовке в изображение.
+ *
+ * Виджет с бесконечной сценой проходит сценарий прокрутки или масштабирования;
+ * после каждого шага область просмотра отрисовывается в QImage. Для каждого кадра
+ * учитываются время обновления расположения, время отрисовки и количество
+ * отрисованных элементов; по сценарию выводятся среднее, 95-й перцентиль и максимум.
+ */
+class RenderBenchmark : public QObject {
+    Q_OBJECT
+public:
+    //! Сценарий шагов виджета.
+    enum Script {
+        //! Прокрутка колесом вперед.
+        ScrollScript,
+        //! Увеличение и уменьшение масштаба со сменой расположения.
+        ZoomRelayoutScript,
+        //! Увеличение и уменьшение масштаба преобразованием.
+        ZoomTransformScript,
+        //! Увеличение и уменьшение масштаба с пересчетом расположения в фоновом потоке.
+        ZoomDeferredScript,
+        //! Переходы к случайным значениям шкалы.
+        JumpScript
+    };
+
+    //! Конструктор с установкой родительского объекта \c parent.
+    explicit RenderBenchmark(QObject *parent = 0);
+private:
+    //! Вывод статистики \c samples с названием \c name и единицами \c unit.
+    void reportSamples(const char *name, QVector<qint64> samples, const char *unit);
+private slots:
+    void frameTimes_data();
+    //! Время кадров при прохождении сценария.
+    void frameTimes();
+};
+
+#endif // RENDERBENCHMARK_H
@@ -0,0 +1,136 @@
+#include <QDateTime>
+
+#include <converter.h>
+#include <datetimescale.h>
+#include <sectionscale.h>
+#include <standardplotlayout.h>
+#include <standardplotscene.h>
+#include <infiniteplotscene.h>
+#include <timelinefile.h>
+
+#include "schedulegenerator.h"
+#include "benchmarkitem.h"
+
+using namespace Graphics;
+
+
+ScheduleGenerator::ScheduleGenerator(int items_count, int sections_count, quint32 seed) :
+    items_count(items_count),
+    sections_count(qMax(1, sections_count)),
+    seed(seed),
+    state(seed),
+    begin_value(Converter::toScale(QDateTime(QDate(2014, 9, 30), QTime(0, 0, 0)))),
+    end_value(Converter::toScale(QDateTime(QDate(2014, 10, 30), QTime(0, 0, 0))))
+{
+}
+
+QList<AbstractPlotItem *> ScheduleGenerator::createItems() const
+{
+    const QVector<TimelineRecord> records = createRecords();
+
+    QList<AbstractPlotItem *> items;
+    items.reserve(records.size());
+
+    foreach (const TimelineRecord &record, records) {
+        BenchmarkItem *item = new BenchmarkItem();
+        item->setBeginCoordinates(record.begin_value, record.section);
+        item->setEndCoordinates(record.end_value, record.section);
+        item->setWidthCalculated(true);
+        item->setHeightCalculated(true);
+
+        items.append(item);
+    }
+
+    return items;
+}
+
+QVector<TimelineRecord> ScheduleGenerator::createRecords() const
+{
+    ScheduleGenerator generator(items_count, sections_count, seed);
+
+    QVector<TimelineRecord> records;
+    records.reserve(items_count);
+
+    for (int i = 0; i < items_count; ++ i) {
+        TimelineRecord record;
+        record.section = quint32(generator.randomSection());
+        record.begin_value = generator.randomValue();
+        // от 5 минут до 8 часов
+        record.end_value = record.begin_value + 300.0 + double(generator.next() % 28500);
+        record.id = quint64(i);
+
+        records.append(record);
+    }
+
+    return records;
+}
+
+double ScheduleGenerator::randomValue()
+{
+    return begin_value + (end_value - begin_value) * (double(next()) / 4294967296.0);
+}
+
+int ScheduleGenerator::randomSection()
+{
+    return int(next() % quint32(sections_count));
+}
+
+StandardPlotScene *ScheduleGenerator::createScene(bool infinite) const
+{
+    StandardPlotScene *scene = infinite ? new InfinitePlotScene() : new StandardPlotScene(0);
+    setupScene(scene, infinite);
+
+    return scene;
+}
+
+void ScheduleGenerator::setupScene(StandardPlotScene *scene, bool infinite) const
+{
+    DateTimeScale *x_scale = new DateTimeScale();
+    x_scale->setOrientation(Qt::Horizontal);
+    x_scale->setLength(4000);
+    x_scale->setRange(begin_value, begin_value + 2 * 86400.0);
+
+    SectionScale *y_scale = new SectionScale();
+    y_scale->setOrientation(Qt::Vertical);
+    y_scale->setLength(sections_count * 20);
+    y_scale->setSectionsCount(sections_count);
+
+    scene->setXScale(x_scale);
+    scene->setYScale(y_scale);
+    scene->setLayout(new StandardPlotLayout());
+    scene->setZoomExtent(infinite ? 3600.0 : 100.0);
+    scene->setMinimumZoomStep(-100);
+    scene->setMaximumZoomStep(100);
+}
+
+QList<int> ScheduleGenerator::configuredItemsCounts()
+{
+    QList<int> counts;
+
+    const QByteArray env = qgetenv("GRAPHICS_BENCHMARK_ITEMS");
+    foreach (const QByteArray &value, env.split(',')) {
+        bool ok = false;
+        const int count = value.trimmed().toInt(&ok);
+        if (ok && (count > 0))
+            counts.append(count);
+    }
+
+    if (counts.isEmpty())
+        counts << 1000 << 10000 << 100000;
+
+    return counts;
+}
+
+int ScheduleGenerator::configuredSectionsCount()
+{
+    bool ok = false;
+    const int count = qgetenv("GRAPHICS_BENCHMARK_SECTIONS").toInt(&ok);
+    return (ok && (count > 0)) ? count : 50;
+}
+
+quint32 ScheduleGenerator::next()
+{
+    // линейный конгруэнтный генератор: одинаковое расписание на всех платформах
+    state = state * 1664525u + 1013904223u;
+    return state;
+}
@@ -0,0 +1,68 @@
+#ifndef SCHEDULEGENERATOR_H
+#define SCHEDULEGENERATOR_H
+
+#include <QList>
+#include <QVector>
+#include <commonprerequisites.h>
+
+/*!
+ * \brief Генератор синтетического расписания задач для измерений.
+ *
+ * Размеры расписания задаются переменными окружения GRAPHICS_BENCHMARK_ITEMS
+ * (список количеств задач через запятую, по умолчанию 1000,10000,100000) и
+ * GRAPHICS_BENCHMARK_SECTIONS (количество секций, по умолчанию 50).
+ */
+class ScheduleGenerator {
+public:
+    //! Конструктор расписания из \c items_count задач в \c sections_count секциях со стартовым значением \c seed.
+    ScheduleGenerator(int items_count, int sections_count, quint32 seed = 1);
+
+    //! Количество задач.
+    int itemsCount() const { return items_count; }
+    //! Количество секций.
+    int sectionsCount() const { return sections_count; }
+
+    //! Значение шкалы начала расписания.
+    double beginValue() const { return begin_value; }
+    //! Значение шкалы конца расписания.
+    double endValue() const { return end_value; }
+
+    //! Создание элементов графика для всех задач расписания.
+    QList<Graphics::AbstractPlotItem *> createItems() const;
+    //! Создание записей файла расписания для всех задач расписания.
+    QVector<Graphics::TimelineRecord> createRecords() const;
+
+    //! Псевдослучайное значение шкалы внутри расписания.
+    double randomValue();
+    //! Псевдослучайная секция расписания.
+    int randomSection();
+
+    //! Создание сцены с временной шкалой расписания и шкалой секций.
+    Graphics::StandardPlotScene *createScene(bool infinite) const;
+    //! Установка в сцену \c scene шкал расписания и позиционирования (\c infinite - шаг масштабирования бесконечной сцены).
+    void setupScene(Graphics::StandardPlotScene *scene, bool infinite) const;
+
+    //! Количества задач из переменной окружения GRAPHICS_BENCHMARK_ITEMS.
+    static QList<int> configuredItemsCounts();
+    //! Количество секций из переменной окружения GRAPHICS_BENCHMARK_SECTIONS.
+    static int configuredSectionsCount();
+private:
+    //! Следующее псевдослучайное число.
+    quint32 next();
+
+    //! Количество задач.
+    int items_count;
+    //! Количество секций.
+    int sections_count;
+    //! Стартовое значение генератора.
+    quint32 seed;
+    //! Текущее состояние генератора.
+    quint32 state;
+
+    //! Значение шкалы начала расписания.
+    double begin_value;
+    //! Значение шкалы конца расписания.
+    double end_value;
+};
+
+#endif // SCHEDULEGENERATOR_H
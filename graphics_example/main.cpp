@@ -4,7 +4,7 @@
 #include <numericscale.h>
 #include <sectionscale.h>
 #include <datetimescale.h>
-#include <standardplotlayout.h>
+#include <packedplotlayout.h>
 #include <standardplotscene.h>
 #include <infiniteplotscene.h>
 #include <converter.h>
@@ -36,7 +36,7 @@ int main(int argc, char *argv[])
     y_scale->setLength(500);
     y_scale->setSectionsCount(5);
 
-    StandardPlotLayout *layout = new StandardPlotLayout();
+    PackedPlotLayout *layout = new PackedPlotLayout();
 
     InfinitePlotScene *scene = new InfinitePlotScene(view);
     scene->setXScale(x_scale);
@@ -109,6 +109,7 @@ int main(int argc, char *argv[])
 
     view->setPlotScene(scene);
     view->setZoomEnabled(true);
+    view->setKineticScrollEnabled(true);
 
     view->resize(1300, 600);
     view->show();
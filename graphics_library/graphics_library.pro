@@ -1,6 +1,6 @@
 QT = core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
 
 TEMPLATE = lib
 TARGET = graphics
@@ -12,16 +12,21 @@ DLLDESTDIR = DESTDIR
 
 DEFINES += GRAPHICS_LIBRARY
 
+# сбор статистики работы графика: qmake CONFIG+=graphics_statistics
+graphics_statistics: DEFINES += GRAPHICS_STATISTICS
+
 INCLUDEPATH += \
     source
 
 HEADERS += \
     source/include/abstractplotitem.h \
+    source/include/abstractplotitemfactory.h \
     source/include/abstractplotlayout.h \
     source/include/abstractplotscene.h \
     source/include/abstractplotview.h \
     source/include/abstractscaleengine.h \
     source/include/abstractscale.h \
+    source/include/civiltime.h \
     source/include/commonprerequisites.h \
     source/include/datetimescaleengine.h \
     source/include/datetimescale.h \
@@ -29,26 +34,51 @@ HEADERS += \
     source/include/infiniteplotscene.h \
     source/include/interactiveplotitem.h \
     source/include/numericscale.h \
+    source/include/packedplotlayout.h \
+    source/include/plotitemgeometry.h \
+    source/include/plotitemindex.h \
+    source/include/plotitemupdatequeue.h \
+    source/include/plotselectionmodel.h \
+    source/include/plotstatistics.h \
+    source/include/scalemapper.h \
+    source/include/scheduleimporter.h \
     source/include/sectionscale.h \
     source/include/standardplotitem.h \
     source/include/standardplotlayout.h \
+    source/include/standardplotlayoutt.h \
     source/include/standardplotscene.h \
     source/include/standardplotview.h \
+    source/include/tasktable.h \
+    source/include/tasktableitem.h \
+    source/include/timelinefile.h \
+    source/include/timelineplotscene.h \
     source/include/converter.h
 
 SOURCES += \
     source/abstractplotitem.cpp \
     source/abstractplotscene.cpp \
     source/abstractplotview.cpp \
+    source/civiltime.cpp \
     source/datetimescale.cpp \
     source/datetimescaleengine.cpp \
     source/datetimescaleplotitem.cpp \
     source/infiniteplotscene.cpp \
     source/interactiveplotitem.cpp \
     source/numericscale.cpp \
+    source/packedplotlayout.cpp \
+    source/plotitemgeometry.cpp \
+    source/plotitemindex.cpp \
+    source/plotitemupdatequeue.cpp \
+    source/plotselectionmodel.cpp \
+    source/plotstatistics.cpp \
+    source/scheduleimporter.cpp \
     source/sectionscale.cpp \
     source/standardplotitem.cpp \
     source/standardplotlayout.cpp \
     source/standardplotscene.cpp \
     source/standardplotview.cpp \
+    source/tasktable.cpp \
+    source/tasktableitem.cpp \
+    source/timelinefile.cpp \
+    source/timelineplotscene.cpp \
     source/converter.cpp
@@ -1,15 +1,47 @@
 #include "include/abstractplotscene.h"
+#include "include/plotstatistics.h"
 
 
 namespace Graphics {
 
 AbstractPlotScene::AbstractPlotScene(QObject *parent) :
-    QGraphicsScene(parent)
+    QGraphicsScene(parent),
+    default_statistics(0)
 {
 }
 
 AbstractPlotScene::~AbstractPlotScene()
 {
+    delete default_statistics;
+}
+
+AbstractPlotScene::ZoomMode AbstractPlotScene::zoomMode() const
+{
+    return ZoomRelayout;
+}
+
+void AbstractPlotScene::setZoomMode(AbstractPlotScene::ZoomMode mode)
+{
+    Q_UNUSED(mode);
+}
+
+QTransform AbstractPlotScene::zoomTransform() const
+{
+    return QTransform();
+}
+
+void AbstractPlotScene::addPlotItems(const QList<AbstractPlotItem *> &items)
+{
+    foreach (AbstractPlotItem *item, items) {
+        addPlotItem(item);
+        refresh(item);
+    }
+}
+
+void AbstractPlotScene::removePlotItems(const QList<AbstractPlotItem *> &items)
+{
+    foreach (AbstractPlotItem *item, items)
+        removePlotItem(item);
 }
 
 void AbstractPlotScene::visualize(const QRectF &visible_scene_rect)
@@ -33,6 +65,47 @@ void AbstractPlotScene::scrollTo(const QRectF &visible_scene_rect, const QPointF
     Q_UNUSED(scale_values);
 }
 
+void AbstractPlotScene::predictScroll(const QRectF &visible_scene_rect, const QPointF &velocity)
+{
+    Q_UNUSED(visible_scene_rect);
+    Q_UNUSED(velocity);
+}
+
+const PlotStatistics &AbstractPlotScene::statistics() const
+{
+    if (default_statistics == 0)
+        default_statistics = new PlotStatistics();
+    return *default_statistics;
+}
+
+PlotStatistics &AbstractPlotScene::statistics()
+{
+    if (default_statistics == 0)
+        default_statistics = new PlotStatistics();
+    return *default_statistics;
+}
+
+void AbstractPlotScene::resetStatistics()
+{
+    if (default_statistics != 0)
+        default_statistics->reset();
+}
+
+bool AbstractPlotScene::isHoverResolved() const
+{
+    return false;
+}
+
+PlotSelectionModel *AbstractPlotScene::selectionModel() const
+{
+    return 0;
+}
+
+bool AbstractPlotScene::isValueMoveEnabled() const
+{
+    return false;
+}
+
 void AbstractPlotScene::plotItemHoverEnter(AbstractPlotItem *item, const QPointF &scene_pos)
 {
     Q_UNUSED(item);
@@ -85,4 +158,14 @@ void AbstractPlotScene::plotItemContextMenu(AbstractPlotItem *item, const QPoint
     Q_UNUSED(scene_pos);
 }
 
+void AbstractPlotScene::plotItemsMoved(const QList<AbstractPlotItem *> &items)
+{
+    Q_UNUSED(items);
+}
+
+void AbstractPlotScene::plotItemCoordinatesChanged(AbstractPlotItem *item)
+{
+    Q_UNUSED(item);
+}
+
 } // namespace Graphics
@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <QDateTime>
+#include <QLocale>
+
+#include "include/civiltime.h"
+
+
+namespace Graphics {
+
+namespace {
+
+//! Смещение системного местного времени от UTC в микросекундах в момент UTC \c utc_msecs.
+qint64 localOffset(qint64 utc_msecs, const void *context)
+{
+    Q_UNUSED(context);
+
+    const QDateTime local_datetime = QDateTime::fromMSecsSinceEpoch(utc_msecs);
+    const QDateTime utc_datetime = QDateTime(local_datetime.date(), local_datetime.time(), Qt::UTC);
+
+    return qint64(local_datetime.secsTo(utc_datetime)) * CivilTime::usecs_per_second;
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+//! Смещение часового пояса \c context (QTimeZone) от UTC в микросекундах в момент UTC \c utc_msecs.
+qint64 timeZoneOffset(qint64 utc_msecs, const void *context)
+{
+    const QTimeZone *time_zone = static_cast<const QTimeZone *>(context);
+
+    return qint64(time_zone->offsetFromUtc(QDateTime::fromMSecsSinceEpoch(utc_msecs, Qt::UTC))) *
+           CivilTime::usecs_per_second;
+}
+#endif
+
+//! Дописывание к \c result числа \c value с дополнением нулями до \c width знаков.
+void appendNumber(QString *result, qint64 value, int width)
+{
+    result->append(QString("%1").arg(value, width, 10, QChar('0')));
+}
+
+} // namespace
+
+
+const qint64 CivilTime::usecs_per_second;
+const qint64 CivilTime::usecs_per_day;
+
+qint64 CivilTime::floorDiv(qint64 value, qint64 divisor)
+{
+    const qint64 quotient = value / divisor;
+    return ((value % divisor) < 0) ? (quotient - 1) : quotient;
+}
+
+qint64 CivilTime::floorMod(qint64 value, qint64 divisor)
+{
+    return value - floorDiv(value, divisor) * divisor;
+}
+
+qint64 CivilTime::daysFromCivil(int year, int month, int day)
+{
+    // пролептический григорианский календарь, годы считаются от марта
+    const qint64 y = qint64(year) - ((month <= 2) ? 1 : 0);
+    const qint64 era = floorDiv(y, 400);
+    const qint64 year_of_era = y - era * 400;
+    const qint64 day_of_year = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;
+    const qint64 day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+
+    return era * 146097 + day_of_era - 719468;
+}
+
+void CivilTime::civilFromDays(qint64 days, int *year, int *month, int *day)
+{
+    const qint64 z = days + 719468;
+    const qint64 era = floorDiv(z, 146097);
+    const qint64 day_of_era = z - era * 146097;
+    const qint64 year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const qint64 day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const qint64 mp = (5 * day_of_year + 2) / 153;
+
+    const int d = int(day_of_year - (153 * mp + 2) / 5 + 1);
+    const int m = int((mp < 10) ? (mp + 3) : (mp - 9));
+
+    *year = int(year_of_era + era * 400 + ((m <= 2) ? 1 : 0));
+    *month = m;
+    *day = d;
+}
+
+bool CivilTime::isLeapYear(int year)
+{
+    return ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+}
+
+int CivilTime::daysInMonth(int year, int month)
+{
+    static const int days_in_month[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    if ((month == 2) && isLeapYear(year))
+        return 29;
+
+    return days_in_month[month - 1];
+}
+
+CivilTime::Fields CivilTime::fields(qint64 usecs)
+{
+    const qint64 days = floorDiv(usecs, usecs_per_day);
+    const qint64 usecs_of_day = usecs - days * usecs_per_day;
+    const qint64 seconds_of_day = usecs_of_day / usecs_per_second;
+
+    Fields result;
+    civilFromDays(days, &result.year, &result.month, &result.day);
+
+    result.hour = int(seconds_of_day / 3600);
+    result.minute = int((seconds_of_day / 60) % 60);
+    result.second = int(seconds_of_day % 60);
+    result.usec = int(usecs_of_day % usecs_per_second);
+
+    return result;
+}
+
+qint64 CivilTime::usecs(const CivilTime::Fields &fields)
+{
+    const qint64 seconds_of_day = qint64(fields.hour) * 3600 + qint64(fields.minute) * 60 + fields.second;
+
+    return daysFromCivil(fields.year, fields.month, fields.day) * usecs_per_day +
+           seconds_of_day * usecs_per_second + fields.usec;
+}
+
+qint64 CivilTime::startOfDay(qint64 usecs)
+{
+    return floorDiv(usecs, usecs_per_day) * usecs_per_day;
+}
+
+qint64 CivilTime::addMonths(qint64 usecs, int months)
+{
+    Fields result = fields(usecs);
+
+    const qint64 month_index = qint64(result.year) * 12 + (result.month - 1) + months;
+
+    result.year = int(floorDiv(month_index, 12));
+    result.month = int(floorMod(month_index, 12)) + 1;
+    result.day = qMin(result.day, daysInMonth(result.year, result.month));
+
+    return CivilTime::usecs(result);
+}
+
+qint64 CivilTime::addYears(qint64 usecs, int years)
+{
+    return addMonths(usecs, years * 12);
+}
+
+QString CivilTime::toString(qint64 usecs, const QString &format)
+{
+    const Fields date_fields = fields(usecs);
+
+    QString result;
+    result.reserve(format.size() + 8);
+
+    for (int i = 0; i < format.size(); /* empty */) {
+        const QChar symbol = format.at(i);
+
+        int count = 1;
+        while (((i + count) < format.size()) && (format.at(i + count) == symbol))
+            ++ count;
+
+        switch (symbol.toLatin1()) {
+            case 'd':
+                appendNumber(&result, date_fields.day, qMin(count, 2));
+                break;
+            case 'M':
+                if (count >= 3) {
+                    result.append(QLocale::system().monthName(date_fields.month,
+                                                              (count == 3) ? QLocale::ShortFormat
+                                                                           : QLocale::LongFormat));
+                }
+                else {
+                    appendNumber(&result, date_fields.month, count);
+                }
+                break;
+            case 'y':
+                if (count >= 4)
+                    appendNumber(&result, date_fields.year, 4);
+                else
+                    appendNumber(&result, floorMod(date_fields.year, 100), 2);
+                break;
+            case 'h':
+                appendNumber(&result, date_fields.hour, qMin(count, 2));
+                break;
+            case 'm':
+                appendNumber(&result, date_fields.minute, qMin(count, 2));
+                break;
+            case 's':
+                appendNumber(&result, date_fields.second, qMin(count, 2));
+                break;
+            case 'z':
+                appendNumber(&result, date_fields.usec / 1000, (count >= 3) ? 3 : 1);
+                break;
+            default:
+                result.append(format.mid(i, count));
+                break;
+        }
+
+        i += count;
+    }
+
+    return result;
+}
+
+
+
+UtcOffsetTable::UtcOffsetTable() :
+    range_begin(0),
+    range_end(0)
+{
+}
+
+bool UtcOffsetTable::isValid() const
+{
+    return !transitions.isEmpty();
+}
+
+bool UtcOffsetTable::covers(qint64 begin_usecs, qint64 end_usecs) const
+{
+    return isValid() && (begin_usecs >= range_begin) && (end_usecs <= range_end);
+}
+
+void UtcOffsetTable::buildLocal(qint64 begin_usecs, qint64 end_usecs)
+{
+    build(begin_usecs, end_usecs, &localOffset, 0);
+}
+
+void UtcOffsetTable::extendLocal(qint64 begin_usecs, qint64 end_usecs)
+{
+    extend(begin_usecs, end_usecs, &localOffset, 0);
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+void UtcOffsetTable::buildTimeZone(const QTimeZone &time_zone, qint64 begin_usecs, qint64 end_usecs)
+{
+    if (!time_zone.isValid() || !time_zone.hasTransitions()) {
+        build(begin_usecs, end_usecs, &timeZoneOffset, &time_zone);
+        return;
+    }
+
+    clear();
+
+    if (end_usecs < begin_usecs)
+        std::swap(begin_usecs, end_usecs);
+
+    range_begin = begin_usecs;
+    range_end = end_usecs;
+
+    // база часовых поясов знает моменты переходов точно, выборка не нужна
+    const qint64 begin_msecs = CivilTime::floorDiv(begin_usecs, 1000);
+    const qint64 end_msecs = CivilTime::floorDiv(end_usecs, 1000);
+
+    append(begin_msecs * 1000, timeZoneOffset(begin_msecs, &time_zone));
+
+    const QTimeZone::OffsetDataList zone_transitions =
+            time_zone.transitions(QDateTime::fromMSecsSinceEpoch(begin_msecs + 1, Qt::UTC),
+                                  QDateTime::fromMSecsSinceEpoch(end_msecs, Qt::UTC));
+
+    foreach (const QTimeZone::OffsetData &zone_transition, zone_transitions) {
+        const qint64 offset_usecs = qint64(zone_transition.offsetFromUtc) * CivilTime::usecs_per_second;
+        if (offset_usecs != transitions.last().offset_usecs)
+            append(zone_transition.atUtc.toMSecsSinceEpoch() * 1000, offset_usecs);
+    }
+}
+#endif
+
+void UtcOffsetTable::clear()
+{
+    transitions.clear();
+    range_begin = 0;
+    range_end = 0;
+}
+
+qint64 UtcOffsetTable::offset(qint64 utc_usecs) const
+{
+    if (transitions.isEmpty())
+        return 0;
+
+    // последний переход, не позже utc_usecs; до первого перехода действует его смещение
+    int low = 0;
+    int high = transitions.size() - 1;
+
+    while (low < high) {
+        const int middle = (low + high + 1) / 2;
+
+        if (transitions.at(middle).utc_usecs <= utc_usecs)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    return transitions.at(low).offset_usecs;
+}
+
+qint64 UtcOffsetTable::toLocal(qint64 utc_usecs) const
+{
+    return utc_usecs + offset(utc_usecs);
+}
+
+qint64 UtcOffsetTable::toUtc(qint64 local_usecs) const
+{
+    // смещение до перехода дает более ранний из двух возможных моментов
+    const qint64 guess_usecs = local_usecs - offset(local_usecs);
+    const qint64 early_usecs = local_usecs - offset(guess_usecs - CivilTime::usecs_per_day);
+
+    if (toLocal(early_usecs) == local_usecs)
+        return early_usecs;
+
+    return local_usecs - offset(guess_usecs);
+}
+
+void UtcOffsetTable::build(qint64 begin_usecs, qint64 end_usecs,
+                           qint64 (*offset_function)(qint64, const void *), const void *context)
+{
+    clear();
+
+    if (end_usecs < begin_usecs)
+        std::swap(begin_usecs, end_usecs);
+
+    range_begin = begin_usecs;
+    range_end = end_usecs;
+
+    scan(begin_usecs, end_usecs, offset_function, context, &transitions);
+}
+
+void UtcOffsetTable::extend(qint64 begin_usecs, qint64 end_usecs,
+                            qint64 (*offset_function)(qint64, const void *), const void *context)
+{
+    if (!isValid()) {
+        build(begin_usecs, end_usecs, offset_function, context);
+        return;
+    }
+
+    if (end_usecs < begin_usecs)
+        std::swap(begin_usecs, end_usecs);
+
+    // первый переход таблицы лишь фиксирует смещение в начале интервала,
+    // поэтому заменяется переходами расширения, заканчивающимися тем же смещением
+    if (begin_usecs < range_begin) {
+        QVector<Transition> head_transitions;
+        scan(begin_usecs, range_begin, offset_function, context, &head_transitions);
+
+        head_transitions.reserve(head_transitions.size() + transitions.size() - 1);
+        for (int i = 1; i < transitions.size(); ++ i)
+            head_transitions.append(transitions.at(i));
+
+        transitions = head_transitions;
+        range_begin = begin_usecs;
+    }
+
+    // первый переход расширения повторяет действующее в конце интервала смещение
+    if (end_usecs > range_end) {
+        QVector<Transition> tail_transitions;
+        scan(range_end, end_usecs, offset_function, context, &tail_transitions);
+
+        const int first = (tail_transitions.first().offset_usecs == transitions.last().offset_usecs) ? 1 : 0;
+        for (int i = first; i < tail_transitions.size(); ++ i)
+            transitions.append(tail_transitions.at(i));
+
+        range_end = end_usecs;
+    }
+}
+
+void UtcOffsetTable::scan(qint64 begin_usecs, qint64 end_usecs,
+                          qint64 (*offset_function)(qint64, const void *), const void *context,
+                          QVector<Transition> *result)
+{
+    // переходы на летнее время разделены месяцами, поэтому смещение проверяется раз в сутки,
+    // а момент перехода уточняется делением отрезка пополам до секунды
+    const qint64 sample_step = CivilTime::usecs_per_day;
+
+    qint64 prev_sample = CivilTime::floorDiv(begin_usecs, 1000) * 1000;
+    qint64 prev_offset = offset_function(prev_sample / 1000, context);
+
+    Transition transition;
+    transition.utc_usecs = prev_sample;
+    transition.offset_usecs = prev_offset;
+    result->append(transition);
+
+    while (prev_sample < end_usecs) {
+        const qint64 sample = qMin(prev_sample + sample_step, end_usecs + 1000);
+        const qint64 sample_offset = offset_function(CivilTime::floorDiv(sample, 1000), context);
+
+        if (sample_offset != prev_offset) {
+            qint64 low = prev_sample;
+            qint64 high = sample;
+
+            while ((high - low) > CivilTime::usecs_per_second) {
+                const qint64 middle = low + (high - low) / 2;
+
+                if (offset_function(CivilTime::floorDiv(middle, 1000), context) == prev_offset)
+                    low = middle;
+                else
+                    high = middle;
+            }
+
+            transition.utc_usecs = CivilTime::floorDiv(high, CivilTime::usecs_per_second) * CivilTime::usecs_per_second;
+            transition.offset_usecs = sample_offset;
+            result->append(transition);
+        }
+
+        prev_sample = sample;
+        prev_offset = sample_offset;
+    }
+}
+
+void UtcOffsetTable::append(qint64 utc_usecs, qint64 offset_usecs)
+{
+    Transition transition;
+    transition.utc_usecs = utc_usecs;
+    transition.offset_usecs = offset_usecs;
+
+    transitions.append(transition);
+}
+
+} // namespace Graphics
@@ -7,12 +7,12 @@ namespace Graphics {
 
 double Converter::toScale(const QDateTime &val)
 {
-    return double(val.toTime_t());
+    return msecsToScale(val.toMSecsSinceEpoch());
 }
 
 QDateTime Converter::fromScale(double val)
 {
-    return QDateTime::fromTime_t(val);
+    return QDateTime::fromMSecsSinceEpoch(scaleToMSecs(val));
 }
 
 } // namespace Graphics
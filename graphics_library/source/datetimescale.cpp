@@ -1,3 +1,4 @@
+#include <typeinfo>
 #include <QDateTime>
 
 #include "include/datetimescale.h"
@@ -43,6 +44,27 @@ void DateTimeScale::setFormat(const QString &format)
     d->format = format;
 }
 
+DateTimeScale *DateTimeScale::clone() const
+{
+    Q_D(const DateTimeScale);
+
+    // копия наследника была бы усечена до DateTimeScale и иначе отображала бы значения
+    if (typeid(*this) != typeid(DateTimeScale))
+        return 0;
+
+    DateTimeScale *scale = new DateTimeScale();
+    scale->setOrientation(orientation());
+    scale->setLength(length());
+    scale->setRange(minimum(), maximum());
+    scale->setPrecision(precision());
+    scale->d_ptr->format = d->format;
+
+    if (isOriginFixed())
+        scale->setOrigin(origin());
+
+    return scale;
+}
+
 QString DateTimeScale::label(double position) const
 {
     Q_D(const DateTimeScale);
@@ -1,11 +1,11 @@
 #include <QString>
 #include <QRectF>
-#include <QDateTime>
 #include <QFontMetrics>
 
 #include "include/datetimescaleengine.h"
 #include "include/abstractscale.h"
 #include "include/converter.h"
+#include "include/civiltime.h"
 
 
 namespace Graphics {
@@ -18,6 +18,18 @@ class DateTimeScaleEnginePrivate {
     enum SplitInterval {
         //! Не задан.
         IntervalNone,
+        //! 1 микросекунда.
+        IntervalMicrosecond_1,
+        //! 10 микросекунд.
+        IntervalMicrosecond_10,
+        //! 100 микросекунд.
+        IntervalMicrosecond_100,
+        //! 1 миллисекунда.
+        IntervalMillisecond_1,
+        //! 10 миллисекунд.
+        IntervalMillisecond_10,
+        //! 100 миллисекунд.
+        IntervalMillisecond_100,
         //! 1 секунда.
         IntervalSecond_1,
         //! 5 секунд.
@@ -59,6 +71,9 @@ class DateTimeScaleEnginePrivate {
     //! Используемая шкала.
     AbstractScale *scale;
 
+    //! Коэффициент растяжения шкалы.
+    double zoom_factor;
+
     //! Позиции засечек.
     QList<double> tick_positions;
     //! Позиции крупных засечек.
@@ -69,19 +84,36 @@ class DateTimeScaleEnginePrivate {
     //! Положение подписей крупных засечек.
     QList<QRectF> major_tick_label_rectangles;
 
+    //! Смещения местного времени на интервале шкалы.
+    mutable UtcOffsetTable offset_table;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    //! Часовой пояс засечек и подписей.
+    QTimeZone time_zone;
+#endif
+
     //! Конструктор.
-    DateTimeScaleEnginePrivate() : scale(0) {}
+    DateTimeScaleEnginePrivate() : scale(0), zoom_factor(1.0) {}
     //! Деструктор.
     ~DateTimeScaleEnginePrivate() {}
 
-    //! Расстояние между датами \c from и \c to.
-    double distance(const QDateTime &from, const QDateTime &to) const;
+    //! Построение таблицы смещений местного времени, покрывающей моменты от \c begin_usecs до \c end_usecs.
+    void updateOffsetTable(qint64 begin_usecs, qint64 end_usecs) const;
+
+    //! Длительность интервала разбиения \c interval в микросекундах (0 для календарных интервалов).
+    static qint64 intervalUSecs(SplitInterval interval);
+
+    //! Расстояние между моментами \c from_usecs и \c to_usecs.
+    double distance(qint64 from_usecs, qint64 to_usecs) const;
+
+    //! Положение момента \c usecs на растянутой шкале.
+    double position(qint64 usecs) const;
 
     //! Определение интервала разбиения шкалы на основе минимального расстояния между засечками \c minimum_tick_distance.
     SplitInterval interval(const double minimum_tick_distance = 5.0) const;
 
-    //! Следующая за \c datetime дата, расчитанная на основе интевала разбиения \c interval и количества шагов между засечками \c tick_step.
-    QDateTime nextDateTime(const QDateTime &datetime, SplitInterval interval, int tick_step = 1) const;
+    //! Следующий за \c usecs момент, расчитанный на основе интевала разбиения \c interval и количества шагов между засечками \c tick_step.
+    qint64 nextTick(qint64 usecs, SplitInterval interval, int tick_step = 1) const;
 
     //! Расстояние между засечками для интервала разбиения шкалы \c interval.
     double tickDistance(SplitInterval interval) const;
@@ -89,160 +121,197 @@ class DateTimeScaleEnginePrivate {
     //! Шаг крупных засечек для интервала разбиения \c interval.
     int majorTickStep(SplitInterval interval) const;
 
-    //! Выравнивание даты \c datetime под интервал \c interval и шаг \c tick_step.
-    QDateTime alignedToInterval(const QDateTime &datetime, SplitInterval interval, int tick_step) const;
+    //! Выравнивание момента \c usecs под интервал \c interval и шаг \c tick_step.
+    qint64 alignedToInterval(qint64 usecs, SplitInterval interval, int tick_step) const;
 
     //! Формат подписи для крупных засечек при использовании интервала разбиения \c interval.
     QString majorTickLabelFormat(SplitInterval interval) const;
     //! Формат дополнительной подписи для крупных засечек при использовании интервала разбиения \c interval.
     QString majorTickSubLabelFormat(SplitInterval interval) const;
 
+    //! Подпись момента \c usecs в формате \c format для интервала разбиения \c interval.
+    QString majorTickLabel(qint64 usecs, const QString &format, SplitInterval interval) const;
+
     /*!
      * \brief Флаг необходимости размещения дополнительной подписи для соседних засечек
-     * \c prev_datetime и \c datetime при использовании интервала разбиения \c interval.
+     * \c prev_usecs и \c usecs при использовании интервала разбиения \c interval.
      */
-    bool needsSubLabel(const QDateTime &prev_datetime, const QDateTime &datetime, SplitInterval interval) const;
+    bool needsSubLabel(qint64 prev_usecs, qint64 usecs, SplitInterval interval) const;
 };
 
-double DateTimeScaleEnginePrivate::distance(const QDateTime &from, const QDateTime &to) const
+void DateTimeScaleEnginePrivate::updateOffsetTable(qint64 begin_usecs, qint64 end_usecs) const
 {
-    if (scale == 0)
-        return 0.0;
-
-    return scale->distance(Converter::toScale(from), Converter::toScale(to));
-}
-
-DateTimeScaleEnginePrivate::SplitInterval DateTimeScaleEnginePrivate::interval(const double minimum_tick_distance) const
-{
-    if (scale == 0)
-        return IntervalNone;
-
-    QDateTime scale_minimum = Converter::fromScale(scale->minimum());
-
-    if (distance(scale_minimum, scale_minimum.addSecs(1)) > minimum_tick_distance)
-        return IntervalSecond_1;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(5)) > minimum_tick_distance)
-        return IntervalSecond_5;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(10)) > minimum_tick_distance)
-        return IntervalSecond_10;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(30)) > minimum_tick_distance)
-        return IntervalSecond_30;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(60)) > minimum_tick_distance)
-        return IntervalMinute_1;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(300)) > minimum_tick_distance)
-        return IntervalMinute_5;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(600)) > minimum_tick_distance)
-        return IntervalMinute_10;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(1800)) > minimum_tick_distance)
-        return IntervalMinute_30;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(3600)) > minimum_tick_distance)
-        return IntervalHour_1;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(7200)) > minimum_tick_distance)
-        return IntervalHour_2;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(10800)) > minimum_tick_distance)
-        return IntervalHour_3;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(14400)) > minimum_tick_distance)
-        return IntervalHour_4;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(21600)) > minimum_tick_distance)
-        return IntervalHour_6;
-
-    if (distance(scale_minimum, scale_minimum.addSecs(43200)) > minimum_tick_distance)
-        return IntervalHour_12;
-
-    if (distance(scale_minimum, scale_minimum.addDays(1)) > minimum_tick_distance)
-        return IntervalDay_1;
-
-    if (distance(scale_minimum, scale_minimum.addMonths(1)) > minimum_tick_distance)
-        return IntervalMonth_1;
+    if (offset_table.covers(begin_usecs, end_usecs))
+        return;
 
-    if (distance(scale_minimum, scale_minimum.addMonths(3)) > minimum_tick_distance)
-        return IntervalMonth_3;
+    // запас в ширину интервала с каждой стороны, чтобы прокрутка не перестраивала таблицу
+    const qint64 margin = qMax(end_usecs - begin_usecs, CivilTime::usecs_per_day);
 
-    if (distance(scale_minimum, scale_minimum.addYears(1)) > minimum_tick_distance)
-        return IntervalYear;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    if (time_zone.isValid()) {
+        offset_table.buildTimeZone(time_zone, begin_usecs - margin, end_usecs + margin);
+        return;
+    }
+#endif
 
-    return IntervalYear;
+    offset_table.buildLocal(begin_usecs - margin, end_usecs + margin);
 }
 
-QDateTime DateTimeScaleEnginePrivate::nextDateTime(const QDateTime &datetime,
-                                                   DateTimeScaleEnginePrivate::SplitInterval interval,
-                                                   int tick_step) const
+qint64 DateTimeScaleEnginePrivate::intervalUSecs(DateTimeScaleEnginePrivate::SplitInterval interval)
 {
-    QDateTime next_datetime = datetime;
+    const qint64 usecs_in_second = Q_INT64_C(1000000);
+
+    qint64 interval_usecs = 0;
 
     switch (interval) {
+        case IntervalMicrosecond_1:
+            interval_usecs = 1;
+            break;
+        case IntervalMicrosecond_10:
+            interval_usecs = 10;
+            break;
+        case IntervalMicrosecond_100:
+            interval_usecs = 100;
+            break;
+        case IntervalMillisecond_1:
+            interval_usecs = 1000;
+            break;
+        case IntervalMillisecond_10:
+            interval_usecs = 10000;
+            break;
+        case IntervalMillisecond_100:
+            interval_usecs = 100000;
+            break;
         case IntervalSecond_1:
-            next_datetime = datetime.addSecs(1 * tick_step);
+            interval_usecs = 1 * usecs_in_second;
             break;
         case IntervalSecond_5:
-            next_datetime = datetime.addSecs(5 * tick_step);
+            interval_usecs = 5 * usecs_in_second;
             break;
         case IntervalSecond_10:
-            next_datetime = datetime.addSecs(10 * tick_step);
+            interval_usecs = 10 * usecs_in_second;
             break;
         case IntervalSecond_30:
-            next_datetime = datetime.addSecs(30 * tick_step);
+            interval_usecs = 30 * usecs_in_second;
             break;
         case IntervalMinute_1:
-            next_datetime = datetime.addSecs(60 * tick_step);
+            interval_usecs = 60 * usecs_in_second;
             break;
         case IntervalMinute_5:
-            next_datetime = datetime.addSecs(300 * tick_step);
+            interval_usecs = 300 * usecs_in_second;
             break;
         case IntervalMinute_10:
-            next_datetime = datetime.addSecs(600 * tick_step);
+            interval_usecs = 600 * usecs_in_second;
             break;
         case IntervalMinute_30:
-            next_datetime = datetime.addSecs(1800 * tick_step);
+            interval_usecs = 1800 * usecs_in_second;
             break;
         case IntervalHour_1:
-            next_datetime = datetime.addSecs(3600 * tick_step);
+            interval_usecs = 3600 * usecs_in_second;
             break;
         case IntervalHour_2:
-            next_datetime = datetime.addSecs(7200 * tick_step);
+            interval_usecs = 7200 * usecs_in_second;
             break;
         case IntervalHour_3:
-            next_datetime = datetime.addSecs(10800 * tick_step);
+            interval_usecs = 10800 * usecs_in_second;
             break;
         case IntervalHour_4:
-            next_datetime = datetime.addSecs(14400 * tick_step);
+            interval_usecs = 14400 * usecs_in_second;
             break;
         case IntervalHour_6:
-            next_datetime = datetime.addSecs(21600 * tick_step);
+            interval_usecs = 21600 * usecs_in_second;
             break;
         case IntervalHour_12:
-            next_datetime = datetime.addSecs(43200 * tick_step);
+            interval_usecs = 43200 * usecs_in_second;
             break;
         case IntervalDay_1:
-            next_datetime = datetime.addDays(1 * tick_step);
+        case IntervalMonth_1:
+        case IntervalMonth_3:
+        case IntervalYear:
+        case IntervalNone:
+        default:
+            break;
+    }
+
+    return interval_usecs;
+}
+
+double DateTimeScaleEnginePrivate::distance(qint64 from_usecs, qint64 to_usecs) const
+{
+    if (scale == 0)
+        return 0.0;
+
+    return scale->distance(Converter::usecsToScale(from_usecs), Converter::usecsToScale(to_usecs)) * zoom_factor;
+}
+
+double DateTimeScaleEnginePrivate::position(qint64 usecs) const
+{
+    if (scale == 0)
+        return 0.0;
+
+    return scale->position(Converter::usecsToScale(usecs)) * zoom_factor;
+}
+
+DateTimeScaleEnginePrivate::SplitInterval DateTimeScaleEnginePrivate::interval(const double minimum_tick_distance) const
+{
+    if (scale == 0)
+        return IntervalNone;
+
+    const qint64 scale_minimum = Converter::scaleToUSecs(scale->minimum());
+
+    for (int i = IntervalMicrosecond_1; i <= IntervalYear; ++ i) {
+        const SplitInterval split_interval = SplitInterval(i);
+
+        if (distance(scale_minimum, nextTick(scale_minimum, split_interval)) > minimum_tick_distance)
+            return split_interval;
+    }
+
+    return IntervalYear;
+}
+
+qint64 DateTimeScaleEnginePrivate::nextTick(qint64 usecs,
+                                            DateTimeScaleEnginePrivate::SplitInterval interval,
+                                            int tick_step) const
+{
+    const qint64 interval_usecs = intervalUSecs(interval);
+    const qint64 usecs_per_hour = Q_INT64_C(3600) * CivilTime::usecs_per_second;
+
+    // шаг учитывается целиком: крупные засечки мелких интервалов (например, 12 часовых)
+    // тоже должны отсчитываться по местным часам
+    if ((interval_usecs > 0) && ((interval_usecs * tick_step) <= usecs_per_hour))
+        return usecs + interval_usecs * tick_step;
+
+    // многочасовые шаги отсчитываются по местным часам, чтобы засечки
+    // оставались на 00:00, 06:00 и т.д. после смены смещения
+    if (interval_usecs > 0) {
+        const qint64 next_usecs = offset_table.toUtc(offset_table.toLocal(usecs) + interval_usecs * tick_step);
+        return (next_usecs > usecs) ? next_usecs
+                                    : (usecs + interval_usecs * tick_step);
+    }
+
+    // календарные интервалы отсчитываются по местному времени
+    const qint64 local_usecs = offset_table.toLocal(usecs);
+    qint64 next_local_usecs = local_usecs;
+
+    switch (interval) {
+        case IntervalDay_1:
+            next_local_usecs = local_usecs + CivilTime::usecs_per_day * tick_step;
             break;
         case IntervalMonth_1:
-            next_datetime = datetime.addMonths(1 * tick_step);
+            next_local_usecs = CivilTime::addMonths(local_usecs, 1 * tick_step);
             break;
         case IntervalMonth_3:
-            next_datetime = datetime.addMonths(3 * tick_step);
+            next_local_usecs = CivilTime::addMonths(local_usecs, 3 * tick_step);
             break;
         case IntervalYear:
-            next_datetime = datetime.addYears(1 * tick_step);
+            next_local_usecs = CivilTime::addYears(local_usecs, 1 * tick_step);
             break;
         case IntervalNone:
         default:
-            break;
+            return usecs;
     }
 
-    return next_datetime;
+    return offset_table.toUtc(next_local_usecs);
 }
 
 double DateTimeScaleEnginePrivate::tickDistance(DateTimeScaleEnginePrivate::SplitInterval interval) const
@@ -250,9 +319,9 @@ double DateTimeScaleEnginePrivate::tickDistance(DateTimeScaleEnginePrivate::Spli
     if (scale == 0)
         return 0.0;
 
-    QDateTime scale_minimum = Converter::fromScale(scale->minimum());
+    const qint64 scale_minimum = Converter::scaleToUSecs(scale->minimum());
 
-    return scale->position(Converter::toScale(nextDateTime(scale_minimum, interval)));
+    return position(nextTick(scale_minimum, interval));
 }
 
 int DateTimeScaleEnginePrivate::majorTickStep(DateTimeScaleEnginePrivate::SplitInterval interval) const
@@ -260,6 +329,14 @@ int DateTimeScaleEnginePrivate::majorTickStep(DateTimeScaleEnginePrivate::SplitI
     int major_tick_step = 0;
 
     switch (interval) {
+        case IntervalMicrosecond_1:
+        case IntervalMicrosecond_10:
+        case IntervalMicrosecond_100:
+        case IntervalMillisecond_1:
+        case IntervalMillisecond_10:
+        case IntervalMillisecond_100:
+            major_tick_step = 10;
+            break;
         case IntervalSecond_1:
             major_tick_step = 10;
             break;
@@ -322,84 +399,72 @@ int DateTimeScaleEnginePrivate::majorTickStep(DateTimeScaleEnginePrivate::SplitI
     return major_tick_step;
 }
 
-QDateTime DateTimeScaleEnginePrivate::alignedToInterval(const QDateTime &datetime,
-                                                        DateTimeScaleEnginePrivate::SplitInterval interval,
-                                                        int tick_step) const
+qint64 DateTimeScaleEnginePrivate::alignedToInterval(qint64 usecs,
+                                                     DateTimeScaleEnginePrivate::SplitInterval interval,
+                                                     int tick_step) const
 {
     if (scale == 0)
-        return datetime;
-
-    QDateTime aligned_datetime = datetime;
-
-    if ((interval == IntervalSecond_1) ||
-        (interval == IntervalSecond_5) ||
-        (interval == IntervalSecond_10) ||
-        (interval == IntervalSecond_30) ||
-        (interval == IntervalMinute_1) ||
-        (interval == IntervalMinute_5) ||
-        (interval == IntervalMinute_10) ||
-        (interval == IntervalMinute_30) ||
-        (interval == IntervalHour_1) ||
-        (interval == IntervalHour_2) ||
-        (interval == IntervalHour_3) ||
-        (interval == IntervalHour_4) ||
-        (interval == IntervalHour_6) ||
-        (interval == IntervalHour_12))
-    {
-        const QDateTime aligned_datetime_utc =
-                QDateTime(aligned_datetime.date(), aligned_datetime.time(), Qt::UTC);
+        return usecs;
 
-        const int utc_offset = aligned_datetime.secsTo(aligned_datetime_utc);
+    // выравнивание по местному времени
+    const qint64 local_usecs = offset_table.toLocal(usecs);
 
-        const uint local_aligned_datetime_seconds = aligned_datetime.toTime_t() + utc_offset;
+    const qint64 interval_usecs = intervalUSecs(interval);
 
-        const uint major_tick_seconds_step =
-                aligned_datetime.secsTo(nextDateTime(aligned_datetime, interval, tick_step));
+    if (interval_usecs > 0) {
+        const qint64 major_tick_usecs_step = interval_usecs * tick_step;
 
-        const uint tmp = local_aligned_datetime_seconds / major_tick_seconds_step;
+        qint64 aligned_local_usecs = CivilTime::floorDiv(local_usecs, major_tick_usecs_step) * major_tick_usecs_step;
+        if (aligned_local_usecs != local_usecs)
+            aligned_local_usecs += major_tick_usecs_step;
 
-        if (local_aligned_datetime_seconds != tmp * major_tick_seconds_step) {
-            aligned_datetime =
-                    QDateTime::fromTime_t((tmp + 1) * major_tick_seconds_step - utc_offset);
-        }
+        return offset_table.toUtc(aligned_local_usecs);
     }
-    else if (interval == IntervalDay_1) {
-        if (aligned_datetime.time() != QTime(0, 0, 0)) {
-            aligned_datetime.setTime(QTime(0, 0, 0));
-            aligned_datetime.setDate(aligned_datetime.addDays(1).date());
-        }
+
+    CivilTime::Fields aligned_fields = CivilTime::fields(local_usecs);
+
+    const bool is_midnight = (CivilTime::startOfDay(local_usecs) == local_usecs);
+
+    if (interval == IntervalDay_1) {
+        if (is_midnight)
+            return usecs;
+
+        return offset_table.toUtc(CivilTime::startOfDay(local_usecs) + CivilTime::usecs_per_day);
     }
-    else if (interval == IntervalMonth_1) {
-        if ((aligned_datetime.date().day() != 1) || (aligned_datetime.time() != QTime(0, 0, 0))) {
-            aligned_datetime.setTime(QTime(0, 0, 0));
-            aligned_datetime.setDate(QDate(aligned_datetime.addMonths(1).date().year(),
-                                           aligned_datetime.addMonths(1).date().month(),
-                                           1));
-        }
+
+    aligned_fields.hour = 0;
+    aligned_fields.minute = 0;
+    aligned_fields.second = 0;
+    aligned_fields.usec = 0;
+
+    if (interval == IntervalMonth_1) {
+        if ((aligned_fields.day == 1) && is_midnight)
+            return usecs;
+
+        aligned_fields.day = 1;
+        return offset_table.toUtc(CivilTime::addMonths(CivilTime::usecs(aligned_fields), 1));
     }
-    else if (interval == IntervalMonth_3) {
-        if (((aligned_datetime.date().month() % 3) != 0) || (aligned_datetime.time() != QTime(0, 0, 0))) {
-            int month = aligned_datetime.date().month();
-            month = ((month % 3) == 0) ? month : ((month / 3 + 1) * 3);
-            if ((aligned_datetime.date().month() != month) && (aligned_datetime.time() != QTime(0, 0, 0))) {
-                aligned_datetime = aligned_datetime.addMonths(3);
-            }
-            else {
-                aligned_datetime.setDate(QDate(aligned_datetime.date().year(),
-                                               month,
-                                               1));
-            }
-            aligned_datetime.setTime(QTime(0, 0, 0));
-        }
+
+    if (interval == IntervalMonth_3) {
+        if (((aligned_fields.month % 3) == 0) && (aligned_fields.day == 1) && is_midnight)
+            return usecs;
+
+        // ближайший следующий месяц с номером, кратным трем
+        aligned_fields.day = 1;
+        const int months_to_quarter = 3 - (aligned_fields.month % 3);
+        return offset_table.toUtc(CivilTime::addMonths(CivilTime::usecs(aligned_fields), months_to_quarter));
     }
-    else if (interval == IntervalYear) {
-        if (aligned_datetime.secsTo(QDateTime(QDate(aligned_datetime.date().year(), 1, 1), QTime(0, 0, 0))) != 0) {
-            aligned_datetime.setTime(QTime(0, 0, 0));
-            aligned_datetime.setDate(QDate(aligned_datetime.date().year() + 1, 1, 1));
-        }
+
+    if (interval == IntervalYear) {
+        if ((aligned_fields.month == 1) && (aligned_fields.day == 1) && is_midnight)
+            return usecs;
+
+        aligned_fields.month = 1;
+        aligned_fields.day = 1;
+        return offset_table.toUtc(CivilTime::addYears(CivilTime::usecs(aligned_fields), 1));
     }
 
-    return aligned_datetime;
+    return usecs;
 }
 
 QString DateTimeScaleEnginePrivate::majorTickLabelFormat(DateTimeScaleEnginePrivate::SplitInterval interval) const
@@ -407,6 +472,15 @@ QString DateTimeScaleEnginePrivate::majorTickLabelFormat(DateTimeScaleEnginePriv
     QString format = QString::null;
 
     switch (interval) {
+        case IntervalMicrosecond_1:
+        case IntervalMicrosecond_10:
+        case IntervalMicrosecond_100:
+        case IntervalMillisecond_1:
+        case IntervalMillisecond_10:
+        case IntervalMillisecond_100:
+            format = "hh:mm:ss.zzz";
+            break;
+
         case IntervalSecond_1:
         case IntervalSecond_5:
         case IntervalSecond_10:
@@ -456,6 +530,12 @@ QString DateTimeScaleEnginePrivate::majorTickSubLabelFormat(DateTimeScaleEngineP
     QString format = QString::null;
 
     switch (interval) {
+        case IntervalMicrosecond_1:
+        case IntervalMicrosecond_10:
+        case IntervalMicrosecond_100:
+        case IntervalMillisecond_1:
+        case IntervalMillisecond_10:
+        case IntervalMillisecond_100:
         case IntervalSecond_1:
         case IntervalSecond_5:
         case IntervalSecond_10:
@@ -488,12 +568,39 @@ QString DateTimeScaleEnginePrivate::majorTickSubLabelFormat(DateTimeScaleEngineP
     return format;
 }
 
-bool DateTimeScaleEnginePrivate::needsSubLabel(const QDateTime &prev_datetime, const QDateTime &datetime,
+QString DateTimeScaleEnginePrivate::majorTickLabel(qint64 usecs, const QString &format,
+                                                   DateTimeScaleEnginePrivate::SplitInterval interval) const
+{
+    const qint64 local_usecs = offset_table.toLocal(usecs);
+
+    QString label = CivilTime::toString(local_usecs, format);
+
+    // формат "zzz" выводит миллисекунды, микросекунды дописываются отдельно
+    if ((interval == IntervalMicrosecond_1) ||
+        (interval == IntervalMicrosecond_10) ||
+        (interval == IntervalMicrosecond_100))
+    {
+        label += QString("%1").arg(CivilTime::floorMod(local_usecs, 1000), 3, 10, QChar('0'));
+    }
+
+    return label;
+}
+
+bool DateTimeScaleEnginePrivate::needsSubLabel(qint64 prev_usecs, qint64 usecs,
                                                DateTimeScaleEnginePrivate::SplitInterval interval) const
 {
+    const CivilTime::Fields prev_fields = CivilTime::fields(offset_table.toLocal(prev_usecs));
+    const CivilTime::Fields fields = CivilTime::fields(offset_table.toLocal(usecs));
+
     bool needs_sublabel = false;
 
     switch (interval) {
+        case IntervalMicrosecond_1:
+        case IntervalMicrosecond_10:
+        case IntervalMicrosecond_100:
+        case IntervalMillisecond_1:
+        case IntervalMillisecond_10:
+        case IntervalMillisecond_100:
         case IntervalSecond_1:
         case IntervalSecond_5:
         case IntervalSecond_10:
@@ -508,11 +615,11 @@ bool DateTimeScaleEnginePrivate::needsSubLabel(const QDateTime &prev_datetime, c
         case IntervalHour_4:
         case IntervalHour_6:
         case IntervalHour_12:
-            needs_sublabel = ((prev_datetime.date().day() != datetime.date().day()) || prev_datetime.isNull());
+            needs_sublabel = (prev_fields.day != fields.day);
             break;
 
         case IntervalDay_1:
-            needs_sublabel = ((prev_datetime.date().year() != datetime.date().year()) || prev_datetime.isNull());
+            needs_sublabel = (prev_fields.year != fields.year);
             break;
 
         case IntervalMonth_1:
@@ -549,6 +656,35 @@ void DateTimeScaleEngine::setScale(AbstractScale *scale)
     d->scale = scale;
 }
 
+double DateTimeScaleEngine::zoomFactor() const
+{
+    Q_D(const DateTimeScaleEngine);
+    return d->zoom_factor;
+}
+
+void DateTimeScaleEngine::setZoomFactor(double factor)
+{
+    Q_D(DateTimeScaleEngine);
+    d->zoom_factor = (factor > 0.0) ? factor : 1.0;
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+QTimeZone DateTimeScaleEngine::timeZone() const
+{
+    Q_D(const DateTimeScaleEngine);
+    return d->time_zone;
+}
+
+void DateTimeScaleEngine::setTimeZone(const QTimeZone &time_zone)
+{
+    Q_D(DateTimeScaleEngine);
+    if (d->time_zone != time_zone) {
+        d->time_zone = time_zone;
+        d->offset_table.clear();
+    }
+}
+#endif
+
 QList<double> DateTimeScaleEngine::tickPositions() const
 {
     Q_D(const DateTimeScaleEngine);
@@ -586,6 +722,12 @@ void DateTimeScaleEngine::update(const QFontMetrics &font_metrics, const QRectF
     if (d->scale == 0)
         return;
 
+    // засечки перебираются в микросекундах от начала эпохи
+    const qint64 tick_start_value = Converter::scaleToUSecs(d->scale->minimum());
+    const qint64 tick_end_value = Converter::scaleToUSecs(d->scale->maximum());
+
+    d->updateOffsetTable(tick_start_value, tick_end_value);
+
     const double minimum_tick_distance = 5.0;
 
     DateTimeScaleEnginePrivate::SplitInterval interval = d->interval(minimum_tick_distance);
@@ -595,10 +737,7 @@ void DateTimeScaleEngine::update(const QFontMetrics &font_metrics, const QRectF
 
     const int major_tick_step = d->majorTickStep(interval);
 
-    const QDateTime tick_start_value = Converter::fromScale(d->scale->minimum());
-    const QDateTime tick_end_value = Converter::fromScale(d->scale->maximum());
-
-    const QDateTime major_tick_start_val = d->alignedToInterval(tick_start_value, interval, major_tick_step);
+    const qint64 major_tick_start_val = d->alignedToInterval(tick_start_value, interval, major_tick_step);
 
     const QString major_tick_format = d->majorTickLabelFormat(interval);
     const QString major_tick_subformat = d->majorTickSubLabelFormat(interval);
@@ -606,29 +745,34 @@ void DateTimeScaleEngine::update(const QFontMetrics &font_metrics, const QRectF
     const double tick_pos_offset = (d->scale->orientation() == Qt::Horizontal) ? scale_rect.x()
                                                                                : scale_rect.y();
 
-    for (QDateTime tick_value = tick_start_value; tick_value < major_tick_start_val; /**/) {
-        d->tick_positions.append(d->scale->position(Converter::toScale(tick_value)) + tick_pos_offset);
-        tick_value = d->nextDateTime(tick_value, interval);
+    for (qint64 tick_value = tick_start_value; tick_value < major_tick_start_val; /**/) {
+        d->tick_positions.append(d->position(tick_value) + tick_pos_offset);
+        tick_value = d->nextTick(tick_value, interval);
     }
 
-    int tick_step = 0;
-    for (QDateTime tick_value = major_tick_start_val; tick_value <= tick_end_value; ++ tick_step) {
-        const double tick_pos = d->scale->position(Converter::toScale(tick_value)) + tick_pos_offset;
-        if ((tick_step % major_tick_step) == 0)
-            d->major_tick_positions.append(tick_pos);
-        else
-            d->tick_positions.append(tick_pos);
-        tick_value = d->nextDateTime(tick_value, interval);
+    // крупные засечки отсчитываются по местному времени тем же шагом, что и подписи,
+    // а не каждой major_tick_step-й засечкой: при смене смещения в сутках 23 или 25 часов
+    qint64 major_tick_value = major_tick_start_val;
+    for (qint64 tick_value = major_tick_start_val; tick_value <= tick_end_value; /* empty */) {
+        if (tick_value >= major_tick_value) {
+            tick_value = major_tick_value;
+            d->major_tick_positions.append(d->position(tick_value) + tick_pos_offset);
+            major_tick_value = d->nextTick(major_tick_value, interval, major_tick_step);
+        }
+        else {
+            d->tick_positions.append(d->position(tick_value) + tick_pos_offset);
+        }
+
+        tick_value = d->nextTick(tick_value, interval);
     }
 
-    for (QDateTime tick_value = major_tick_start_val, prev_tick_value = major_tick_start_val;
+    for (qint64 tick_value = major_tick_start_val, prev_tick_value = major_tick_start_val;
          tick_value <= tick_end_value; /* empty */)
     {
-        //	for (QDateTime tick_value = major_tick_start_val, prev_tick_value; tick_value <= tick_end_value; /* empty */) {
-        QString tick_label = tick_value.toString(major_tick_format);
+        QString tick_label = d->majorTickLabel(tick_value, major_tick_format, interval);
 
         if (d->needsSubLabel(prev_tick_value, tick_value, interval))
-            tick_label += "\n" + tick_value.toString(major_tick_subformat);
+            tick_label += "\n" + CivilTime::toString(d->offset_table.toLocal(tick_value), major_tick_subformat);
 
         QRectF tick_label_rect =
                 font_metrics.boundingRect(QRect(0, 0, 0, 0), Qt::AlignCenter, tick_label);
@@ -636,12 +780,12 @@ void DateTimeScaleEngine::update(const QFontMetrics &font_metrics, const QRectF
         if (d->scale->orientation() == Qt::Horizontal) {
             if (revert) {
                 tick_label_rect.moveCenter(
-                            QPointF(d->scale->position(Converter::toScale(tick_value)) + scale_rect.x(),
+                            QPointF(d->position(tick_value) + scale_rect.x(),
                                     scale_rect.bottom() - 10.0 - tick_label_rect.height() * 0.5));
             }
             else {
                 tick_label_rect.moveCenter(
-                            QPointF(d->scale->position(Converter::toScale(tick_value)) + scale_rect.x(),
+                            QPointF(d->position(tick_value) + scale_rect.x(),
                                     scale_rect.top() + 10.0 + tick_label_rect.height() * 0.5));
             }
         }
@@ -649,12 +793,12 @@ void DateTimeScaleEngine::update(const QFontMetrics &font_metrics, const QRectF
             if (revert) {
                 tick_label_rect.moveCenter(
                             QPointF(scale_rect.right() - 13.0 - tick_label_rect.width() * 0.5,
-                                    d->scale->position(Converter::toScale(tick_value)) + scale_rect.y()));
+                                    d->position(tick_value) + scale_rect.y()));
             }
             else {
                 tick_label_rect.moveCenter(
                             QPointF(scale_rect.left() + 13.0 + tick_label_rect.width() * 0.5,
-                                    d->scale->position(Converter::toScale(tick_value)) + scale_rect.y()));
+                                    d->position(tick_value) + scale_rect.y()));
             }
         }
 
@@ -662,8 +806,70 @@ void DateTimeScaleEngine::update(const QFontMetrics &font_metrics, const QRectF
         d->major_tick_label_rectangles.append(tick_label_rect);
 
         prev_tick_value = tick_value;
-        tick_value = d->nextDateTime(tick_value, interval, major_tick_step);
+        tick_value = d->nextTick(tick_value, interval, major_tick_step);
     }
 }
 
+double DateTimeScaleEngine::snapped(double value) const
+{
+    Q_D(const DateTimeScaleEngine);
+
+    if (d->scale == 0)
+        return value;
+
+    const DateTimeScaleEnginePrivate::SplitInterval interval = d->interval();
+    if (interval == DateTimeScaleEnginePrivate::IntervalNone)
+        return value;
+
+    const qint64 usecs = Converter::scaleToUSecs(value);
+    const qint64 interval_usecs = DateTimeScaleEnginePrivate::intervalUSecs(interval);
+
+    qint64 previous_usecs = usecs;
+    qint64 next_usecs = usecs;
+
+    if ((interval_usecs > 0) || (interval == DateTimeScaleEnginePrivate::IntervalDay_1)) {
+        // интервалы постоянной длины выравниваются по местному времени делением с округлением вниз
+        const qint64 step_usecs = (interval_usecs > 0) ? interval_usecs : CivilTime::usecs_per_day;
+
+        d->updateOffsetTable(usecs - step_usecs - CivilTime::usecs_per_day, usecs + step_usecs + CivilTime::usecs_per_day);
+
+        const qint64 previous_local_usecs = CivilTime::floorDiv(d->offset_table.toLocal(usecs), step_usecs) * step_usecs;
+
+        previous_usecs = d->offset_table.toUtc(previous_local_usecs);
+        next_usecs = d->offset_table.toUtc(previous_local_usecs + step_usecs);
+    }
+    else {
+        // календарный интервал не длиннее самого длинного периода (с запасом на смену смещения),
+        // поэтому до предыдущей засечки не больше двух шагов
+        qint64 lookback_usecs = CivilTime::usecs_per_day;
+        switch (interval) {
+            case DateTimeScaleEnginePrivate::IntervalMonth_1:
+                lookback_usecs += Q_INT64_C(31) * CivilTime::usecs_per_day;
+                break;
+            case DateTimeScaleEnginePrivate::IntervalMonth_3:
+                lookback_usecs += Q_INT64_C(92) * CivilTime::usecs_per_day;
+                break;
+            default:
+                lookback_usecs += Q_INT64_C(366) * CivilTime::usecs_per_day;
+                break;
+        }
+
+        d->updateOffsetTable(usecs - lookback_usecs, usecs + lookback_usecs);
+
+        next_usecs = d->alignedToInterval(usecs, interval, 1);
+        if (next_usecs == usecs)
+            return value;
+
+        previous_usecs = d->alignedToInterval(usecs - lookback_usecs, interval, 1);
+        for (;;) {
+            const qint64 tick_usecs = d->nextTick(previous_usecs, interval);
+            if ((tick_usecs > usecs) || (tick_usecs <= previous_usecs))
+                break;
+            previous_usecs = tick_usecs;
+        }
+    }
+
+    return Converter::usecsToScale(((usecs - previous_usecs) <= (next_usecs - usecs)) ? previous_usecs : next_usecs);
+}
+
 } // namespace Graphics
@@ -10,6 +10,8 @@
 #include "include/datetimescale.h"
 #include "include/converter.h"
 #include "include/datetimescaleengine.h"
+#include "include/abstractplotscene.h"
+#include "include/plotstatistics.h"
 
 
 namespace Graphics {
@@ -22,7 +24,7 @@ class DateTimeScalePlotItemPrivate {
     DateTimeScalePlotItem *q_ptr;
 
     //! Движок рисования шкалы.
-    AbstractScaleEngine *engine;
+    DateTimeScaleEngine *engine;
     //! Отображаемая временная шкала.
     DateTimeScale *datetime_scale;
 
@@ -44,6 +46,10 @@ class DateTimeScalePlotItemPrivate {
     Qt::Orientation cached_orientation;
     //! Кэшированное значение флага положения подписей шкалы.
     bool cached_revert;
+    //! Кэшированное значение коэффициента растяжения шкалы виджетом отображения.
+    double cached_zoom_factor;
+    //! Флаг устаревания кэша при смене параметров движка.
+    bool is_cache_dirty;
 
     //! Размер засечки.
     double tick_size;
@@ -59,14 +65,39 @@ class DateTimeScalePlotItemPrivate {
     DateTimeScalePlotItemPrivate(DateTimeScalePlotItem *q) :
         q_ptr(q), datetime_scale(0), is_reverted(false),
         cached_minimum(0.0), cached_maximum(0.0), cached_length(0.0),
-        cached_orientation(Qt::Horizontal), cached_revert(false)
+        cached_orientation(Qt::Horizontal), cached_revert(false),
+        cached_zoom_factor(1.0), is_cache_dirty(true)
     {}
 
     //! Деструктор.
     ~DateTimeScalePlotItemPrivate() {}
 
-    //! Проверка на необходимость пересчета кэшированных значений перед рисованием.
-    bool needsPaintingCacheInvalidation() const
+    //! Коэффициент растяжения шкалы преобразованием \c painter вдоль ее оси.
+    double zoomFactor(const QPainter *painter) const
+    {
+        const QTransform &world_transform = painter->worldTransform();
+
+        const double factor = (datetime_scale->orientation() == Qt::Horizontal) ? world_transform.m11()
+                                                                                 : world_transform.m22();
+
+        return (factor > 0.0) ? factor : 1.0;
+    }
+
+    //! Описывающий прямоугольник элемента, растянутый с коэффициентом \c zoom_factor.
+    QRectF zoomedRect(double zoom_factor) const
+    {
+        Q_Q(const DateTimeScalePlotItem);
+
+        const QRectF item_rect = q->boundingRect();
+
+        if (datetime_scale->orientation() == Qt::Horizontal)
+            return QRectF(item_rect.x() * zoom_factor, item_rect.y(), item_rect.width() * zoom_factor, item_rect.height());
+
+        return QRectF(item_rect.x(), item_rect.y() * zoom_factor, item_rect.width(), item_rect.height() * zoom_factor);
+    }
+
+    //! Проверка на необходимость пересчета кэшированных значений перед рисованием с растяжением \c zoom_factor.
+    bool needsPaintingCacheInvalidation(double zoom_factor) const
     {
         if (datetime_scale == 0)
             return false;
@@ -75,7 +106,9 @@ class DateTimeScalePlotItemPrivate {
             (cached_maximum != datetime_scale->maximum()) ||
             (cached_length != datetime_scale->length()) ||
             (cached_orientation != datetime_scale->orientation()) ||
-            (cached_revert != is_reverted))
+            (cached_revert != is_reverted) ||
+            (cached_zoom_factor != zoom_factor) ||
+            is_cache_dirty)
         {
             return true;
         }
@@ -83,14 +116,14 @@ class DateTimeScalePlotItemPrivate {
         return false;
     }
 
-    //! Пересчет кэшированных значений с использование опции стиля \c option.
-    void invalidatePaintingChache(const QStyleOptionGraphicsItem *option)
+    //! Пересчет кэшированных значений с использование опции стиля \c option и растяжения \c zoom_factor.
+    void invalidatePaintingChache(const QStyleOptionGraphicsItem *option, double zoom_factor)
     {
-        Q_Q(DateTimeScalePlotItem);
-
         scale_lines.clear();
 
-        QRectF item_rect = q->boundingRect();
+        QRectF item_rect = zoomedRect(zoom_factor);
+
+        engine->setZoomFactor(zoom_factor);
 
         engine->update(option->fontMetrics, item_rect, is_reverted);
 
@@ -141,6 +174,8 @@ class DateTimeScalePlotItemPrivate {
         cached_length = datetime_scale->length();
         cached_orientation = datetime_scale->orientation();
         cached_revert = is_reverted;
+        cached_zoom_factor = zoom_factor;
+        is_cache_dirty = false;
     }
 
     void paintScaleLines(QPainter *painter, const QStyleOptionGraphicsItem *option)
@@ -224,6 +259,11 @@ double DateTimeScalePlotItem::endCoordinateY() const
                                                               : StandardPlotItem::endCoordinateY();
 }
 
+bool DateTimeScalePlotItem::isScaleRangeDependent() const
+{
+    return true;
+}
+
 bool DateTimeScalePlotItem::isReverted() const
 {
     Q_D(const DateTimeScalePlotItem);
@@ -252,6 +292,24 @@ void DateTimeScalePlotItem::setDateTimeScale(DateTimeScale *datetime_scale)
     }
 }
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+QTimeZone DateTimeScalePlotItem::timeZone() const
+{
+    Q_D(const DateTimeScalePlotItem);
+    return d->engine->timeZone();
+}
+
+void DateTimeScalePlotItem::setTimeZone(const QTimeZone &time_zone)
+{
+    Q_D(DateTimeScalePlotItem);
+    if (d->engine->timeZone() != time_zone) {
+        d->engine->setTimeZone(time_zone);
+        d->is_cache_dirty = true;
+        update();
+    }
+}
+#endif
+
 void DateTimeScalePlotItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
     Q_UNUSED(widget);
@@ -261,11 +319,35 @@ void DateTimeScalePlotItem::paint(QPainter *painter, const QStyleOptionGraphicsI
     if (d->datetime_scale == 0)
         return;
 
-    if (d->needsPaintingCacheInvalidation())
-        d->invalidatePaintingChache(option);
+    // засечки и подписи не растягиваются вместе с виджетом, а пересчитываются под его масштаб
+    const double zoom_factor = d->zoomFactor(painter);
+
+    if (d->needsPaintingCacheInvalidation(zoom_factor)) {
+        AbstractPlotScene *plot_scene = plotScene();
+
+        if (plot_scene == 0) {
+            d->invalidatePaintingChache(option, zoom_factor);
+        } else {
+            GRAPHICS_STATISTICS_TIMER(plot_scene->statistics(), ScaleEngineTime);
+
+            d->invalidatePaintingChache(option, zoom_factor);
+
+            GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), ScaleEngineUpdates, 1);
+            GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), TicksGenerated,
+                                      d->engine->tickPositions().size() + d->engine->majorTickPositions().size());
+            GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), LabelsMeasured, d->engine->majorTickLabels().size());
+        }
+    }
 
     painter->save();
 
+    if (zoom_factor != 1.0) {
+        if (d->datetime_scale->orientation() == Qt::Horizontal)
+            painter->scale(1.0 / zoom_factor, 1.0);
+        else
+            painter->scale(1.0, 1.0 / zoom_factor);
+    }
+
     painter->setPen(d->item_pen);
     painter->setFont(d->label_font);
 
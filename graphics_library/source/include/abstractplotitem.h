@@ -92,6 +92,9 @@ public:
 
     //! Описывающий прямоугольник элемента.
     virtual QRectF boundingRect() const = 0;
+
+    //! Флаг зависимости координат элемента от диапазона шкал (например, элемент во всю длину шкалы).
+    virtual bool isScaleRangeDependent() const { return false; }
     //! Рисование элемента с помощью \c painter, используя настройку стиля \c option и родительский виджет \c widget.
     virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) = 0;
 };
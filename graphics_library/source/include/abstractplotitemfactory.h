@@ -0,0 +1,44 @@
+#ifndef GRAPHICS_ABSTRACTPLOTITEMFACTORY_H
+#define GRAPHICS_ABSTRACTPLOTITEMFACTORY_H
+
+/*!
+  * \file abstractplotitemfactory.h
+  * \brief Объявление базового класса для создания элементов графика по записям расписания.
+  */
+
+#include <QString>
+#include "commonprerequisites.h"
+#include "abstractplotitem.h"
+#include "timelinefile.h"
+
+namespace Graphics {
+
+//! Базовый класс для создания элементов графика по записям расписания.
+class GRAPHICS_EXPORT AbstractPlotItemFactory {
+    Q_DISABLE_COPY(AbstractPlotItemFactory)
+protected:
+    //! Конструктор.
+    AbstractPlotItemFactory() {}
+public:
+    //! Деструктор.
+    virtual ~AbstractPlotItemFactory() {}
+
+    /*!
+     * \brief Создание элемента графика для записи \c record на сцене с ориентацией \c orientation.
+     *
+     * Начало и конец записи откладываются вдоль оси прокрутки, секция - вдоль второй оси.
+     */
+    virtual AbstractPlotItem *createPlotItem(const TimelineRecord &record, Qt::Orientation orientation) = 0;
+    //! Создание элемента графика для записи \c record с подписью \c label (по умолчанию подпись не используется).
+    virtual AbstractPlotItem *createPlotItem(const TimelineRecord &record, const QString &label, Qt::Orientation orientation)
+    {
+        Q_UNUSED(label);
+        return createPlotItem(record, orientation);
+    }
+    //! Уничтожение элемента \c item, созданного методом createPlotItem().
+    virtual void destroyPlotItem(AbstractPlotItem *item) { delete item; }
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_ABSTRACTPLOTITEMFACTORY_H
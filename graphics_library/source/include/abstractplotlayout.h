@@ -7,7 +7,10 @@
   */
 
 #include <QObject>
+#include <QList>
 #include "commonprerequisites.h"
+#include "abstractscale.h"
+#include "plotitemgeometry.h"
 
 namespace Graphics {
 
@@ -30,6 +33,67 @@ public:
     virtual void refresh() = 0;
     //! Пересчет позиции элемента \c item.
     virtual void refresh(AbstractPlotItem *item) = 0;
+    //! Пересчет позиций элементов \c items (например, только что добавленных на график).
+    virtual void refresh(const QList<AbstractPlotItem *> &items)
+    {
+        foreach (AbstractPlotItem *item, items)
+            refresh(item);
+    }
+
+    /*!
+     * \brief Уведомление о добавлении элемента \c item на график.
+     *
+     * Вызывается сценой до расчета позиции элемента, а при смене объекта позиционирования -
+     * для всех элементов графика. Позволяет поддерживать собственные структуры объекта
+     * позиционирования без их полного перестроения.
+     */
+    virtual void itemAdded(AbstractPlotItem *item) { Q_UNUSED(item); }
+    //! Уведомление об удалении элемента \c item с графика.
+    virtual void itemRemoved(AbstractPlotItem *item) { Q_UNUSED(item); }
+    /*!
+     * \brief Уведомление об удалении элементов \c items с графика одной операцией.
+     *
+     * По умолчанию вызывает itemRemoved() для каждого элемента.
+     */
+    virtual void itemsRemoved(const QList<AbstractPlotItem *> &items)
+    {
+        foreach (AbstractPlotItem *item, items)
+            itemRemoved(item);
+    }
+
+    /*!
+     * \brief Флаг возможности расчета геометрии методом geometry() вне потока GUI.
+     *
+     * Сцена рассчитывает геометрию в фоновом потоке (например, при масштабировании
+     * AbstractPlotScene::ZoomDeferred) только для объектов позиционирования с этим флагом.
+     */
+    virtual bool isGeometryReentrant() const { return false; }
+
+    /*!
+     * \brief Геометрия элемента со значениями \c values на шкалах \c x_scale и \c y_scale.
+     *
+     * Не изменяет ни элемент, ни шкалы. По умолчанию размеры рассчитываются расстоянием
+     * между значениями элемента, а положение - методом шкалы AbstractScale::position().
+     */
+    virtual PlotItemGeometry geometry(const PlotItemValues &values,
+                                      const AbstractScale *x_scale, const AbstractScale *y_scale) const
+    {
+        PlotItemGeometry item_geometry;
+
+        item_geometry.width = values.is_width_calculated ? x_scale->distance(values.begin_x, values.end_x)
+                                                         : values.width;
+        item_geometry.height = values.is_height_calculated ? y_scale->distance(values.begin_y, values.end_y)
+                                                           : values.height;
+
+        item_geometry.x = (x_scale->orientation() == Qt::Horizontal)
+                          ? x_scale->position(values.begin_x, values.end_x, item_geometry.width)
+                          : x_scale->position(values.begin_y, values.end_y, item_geometry.height);
+        item_geometry.y = (y_scale->orientation() == Qt::Horizontal)
+                          ? y_scale->position(values.begin_x, values.end_x, item_geometry.width)
+                          : y_scale->position(values.begin_y, values.end_y, item_geometry.height);
+
+        return item_geometry;
+    }
 };
 
 } // namespace Graphics
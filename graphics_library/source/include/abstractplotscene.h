@@ -10,6 +10,7 @@
   */
 
 #include <QGraphicsScene>
+#include <QTransform>
 #include "commonprerequisites.h"
 
 namespace Graphics {
@@ -17,6 +18,24 @@ namespace Graphics {
 //! Базовый класс сцены графика.
 class GRAPHICS_EXPORT AbstractPlotScene : public QGraphicsScene {
     Q_OBJECT
+public:
+    //! Способ масштабирования графика.
+    enum ZoomMode {
+        //! Изменением длины шкалы и пересчетом положения всех элементов.
+        ZoomRelayout,
+        /*!
+         * Преобразованием виджета отображения вдоль оси прокрутки без пересчета элементов.
+         * Текст элементов не растягивается, если выводится методом StandardPlotItem::drawText().
+         */
+        ZoomTransform,
+        /*!
+         * Изменением длины шкалы с пересчетом положения элементов в фоновом потоке.
+         * До окончания пересчета виджет отображения растягивает прежнюю геометрию
+         * преобразованием zoomTransform(), после применения новой геометрии сцена
+         * сообщает об этом сигналом zoomTransformChanged().
+         */
+        ZoomDeferred
+    };
 protected:
     //! Конструктор с установкой родительского объекта \c parent.
     explicit AbstractPlotScene(QObject *parent = 0);
@@ -44,6 +63,14 @@ public:
     //! Смена ориентации графической сцены на \c orientation.
     virtual void setSceneOrientation(Qt::Orientation orientation) = 0;
 
+    //! Способ масштабирования графика (по умолчанию ZoomRelayout).
+    virtual ZoomMode zoomMode() const;
+    //! Смена способа масштабирования графика на \c mode (по умолчанию не поддерживается).
+    virtual void setZoomMode(ZoomMode mode);
+
+    //! Преобразование, применяемое виджетом отображения для текущего шага масштабирования (по умолчанию единичное).
+    virtual QTransform zoomTransform() const;
+
     //! Шаг масштабирования графика.
     virtual double zoomExtent() const = 0;
     //! Смена шага масштабирования графика на \c extent.
@@ -54,6 +81,11 @@ public:
     //! Удаление элемента \c item с графика.
     virtual void removePlotItem(AbstractPlotItem *item) = 0;
 
+    //! Добавление элементов \c items на график с расчетом их положения.
+    virtual void addPlotItems(const QList<AbstractPlotItem *> &items);
+    //! Удаление элементов \c items с графика.
+    virtual void removePlotItems(const QList<AbstractPlotItem *> &items);
+
     //! Элементы графика.
     virtual QList<AbstractPlotItem *> plotItems() const = 0;
     //! Элементы графика, расположенные в точке \c scale_values.
@@ -88,6 +120,13 @@ public:
     //! Смена максимального шага масштабирования на \c step.
     virtual void setMaximumZoomStep(int step) = 0;
 
+    //! Статистика работы графика с момента последнего сброса.
+    virtual const PlotStatistics &statistics() const;
+    //! Статистика работы графика для учета компонентами графика.
+    virtual PlotStatistics &statistics();
+    //! Сброс статистики работы графика (например, перед каждым кадром).
+    virtual void resetStatistics();
+
     //! Отображение прямоугольника \c visible_scene_rect на графике.
     virtual void visualize(const QRectF &visible_scene_rect);
     //! Прокрутка графика для отображения прямоугольника \c visible_scene_rect.
@@ -98,6 +137,34 @@ public:
     //! Прокутка графика с отображаемой областью \c visible_scene_rect в точку \c scale_values.
     virtual void scrollTo(const QRectF &visible_scene_rect, const QPointF &scale_values);
 
+    /*!
+     * \brief Предупреждение о прокрутке области \c visible_scene_rect со скоростью \c velocity.
+     *
+     * Скорость задается в единицах сцены в секунду. Виджет отображения вызывает метод при
+     * перетаскивании и инерционной прокрутке, чтобы сцена заранее подготовила данные
+     * в направлении движения. По умолчанию ничего не делает.
+     */
+    virtual void predictScroll(const QRectF &visible_scene_rect, const QPointF &velocity);
+
+    /*!
+     * \brief Флаг поиска элемента под курсором мыши самой сценой.
+     *
+     * Если флаг установлен, элементы графика не принимают события наведения курсора от
+     * QGraphicsScene, а сцена сама находит элемент под курсором и отправляет ему эти события.
+     */
+    virtual bool isHoverResolved() const;
+
+    //! Модель выделения элементов графика (0 - если сцена не поддерживает выделение моделью).
+    virtual PlotSelectionModel *selectionModel() const;
+
+    /*!
+     * \brief Флаг перемещения элементов сценой в значениях шкал.
+     *
+     * Если флаг установлен, элементы не перемещаются QGraphicsScene в координатах сцены,
+     * а сцена сама меняет координаты начала и конца перетаскиваемых элементов.
+     */
+    virtual bool isValueMoveEnabled() const;
+
     //! Обработка вхождения курсора мыши в область элемента \c item в точке \c scene_pos.
     virtual void plotItemHoverEnter(AbstractPlotItem *item, const QPointF &scene_pos);
     //! Обработка движения курсора мыши в области элемента \c item в точке \c scene_pos.
@@ -117,10 +184,26 @@ public:
     //! Обработка вызова контекстного меню элемента \c item в точке \c scene_pos.
     virtual void plotItemContextMenu(AbstractPlotItem *item, const QPointF &scene_pos);
 
+    //! Обработка завершения перемещения элементов \c items в значениях шкал.
+    virtual void plotItemsMoved(const QList<AbstractPlotItem *> &items);
+
+    //! Обработка смены координат начала или конца элемента \c item.
+    virtual void plotItemCoordinatesChanged(AbstractPlotItem *item);
+
     //! Отображние точки сцены \c scene_pos в значения шкал графика.
     virtual QPointF mapToScales(const QPointF &scene_pos) const = 0;
     //! Отображение значений шкал графика \c scale_values в координаты сцены.
     virtual QPointF mapFromScales(const QPointF &scale_values) const = 0;
+private:
+    //! Статистика сцены, не ведущей собственного учета (создается при первом обращении).
+    mutable PlotStatistics *default_statistics;
+signals:
+    //! Сигнал изменения преобразования zoomTransform() без участия виджета отображения.
+    void zoomTransformChanged();
+    //! Сигнал запроса показа значений шкал \c scale_values виджетами отображения.
+    void followRequested(const QPointF &scale_values);
+    //! Сигнал пересчета положения всех элементов графика.
+    void layoutChanged();
 };
 
 } // namespace Graphics
@@ -45,6 +45,23 @@ public:
     //! Смена диапазона допустимых значений шкалы на \c min и \c max.
     virtual void setRange(double min, double max) = 0;
 
+    //! Значение шкалы в нулевой позиции.
+    virtual double origin() const { return minimum(); }
+    /*!
+     * \brief Закрепление нулевой позиции шкалы за значением \c value.
+     *
+     * Пока нулевая позиция закреплена, сдвиг диапазона шкалы без изменения его протяженности
+     * и длины шкалы не меняет положение значений, поэтому элементы графика не требуют
+     * пересчета, а начало шкалы смещается на minimumPosition().
+     * Возвращает false, если шкала не поддерживает закрепление.
+     */
+    virtual bool setOrigin(double value) { Q_UNUSED(value); return false; }
+    //! Флаг закрепления нулевой позиции шкалы.
+    virtual bool isOriginFixed() const { return false; }
+
+    //! Положение минимального значения шкалы.
+    virtual double minimumPosition() const { return 0.0; }
+
     //! Положение значения \c value.
     virtual double position(double value) const = 0;
     //! Значение на позиции \c position.
@@ -53,11 +70,32 @@ public:
     //! Положение графического элемента \c item.
     virtual double position(const AbstractPlotItem *item) const = 0;
 
+    /*!
+     * \brief Положение элемента от значения \c value_from до значения \c value_to
+     * с размером \c extent вдоль шкалы.
+     *
+     * В отличие от position(const AbstractPlotItem *) не обращается к элементу, поэтому
+     * позволяет рассчитать положение до изменения его размеров, в том числе вне потока GUI.
+     */
+    virtual double position(double value_from, double value_to, double extent) const
+    {
+        Q_UNUSED(value_to);
+        return position(value_from) + extent * 0.5;
+    }
+
     //! Расстояние между значениями \c value_from и \c value_to.
     virtual double distance(double value_from, double value_to) const = 0;
 
     //! Подпись значения на позиции \c position.
     virtual QString label(double position) const = 0;
+
+    /*!
+     * \brief Копия шкалы для расчетов вне потока GUI или 0, если шкала не поддерживает копирование.
+     *
+     * Копия принадлежит вызывающему и не связана с исходной шкалой. Реализации возвращают 0
+     * для наследников, которые не переопределили метод, чтобы не создавать усеченную копию.
+     */
+    virtual AbstractScale *clone() const { return 0; }
 };
 
 } // namespace Graphics
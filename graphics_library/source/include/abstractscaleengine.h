@@ -48,6 +48,14 @@ public:
      * флага положения подписей \c revert.
      */
     virtual void update(const QFontMetrics &font_metrics, const QRectF &scale_rect, bool revert) = 0;
+
+    /*!
+     * \brief Ближайшее к \c value значение засечки шкалы при текущем масштабе.
+     *
+     * Используется для привязки перемещаемых элементов к засечкам. По умолчанию значение
+     * не изменяется.
+     */
+    virtual double snapped(double value) const { return value; }
 };
 
 } // namespace Graphics
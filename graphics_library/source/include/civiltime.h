@@ -0,0 +1,173 @@
+#ifndef GRAPHICS_CIVILTIME_H
+#define GRAPHICS_CIVILTIME_H
+
+/*!
+  * \file civiltime.h
+  * \brief Объявление классов календарной арифметики и таблицы смещений местного времени.
+  *
+  * \file civiltime.cpp
+  * \brief Реализация классов календарной арифметики и таблицы смещений местного времени.
+  */
+
+#include <QString>
+#include <QVector>
+#include "commonprerequisites.h"
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+#include <QTimeZone>
+#endif
+
+namespace Graphics {
+
+/*!
+ * \brief Календарная арифметика над микросекундами от начала эпохи.
+ *
+ * Все методы работают с "настенным" временем без часового пояса: значение - количество
+ * микросекунд от 1970-01-01 00:00:00 по тем же часам. Перевод в UTC и обратно
+ * выполняет UtcOffsetTable. Расчеты не выделяют памяти и не обращаются к базе
+ * часовых поясов (кроме форматирования подписей).
+ */
+class GRAPHICS_EXPORT CivilTime {
+public:
+    //! Количество микросекунд в секунде.
+    static const qint64 usecs_per_second = Q_INT64_C(1000000);
+    //! Количество микросекунд в сутках.
+    static const qint64 usecs_per_day = Q_INT64_C(86400000000);
+
+    //! Составляющие даты и времени.
+    struct Fields {
+        //! Год.
+        int year;
+        //! Месяц (1-12).
+        int month;
+        //! День месяца (1-31).
+        int day;
+        //! Час (0-23).
+        int hour;
+        //! Минута (0-59).
+        int minute;
+        //! Секунда (0-59).
+        int second;
+        //! Микросекунда (0-999999).
+        int usec;
+    };
+
+    //! Деление \c value на \c divisor с округлением вниз.
+    static qint64 floorDiv(qint64 value, qint64 divisor);
+    //! Остаток от деления \c value на \c divisor с округлением частного вниз.
+    static qint64 floorMod(qint64 value, qint64 divisor);
+
+    //! Количество суток от начала эпохи до даты \c year, \c month, \c day.
+    static qint64 daysFromCivil(int year, int month, int day);
+    //! Дата \c year, \c month, \c day через \c days суток от начала эпохи.
+    static void civilFromDays(qint64 days, int *year, int *month, int *day);
+
+    //! Високосность года \c year.
+    static bool isLeapYear(int year);
+    //! Количество дней в месяце \c month года \c year.
+    static int daysInMonth(int year, int month);
+
+    //! Составляющие даты и времени момента \c usecs.
+    static Fields fields(qint64 usecs);
+    //! Момент с составляющими даты и времени \c fields.
+    static qint64 usecs(const Fields &fields);
+
+    //! Начало суток, содержащих момент \c usecs.
+    static qint64 startOfDay(qint64 usecs);
+    //! Сдвиг момента \c usecs на \c months месяцев с ограничением дня длиной месяца.
+    static qint64 addMonths(qint64 usecs, int months);
+    //! Сдвиг момента \c usecs на \c years лет с ограничением дня длиной месяца.
+    static qint64 addYears(qint64 usecs, int years);
+
+    /*!
+     * \brief Представление момента \c usecs в формате \c format.
+     *
+     * Поддерживаются обозначения QDateTime: d, dd, M, MM, MMM, MMMM, yy, yyyy,
+     * h, hh, m, mm, s, ss, z, zzz. Названия месяцев берутся из системной локали.
+     */
+    static QString toString(qint64 usecs, const QString &format);
+};
+
+
+/*!
+ * \brief Таблица смещений местного времени от UTC на интервале моментов.
+ *
+ * Таблица строится один раз для интервала, после чего перевод моментов между UTC и
+ * местным временем сводится к поиску в массиве переходов. За пределами интервала
+ * используются смещения его границ. Таблица строится для системного местного времени
+ * или (начиная с Qt 5.2) для заданного часового пояса.
+ */
+class GRAPHICS_EXPORT UtcOffsetTable {
+public:
+    //! Конструктор пустой таблицы (смещение 0).
+    UtcOffsetTable();
+
+    //! Проверка построения таблицы.
+    bool isValid() const;
+    //! Проверка покрытия таблицей интервала UTC от \c begin_usecs до \c end_usecs.
+    bool covers(qint64 begin_usecs, qint64 end_usecs) const;
+
+    //! Построение таблицы системного местного времени для интервала UTC от \c begin_usecs до \c end_usecs.
+    void buildLocal(qint64 begin_usecs, qint64 end_usecs);
+    /*!
+     * \brief Расширение таблицы системного местного времени до интервала UTC от \c begin_usecs до \c end_usecs.
+     *
+     * Рассчитываются только части интервала за пределами уже покрытого, построенные переходы
+     * сохраняются. Пустая таблица строится заново.
+     */
+    void extendLocal(qint64 begin_usecs, qint64 end_usecs);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    //! Построение таблицы часового пояса \c time_zone для интервала UTC от \c begin_usecs до \c end_usecs.
+    void buildTimeZone(const QTimeZone &time_zone, qint64 begin_usecs, qint64 end_usecs);
+#endif
+    //! Очистка таблицы.
+    void clear();
+
+    //! Смещение местного времени от UTC в микросекундах в момент UTC \c utc_usecs.
+    qint64 offset(qint64 utc_usecs) const;
+
+    //! Перевод момента UTC \c utc_usecs в местное время.
+    qint64 toLocal(qint64 utc_usecs) const;
+    //! Перевод момента местного времени \c local_usecs в UTC (при неоднозначности - более раннее смещение).
+    qint64 toUtc(qint64 local_usecs) const;
+private:
+    //! Переход на новое смещение.
+    struct Transition {
+        //! Момент перехода в UTC.
+        qint64 utc_usecs;
+        //! Смещение после перехода.
+        qint64 offset_usecs;
+    };
+
+    //! Добавление перехода в момент \c utc_usecs на смещение \c offset_usecs.
+    void append(qint64 utc_usecs, qint64 offset_usecs);
+
+    /*!
+     * \brief Построение таблицы для интервала от \c begin_usecs до \c end_usecs по смещениям,
+     * возвращаемым функцией \c offset_function для момента в миллисекундах с контекстом \c context.
+     */
+    void build(qint64 begin_usecs, qint64 end_usecs,
+               qint64 (*offset_function)(qint64 utc_msecs, const void *context), const void *context);
+    //! Расширение таблицы до интервала от \c begin_usecs до \c end_usecs по смещениям функции \c offset_function.
+    void extend(qint64 begin_usecs, qint64 end_usecs,
+                qint64 (*offset_function)(qint64 utc_msecs, const void *context), const void *context);
+    /*!
+     * \brief Поиск переходов на интервале от \c begin_usecs до \c end_usecs с записью в \c result.
+     *
+     * Первый элемент \c result - смещение в начале интервала.
+     */
+    static void scan(qint64 begin_usecs, qint64 end_usecs,
+                     qint64 (*offset_function)(qint64 utc_msecs, const void *context), const void *context,
+                     QVector<Transition> *result);
+
+    //! Начало покрываемого интервала.
+    qint64 range_begin;
+    //! Конец покрываемого интервала.
+    qint64 range_end;
+    //! Переходы, упорядоченные по моменту.
+    QVector<Transition> transitions;
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_CIVILTIME_H
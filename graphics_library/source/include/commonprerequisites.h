@@ -25,13 +25,32 @@ class DateTimeScalePlotItem;
 
 class AbstractPlotLayout;
 class StandardPlotLayout;
+class PackedPlotLayout;
+
+struct PlotItemValues;
+struct PlotItemGeometry;
+struct PlotItemUpdate;
+class PlotItemUpdateQueue;
+class PlotSelectionModel;
 
 class AbstractPlotScene;
 class StandardPlotScene;
+class InfinitePlotScene;
+class TimelinePlotScene;
+
+struct TimelineRecord;
+class TimelineFile;
+class AbstractPlotItemFactory;
+class ScheduleImporter;
+
+class TaskTable;
+class TaskTableItem;
 
 class AbstractPlotView;
 class StandardPlotView;
 
+class PlotStatistics;
+
 } // namespace Graphics
 
 #if _WIN32
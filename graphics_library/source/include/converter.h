@@ -9,19 +9,37 @@
   * \brief Реализация классов адаптеров для конвертации значений шкал.
   */
 
+#include <QtGlobal>
 #include "commonprerequisites.h"
 
 class QDateTime;
 
 namespace Graphics {
 
-//! Адаптер для конвертации дат и времени в числовые значения для шкал.
+/*!
+ * \brief Адаптер для конвертации дат и времени в числовые значения для шкал.
+ *
+ * Значение шкалы - количество секунд от начала эпохи (UTC) с дробной частью.
+ * Точность double сохраняет микросекунды для дат до 2255 года.
+ * Методы для целых миллисекунд и микросекунд не создают QDateTime и
+ * предназначены для массовой конвертации меток времени.
+ */
 class GRAPHICS_EXPORT Converter {
 public:
-    //! Конвертация даты \c val в число.
+    //! Конвертация даты \c val в число с точностью до миллисекунды.
     static double toScale(const QDateTime &val);
-    //! Конвертация числа \c val в дату.
+    //! Конвертация числа \c val в дату с точностью до миллисекунды.
     static QDateTime fromScale(double val);
+
+    //! Конвертация \c msecs миллисекунд от начала эпохи в число.
+    static inline double msecsToScale(qint64 msecs) { return double(msecs) / 1000.0; }
+    //! Конвертация числа \c val в миллисекунды от начала эпохи.
+    static inline qint64 scaleToMSecs(double val) { return qRound64(val * 1000.0); }
+
+    //! Конвертация \c usecs микросекунд от начала эпохи в число.
+    static inline double usecsToScale(qint64 usecs) { return double(usecs) / 1000000.0; }
+    //! Конвертация числа \c val в микросекунды от начала эпохи.
+    static inline qint64 scaleToUSecs(double val) { return qRound64(val * 1000000.0); }
 };
 
 } // namespace Graphics
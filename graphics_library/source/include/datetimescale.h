@@ -37,6 +37,9 @@ public:
     void setFormat(const QString &format);
 
     QString label(double position) const;
+
+    //! Копия шкалы или 0 для наследника, не переопределившего метод.
+    DateTimeScale *clone() const;
 };
 
 } // namespace Graphics
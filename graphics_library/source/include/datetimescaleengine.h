@@ -12,6 +12,10 @@
 #include "commonprerequisites.h"
 #include "abstractscaleengine.h"
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+#include <QTimeZone>
+#endif
+
 namespace Graphics {
 
 class DateTimeScaleEnginePrivate;
@@ -32,6 +36,30 @@ public:
     AbstractScale *scale() const;
     void setScale(AbstractScale *scale);
 
+    /*!
+     * \brief Коэффициент растяжения шкалы при отображении.
+     *
+     * Используется, когда масштабирование выполняется преобразованием виджета, а не сменой
+     * длины шкалы: положения засечек умножаются на коэффициент, а плотность засечек
+     * выбирается по растянутой длине.
+     */
+    double zoomFactor() const;
+    //! Смена коэффициента растяжения шкалы на \c factor.
+    void setZoomFactor(double factor);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    /*!
+     * \brief Часовой пояс, в котором выравниваются засечки и строятся подписи.
+     *
+     * Смещения пояса от UTC рассчитываются один раз для видимого интервала шкалы, поэтому
+     * засечки остаются на границах местных часов и суток и при переходе на летнее время.
+     * Недействительный пояс (по умолчанию) означает системное местное время.
+     */
+    QTimeZone timeZone() const;
+    //! Смена часового пояса засечек и подписей на \c time_zone.
+    void setTimeZone(const QTimeZone &time_zone);
+#endif
+
     QList<double> tickPositions() const;
     QList<double> majorTickPositions() const;
 
@@ -39,6 +67,9 @@ public:
     QList<QRectF> majorTickLabelRectangles() const;
 
     void update(const QFontMetrics &font_metrics, const QRectF &scale_rect, bool revert);
+
+    //! Ближайший к \c value момент засечки интервала разбиения, выбранного для текущего масштаба шкалы.
+    double snapped(double value) const;
 };
 
 } // namespace Graphics
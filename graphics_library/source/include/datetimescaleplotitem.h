@@ -12,6 +12,10 @@
 #include "commonprerequisites.h"
 #include "standardplotitem.h"
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+#include <QTimeZone>
+#endif
+
 namespace Graphics {
 
 class DateTimeScalePlotItemPrivate;
@@ -34,6 +38,9 @@ public:
     double endCoordinateX() const;
     double endCoordinateY() const;
 
+    //! Элемент занимает всю длину шкалы, поэтому зависит от ее диапазона.
+    bool isScaleRangeDependent() const;
+
     //! Флаг размещения подписей над шкалой.
     bool isReverted() const;
     //! Смена флага размещения подписей над шкалой.
@@ -44,6 +51,13 @@ public:
     //! Смена использемой временной шкалы на \c datetime_scale.
     void setDateTimeScale(DateTimeScale *datetime_scale);
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    //! Часовой пояс засечек и подписей (недействительный - системное местное время).
+    QTimeZone timeZone() const;
+    //! Смена часового пояса засечек и подписей на \c time_zone.
+    void setTimeZone(const QTimeZone &time_zone);
+#endif
+
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
 };
 
@@ -16,7 +16,21 @@ namespace Graphics {
 
 class InfinitePlotScenePrivate;
 
-//! Сцена для графика с бесконечной прокруткой по одной из осей.
+/*!
+ * \brief Сцена для графика с бесконечной прокруткой по одной из осей.
+ *
+ * Для графиков реального времени элементы добавляются методом appendPlotItem() в порядке
+ * возрастания конца по оси прокрутки. Такие элементы хранятся в очереди по времени
+ * добавления: элементы, закончившиеся раньше окна хранения retention(), удаляются с ее
+ * начала методом evict(), а при выходе последнего элемента за конец шкалы диапазон шкалы
+ * сдвигается на половину длины, поэтому полный пересчет положения выполняется не чаще
+ * одного раза на половину шкалы.
+ *
+ * Метод populate() может не добавлять элементы сразу, а ставить их в очередь подгрузки
+ * методом queuePlotItem(). Элементы из очереди добавляются на график порциями в цикле
+ * событий так, чтобы каждая порция укладывалась в бюджет времени populationBudget(),
+ * первыми добавляются элементы, ближайшие к центру видимой области.
+ */
 class GRAPHICS_EXPORT InfinitePlotScene : public StandardPlotScene {
     Q_OBJECT
     Q_DECLARE_PRIVATE(InfinitePlotScene)
@@ -37,10 +51,96 @@ public:
 
     void scrollTo(const QRectF &visible_scene_rect, const QPointF &scale_values);
 
+    /*!
+     * \brief Заблаговременный сдвиг диапазона шкалы по направлению прокрутки.
+     *
+     * Если область \c visible_scene_rect за время scrollPredictionTime() при скорости
+     * \c velocity выйдет за границу сцены, диапазон шкалы сдвигается сразу, пока видимая
+     * область остается в новом диапазоне. Подгрузка данных начинается до того, как виджет
+     * отображения дойдет до границы, а элементы из очереди подгрузки добавляются порциями.
+     */
+    void predictScroll(const QRectF &visible_scene_rect, const QPointF &velocity);
+
+    //! Время упреждения прокрутки в миллисекундах.
+    int scrollPredictionTime() const;
+    //! Смена времени упреждения прокрутки на \c msecs (0 - без упреждения).
+    void setScrollPredictionTime(int msecs);
+
+    /*!
+     * \brief Добавление элемента \c item в конец потока элементов реального времени.
+     *
+     * Рассчитывается положение только добавленного элемента. При включенном следовании
+     * диапазон шкалы сдвигается вперед, если элемент заканчивается за ее концом, и
+     * виджетам отображения отправляется сигнал followRequested().
+     */
+    void appendPlotItem(AbstractPlotItem *item);
+
+    //! Окно хранения элементов потока в значениях шкалы (0 - элементы не удаляются).
+    double retention() const;
+    //! Смена окна хранения элементов потока на \c extent.
+    void setRetention(double extent);
+
+    //! Флаг следования графика за последним элементом потока.
+    bool isFollowingHead() const;
+    //! Смена флага следования графика за последним элементом потока на \c on.
+    void setFollowingHead(bool on);
+
+    //! Наибольшее значение конца элементов потока по оси прокрутки.
+    double streamHead() const;
+
+    /*!
+     * \brief Постановка элемента \c item в очередь подгрузки.
+     *
+     * Элемент передается во владение сцене до добавления на график. Элементы, которые к
+     * моменту добавления целиком оказались вне диапазона шкалы прокрутки или попали в
+     * очищаемую область, передаются методу discard().
+     */
+    void queuePlotItem(AbstractPlotItem *item);
+    //! Постановка элементов \c items в очередь подгрузки.
+    void queuePlotItems(const QList<AbstractPlotItem *> &items);
+
+    //! Количество элементов, ожидающих добавления в очереди подгрузки.
+    int pendingPlotItemsCount() const;
+    //! Передача методу discard() всех элементов, ожидающих добавления в очереди подгрузки.
+    void clearPendingPlotItems();
+
+    //! Бюджет времени добавления одной порции элементов из очереди подгрузки в миллисекундах.
+    int populationBudget() const;
+    //! Смена бюджета времени добавления порции элементов на \c msecs.
+    void setPopulationBudget(int msecs);
+
+    void removePlotItem(AbstractPlotItem *item);
+    void removePlotItems(const QList<AbstractPlotItem *> &items);
+
     //! Виртуальный метод очистки области графика от \c begin_value до \c end_value.
     virtual void cleanup(double begin_value, double end_value);
     //! Виртуальный метод подгрузки данных графика в область от \c begin_value до \c end_value.
     virtual void populate(double begin_value, double end_value);
+    /*!
+     * \brief Виртуальный метод удаления элементов потока \c items, вышедших за окно хранения.
+     *
+     * По умолчанию элементы удаляются с графика и уничтожаются.
+     */
+    virtual void evict(const QList<AbstractPlotItem *> &items);
+    /*!
+     * \brief Виртуальный метод уничтожения элементов \c items, исключенных из очереди подгрузки.
+     *
+     * Элементы не добавлены на график. По умолчанию элементы уничтожаются. Деструктор сцены
+     * вызывает только реализацию по умолчанию, поэтому наследник с собственной реализацией
+     * должен вызвать clearPendingPlotItems() в своем деструкторе.
+     */
+    virtual void discard(const QList<AbstractPlotItem *> &items);
+protected:
+    /*!
+     * \brief Приращение масштабирования ZoomTransform в единицах сцены для шкалы \c scale.
+     *
+     * zoomExtent() задает приращение диапазона значений с каждой стороны шкалы,
+     * поэтому переводится в единицы сцены по плотности шкалы.
+     */
+    double transformZoomExtent(const AbstractScale *scale) const;
+private slots:
+    //! Добавление на график порции элементов из очереди подгрузки.
+    void populatePendingItems();
 };
 
 } // namespace Graphics
@@ -58,6 +58,8 @@ public:
 
     //! Отключение стандартных обработчиков событий взаимодействия \с interaction_flags.
     void setSuppressedDefaultEvents(PlotItemInteractionFlags interaction_flags);
+
+    void setPlotScene(AbstractPlotScene *plot_scene);
 protected:
     //! Обработка события вхождения курсора мыши в область элемента в точке \c item_pos.
     virtual void onHoverEnter(const QPointF &item_pos);
@@ -49,14 +49,26 @@ public:
 
     void setRange(double min, double max);
 
+    double origin() const;
+    bool setOrigin(double value);
+    bool isOriginFixed() const;
+    //! Снятие закрепления нулевой позиции шкалы.
+    void resetOrigin();
+
+    double minimumPosition() const;
+
     double position(double value) const;
     double value(double position) const;
 
     double position(const AbstractPlotItem *item) const;
+    double position(double value_from, double value_to, double extent) const;
 
     double distance(double value_from, double value_to) const;
 
     QString label(double position) const;
+
+    //! Копия шкалы или 0 для наследника, не переопределившего метод.
+    NumericScale *clone() const;
 };
 
 } // namespace Graphics
@@ -0,0 +1,86 @@
+#ifndef GRAPHICS_PACKEDPLOTLAYOUT_H
+#define GRAPHICS_PACKEDPLOTLAYOUT_H
+
+/*!
+  * \file packedplotlayout.h
+  * \brief Объявление класса для позиционирования пересекающихся элементов секции по дорожкам.
+  *
+  * \file packedplotlayout.cpp
+  * \brief Реализация класса для позиционирования пересекающихся элементов секции по дорожкам.
+  */
+
+#include "commonprerequisites.h"
+#include "abstractplotlayout.h"
+
+namespace Graphics {
+
+class PackedPlotLayoutPrivate;
+
+/*!
+ * \brief Класс для позиционирования пересекающихся элементов секции по дорожкам.
+ *
+ * Секция элемента определяется его началом по оси, перпендикулярной оси прокрутки сцены
+ * (обычно это оси SectionScale). Элементы одной секции, пересекающиеся по оси прокрутки,
+ * раскладываются по дорожкам одинакового размера: при добавлении элемент занимает дорожку,
+ * освободившуюся раньше всех (или помещается в промежуток этой дорожки), иначе открывает
+ * новую. Дорожки секции упорядочены по концу последнего элемента, а каждая дорожка хранит
+ * элементы, упорядоченные по началу, поэтому добавление и удаление элемента выполняются
+ * за логарифмическое время без перекладки всей секции. Остальные элементы секции
+ * перемещаются только при изменении количества ее дорожек.
+ *
+ * При добавлении элементов в порядке начала раскладка плотная. Элементы, добавленные не по
+ * порядку, и удаление элементов, не сдвигающее оставшиеся, могут оставить дорожки
+ * заполненными неплотно; метод repack() заново раскладывает секции проходом по
+ * началам элементов с наименьшим количеством дорожек.
+ *
+ * Секция с одной дорожкой располагается так же, как в StandardPlotLayout.
+ */
+class GRAPHICS_EXPORT PackedPlotLayout : public AbstractPlotLayout {
+    Q_DISABLE_COPY(PackedPlotLayout)
+    Q_DECLARE_PRIVATE(PackedPlotLayout)
+
+    //! Указатель на реализацию.
+    PackedPlotLayoutPrivate * const d_ptr;
+public:
+    //! Конструктор.
+    PackedPlotLayout();
+    //! Деструктор.
+    ~PackedPlotLayout();
+
+    AbstractPlotScene *plotScene() const;
+    void setPlotScene(AbstractPlotScene *plot_scene);
+
+    //! Промежуток между соседними дорожками секции.
+    double laneSpacing() const;
+    //! Смена промежутка между соседними дорожками секции на \c spacing.
+    void setLaneSpacing(double spacing);
+
+    //! Количество дорожек секции \c section.
+    int lanesCount(uint section) const;
+    //! Номер дорожки элемента \c item (-1 - если элемент не раскладывается по дорожкам).
+    int lane(const AbstractPlotItem *item) const;
+
+    //! Плотная перекладка всех секций с пересчетом позиций элементов.
+    void repack();
+
+    /*!
+     * \brief Виртуальный метод проверки необходимости раскладывать элемент \c item по дорожкам.
+     *
+     * По умолчанию по дорожкам раскладываются элементы, начало и конец которых лежат в
+     * одной секции.
+     */
+    virtual bool isPacked(const AbstractPlotItem *item) const;
+
+    void itemAdded(AbstractPlotItem *item);
+    void itemRemoved(AbstractPlotItem *item);
+    //! Освобождение мест элементов \c items с однократным пересчетом позиций элементов измененных секций.
+    void itemsRemoved(const QList<AbstractPlotItem *> &items);
+
+    void refresh();
+    void refresh(AbstractPlotItem *item);
+    void refresh(const QList<AbstractPlotItem *> &items);
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_PACKEDPLOTLAYOUT_H
@@ -0,0 +1,65 @@
+#ifndef GRAPHICS_PLOTITEMGEOMETRY_H
+#define GRAPHICS_PLOTITEMGEOMETRY_H
+
+/*!
+  * \file plotitemgeometry.h
+  * \brief Объявление структур для расчета геометрии элементов графика отдельно от ее применения.
+  *
+  * \file plotitemgeometry.cpp
+  * \brief Реализация структур для расчета геометрии элементов графика.
+  */
+
+#include "commonprerequisites.h"
+
+namespace Graphics {
+
+/*!
+ * \brief Значения элемента графика, по которым рассчитывается его геометрия.
+ *
+ * Снимок значений позволяет рассчитывать геометрию вне потока GUI, не обращаясь к элементу.
+ */
+struct GRAPHICS_EXPORT PlotItemValues {
+    //! Начало элемента по X.
+    double begin_x;
+    //! Конец элемента по X.
+    double end_x;
+    //! Начало элемента по Y.
+    double begin_y;
+    //! Конец элемента по Y.
+    double end_y;
+    //! Текущая ширина элемента.
+    double width;
+    //! Текущая высота элемента.
+    double height;
+    //! Флаг расчета ширины элемента по шкале.
+    bool is_width_calculated;
+    //! Флаг расчета высоты элемента по шкале.
+    bool is_height_calculated;
+
+    //! Конструктор.
+    PlotItemValues();
+    //! Конструктор снимка значений элемента \c item.
+    explicit PlotItemValues(const AbstractPlotItem *item);
+};
+
+//! Рассчитанная геометрия элемента графика.
+struct GRAPHICS_EXPORT PlotItemGeometry {
+    //! Ширина элемента.
+    double width;
+    //! Высота элемента.
+    double height;
+    //! Положение элемента по X.
+    double x;
+    //! Положение элемента по Y.
+    double y;
+
+    //! Конструктор.
+    PlotItemGeometry();
+
+    //! Применение геометрии к элементу \c item (только в потоке GUI).
+    void applyTo(AbstractPlotItem *item) const;
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_PLOTITEMGEOMETRY_H
@@ -0,0 +1,73 @@
+#ifndef GRAPHICS_PLOTITEMINDEX_H
+#define GRAPHICS_PLOTITEMINDEX_H
+
+/*!
+  * \file plotitemindex.h
+  * \brief Объявление класса индекса элементов графика в пространстве значений шкал.
+  *
+  * \file plotitemindex.cpp
+  * \brief Реализация класса индекса элементов графика в пространстве значений шкал.
+  */
+
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+#include "commonprerequisites.h"
+
+namespace Graphics {
+
+class PlotItemIndexPrivate;
+
+/*!
+ * \brief Индекс элементов графика в пространстве значений шкал.
+ *
+ * Элементы хранятся как интервалы значений вдоль оси прокрутки графика,
+ * отсортированные по началу. При разбиении на строки элементы дополнительно
+ * группируются по целой части значения начала по второй оси (номеру секции).
+ * Индекс не зависит от масштаба, поэтому не перестраивается при масштабировании.
+ */
+class GRAPHICS_EXPORT PlotItemIndex {
+    Q_DISABLE_COPY(PlotItemIndex)
+    Q_DECLARE_PRIVATE(PlotItemIndex)
+
+    //! Указатель на реализацию.
+    PlotItemIndexPrivate * const d_ptr;
+public:
+    //! Конструктор.
+    PlotItemIndex();
+    //! Деструктор.
+    ~PlotItemIndex();
+
+    //! Ориентация оси интервалов элементов.
+    Qt::Orientation orientation() const;
+    //! Смена ориентации оси интервалов элементов на \c orientation.
+    void setOrientation(Qt::Orientation orientation);
+
+    //! Флаг разбиения элементов на строки.
+    bool isRowBucketed() const;
+    //! Смена флага разбиения элементов на строки на \c on.
+    void setRowBucketed(bool on);
+
+    //! Количество элементов в индексе.
+    int count() const;
+    //! Проверка наличия элемента \c item в индексе.
+    bool contains(AbstractPlotItem *item) const;
+
+    //! Очистка индекса.
+    void clear();
+    //! Добавление элемента \c item в индекс.
+    void insert(AbstractPlotItem *item);
+    //! Удаление элемента \c item из индекса.
+    void remove(AbstractPlotItem *item);
+    //! Обновление положения элемента \c item в индексе после смены его координат.
+    void update(AbstractPlotItem *item);
+
+    //! Элементы, интервалы которых содержат значения \c scale_values.
+    QList<AbstractPlotItem *> items(const QPointF &scale_values) const;
+    //! Элементы, интервалы которых пересекают прямоугольник значений \c value_rect.
+    QList<AbstractPlotItem *> items(const QRectF &value_rect) const;
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_PLOTITEMINDEX_H
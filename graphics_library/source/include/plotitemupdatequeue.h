@@ -0,0 +1,119 @@
+#ifndef GRAPHICS_PLOTITEMUPDATEQUEUE_H
+#define GRAPHICS_PLOTITEMUPDATEQUEUE_H
+
+/*!
+  * \file plotitemupdatequeue.h
+  * \brief Объявление очереди изменений элементов графика, заполняемой из любых потоков.
+  *
+  * \file plotitemupdatequeue.cpp
+  * \brief Реализация очереди изменений элементов графика.
+  */
+
+#include <QMap>
+#include <QList>
+#include <QPointF>
+#include <QVariant>
+#include "commonprerequisites.h"
+
+class QObject;
+
+namespace Graphics {
+
+//! Изменение элемента графика, ожидающее применения в потоке GUI.
+struct GRAPHICS_EXPORT PlotItemUpdate {
+    //! Изменяемые свойства элемента.
+    enum Field {
+        //! Координаты начала.
+        BeginCoordinates = 0x01,
+        //! Координаты конца.
+        EndCoordinates = 0x02,
+        //! Z-координата.
+        ZValue = 0x04,
+        //! Видимость.
+        Visibility = 0x08,
+        //! Пользовательские данные (QGraphicsItem::data()), например, параметры оформления.
+        Data = 0x10
+    };
+
+    //! Изменяемый элемент.
+    AbstractPlotItem *item;
+    //! Набор изменяемых свойств (комбинация значений Field).
+    int fields;
+    //! Новые координаты начала.
+    QPointF begin_coordinates;
+    //! Новые координаты конца.
+    QPointF end_coordinates;
+    //! Новая z-координата.
+    qreal z_value;
+    //! Новая видимость.
+    bool is_visible;
+    //! Новые пользовательские данные по ключам.
+    QMap<int, QVariant> data;
+
+    //! Конструктор изменения элемента \c item.
+    explicit PlotItemUpdate(AbstractPlotItem *item = 0);
+
+    //! Наложение более позднего изменения \c other того же элемента.
+    void merge(const PlotItemUpdate &other);
+    //! Проверка изменения координат, требующего пересчета положения элемента.
+    bool changesGeometry() const { return (fields & (BeginCoordinates | EndCoordinates)) != 0; }
+
+    //! Применение изменения к элементу (только в потоке GUI, без пересчета положения).
+    void apply() const;
+};
+
+class PlotItemUpdateQueuePrivate;
+
+/*!
+ * \brief Очередь изменений элементов графика.
+ *
+ * Изменения добавляются из любого числа потоков без блокировок и забираются одним
+ * потоком-получателем методом take(), который объединяет изменения каждого элемента
+ * в одно. При появлении изменений в пустой очереди у получателя один раз вызывается
+ * слот \c member через очередь событий, поэтому частые изменения обрабатываются
+ * пачкой не чаще одного раза за проход цикла событий.
+ *
+ * \code
+ * // в потоке приема данных
+ * scene->updateQueue()->setCoordinates(item, QPointF(begin, row), QPointF(end, row));
+ * \endcode
+ *
+ * Элемент не должен удаляться, пока его изменения находятся в очереди, или получатель
+ * должен проверять принадлежность элемента графику перед применением изменения.
+ */
+class GRAPHICS_EXPORT PlotItemUpdateQueue {
+    Q_DISABLE_COPY(PlotItemUpdateQueue)
+    Q_DECLARE_PRIVATE(PlotItemUpdateQueue)
+
+    //! Указатель на реализацию.
+    PlotItemUpdateQueuePrivate * const d_ptr;
+public:
+    //! Конструктор очереди с уведомлением объекта \c receiver вызовом слота \c member (имя без сигнатуры).
+    explicit PlotItemUpdateQueue(QObject *receiver = 0, const char *member = 0);
+    //! Деструктор.
+    ~PlotItemUpdateQueue();
+
+    //! Изменение координат начала элемента \c item на \c coordinates.
+    void setBeginCoordinates(AbstractPlotItem *item, const QPointF &coordinates);
+    //! Изменение координат конца элемента \c item на \c coordinates.
+    void setEndCoordinates(AbstractPlotItem *item, const QPointF &coordinates);
+    //! Изменение координат начала \c begin и конца \c end элемента \c item.
+    void setCoordinates(AbstractPlotItem *item, const QPointF &begin, const QPointF &end);
+    //! Изменение z-координаты элемента \c item на \c z.
+    void setZValue(AbstractPlotItem *item, qreal z);
+    //! Изменение видимости элемента \c item на \c visible.
+    void setVisible(AbstractPlotItem *item, bool visible);
+    //! Изменение пользовательских данных элемента \c item по ключу \c key на \c value.
+    void setData(AbstractPlotItem *item, int key, const QVariant &value);
+    //! Добавление изменения \c update.
+    void push(const PlotItemUpdate &update);
+
+    //! Проверка отсутствия изменений.
+    bool isEmpty() const;
+    //! Извлечение всех изменений, объединенных по элементам, в порядке первого изменения элемента.
+    QList<PlotItemUpdate> take();
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_PLOTITEMUPDATEQUEUE_H
@@ -0,0 +1,98 @@
+#ifndef GRAPHICS_PLOTSELECTIONMODEL_H
+#define GRAPHICS_PLOTSELECTIONMODEL_H
+
+/*!
+  * \file plotselectionmodel.h
+  * \brief Объявление класса модели выделения элементов графика.
+  *
+  * \file plotselectionmodel.cpp
+  * \brief Реализация класса модели выделения элементов графика.
+  */
+
+#include <QObject>
+#include <QList>
+#include <QRectF>
+#include "commonprerequisites.h"
+
+namespace Graphics {
+
+class PlotSelectionModelPrivate;
+
+/*!
+ * \brief Модель выделения элементов графика.
+ *
+ * Выделение хранится набором элементов самой модели, флаги выделения QGraphicsItem не
+ * используются, поэтому выделение большого количества элементов не вызывает по одному
+ * уведомлению QGraphicsScene на каждый элемент. Элементы выделяются по прямоугольнику
+ * значений через индекс сцены. Каждая операция перерисовывает одну общую область
+ * измененных элементов и отправляет один сигнал selectionChanged().
+ *
+ * Выделяются только элементы InteractivePlotItem с типом взаимодействия InteractionSelect.
+ * Модель используется сценой StandardPlotScene после вызова setSelectionModelEnabled(),
+ * тогда нажатие на элемент сцена передает в модель. Элементы рисуют выделение сами,
+ * проверяя StandardPlotItem::isPlotSelected().
+ */
+class GRAPHICS_EXPORT PlotSelectionModel : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(PlotSelectionModel)
+
+    //! Указатель на реализацию.
+    PlotSelectionModelPrivate * const d_ptr;
+public:
+    //! Способ изменения выделения.
+    enum SelectionCommand {
+        //! Добавление элементов к выделению.
+        Select,
+        //! Снятие выделения с элементов.
+        Deselect,
+        //! Инвертирование выделения элементов.
+        Toggle,
+        //! Замена выделения элементами.
+        ClearAndSelect
+    };
+
+    //! Конструктор модели выделения элементов сцены \c plot_scene.
+    explicit PlotSelectionModel(AbstractPlotScene *plot_scene);
+    //! Деструктор.
+    ~PlotSelectionModel();
+
+    //! Сцена графика.
+    AbstractPlotScene *plotScene() const;
+
+    //! Количество выделенных элементов.
+    int count() const;
+    //! Выделенные элементы.
+    QList<AbstractPlotItem *> selectedItems() const;
+    //! Проверка выделения элемента \c item.
+    bool isSelected(const AbstractPlotItem *item) const;
+
+    //! Проверка возможности выделения элемента \c item.
+    static bool isSelectable(const AbstractPlotItem *item);
+
+    //! Изменение выделения элемента \c item способом \c command.
+    void select(AbstractPlotItem *item, SelectionCommand command);
+    //! Изменение выделения элементов \c items способом \c command.
+    void select(const QList<AbstractPlotItem *> &items, SelectionCommand command);
+    /*!
+     * \brief Изменение выделения элементов в прямоугольнике значений \c value_rect способом \c command.
+     *
+     * При \c exact выделяются только элементы, целиком лежащие в прямоугольнике, иначе -
+     * все пересекающие его.
+     */
+    void select(const QRectF &value_rect, SelectionCommand command, bool exact = false);
+
+    //! Снятие выделения со всех элементов.
+    void clear();
+
+    //! Исключение элемента \c item из выделения без перерисовки (например, при удалении с графика).
+    void forget(const AbstractPlotItem *item);
+    //! Исключение элементов \c items из выделения без перерисовки с одним сигналом selectionChanged().
+    void forget(const QList<AbstractPlotItem *> &items);
+signals:
+    //! Сигнал изменения выделения.
+    void selectionChanged();
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_PLOTSELECTIONMODEL_H
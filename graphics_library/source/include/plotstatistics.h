@@ -0,0 +1,151 @@
+#ifndef GRAPHICS_PLOTSTATISTICS_H
+#define GRAPHICS_PLOTSTATISTICS_H
+
+/*!
+  * \file plotstatistics.h
+  * \brief Объявление класса статистики работы графика.
+  *
+  * \file plotstatistics.cpp
+  * \brief Реализация класса статистики работы графика.
+  */
+
+#include <QElapsedTimer>
+#include "commonprerequisites.h"
+
+namespace Graphics {
+
+/*!
+ * \brief Статистика работы графика: счетчики и суммарное время горячих участков.
+ *
+ * Статистика собирается, только если библиотека собрана с CONFIG+=graphics_statistics
+ * (определен макрос GRAPHICS_STATISTICS); иначе все значения остаются нулевыми,
+ * а макросы учета не генерируют кода.
+ */
+class GRAPHICS_EXPORT PlotStatistics {
+public:
+    //! Счетчик.
+    enum Counter {
+        //! Полные обновления расположения элементов.
+        LayoutRefreshes,
+        //! Элементы, расположение которых пересчитано.
+        ItemsLaidOut,
+        //! Пересчеты засечек движком шкалы.
+        ScaleEngineUpdates,
+        //! Рассчитанные засечки шкалы.
+        TicksGenerated,
+        //! Измеренные подписи засечек шкалы.
+        LabelsMeasured,
+        //! Отрисованные кадры виджета.
+        FramesPainted,
+        //! Отрисованные элементы (учитываются виджетом отображения по перерисованной области, задачи таблицы - самой таблицей).
+        ItemsPainted,
+        //! Вызовы подгрузки данных.
+        PopulateCalls,
+        //! Вызовы очистки данных.
+        CleanupCalls,
+        //! Изменения элементов, примененные из очереди изменений.
+        ItemUpdatesApplied,
+        //! Элементы, добавленные из очереди подгрузки.
+        ItemsPopulated,
+        //! Порции добавления элементов из очереди подгрузки.
+        PopulationSlices,
+        //! Количество счетчиков.
+        CountersCount
+    };
+
+    //! Таймер, суммирующий время участка в наносекундах.
+    enum Timer {
+        //! Полные обновления расположения элементов.
+        LayoutTime,
+        //! Пересчеты засечек движком шкалы.
+        ScaleEngineTime,
+        //! Отрисовка кадров виджета.
+        PaintTime,
+        //! Подгрузка данных.
+        PopulateTime,
+        //! Очистка данных.
+        CleanupTime,
+        //! Количество таймеров.
+        TimersCount
+    };
+
+    //! Суммарная протяженность областей значений шкалы.
+    enum Extent {
+        //! Области подгрузки данных.
+        PopulatedExtent,
+        //! Области очистки данных.
+        CleanedExtent,
+        //! Количество протяженностей.
+        ExtentsCount
+    };
+
+    //! Конструктор.
+    PlotStatistics();
+
+    //! Проверка сборки библиотеки со сбором статистики.
+    static bool isEnabled();
+
+    //! Значение счетчика \c counter.
+    qint64 counter(Counter counter) const;
+    //! Увеличение счетчика \c counter на \c value.
+    void addCounter(Counter counter, qint64 value = 1);
+
+    //! Суммарное время таймера \c timer в наносекундах.
+    qint64 elapsed(Timer timer) const;
+    //! Увеличение времени таймера \c timer на \c nsecs наносекунд.
+    void addElapsed(Timer timer, qint64 nsecs);
+
+    //! Суммарная протяженность \c extent.
+    double extent(Extent extent) const;
+    //! Учет области значений шкалы от \c begin_value до \c end_value в протяженности \c extent.
+    void addExtent(Extent extent, double begin_value, double end_value);
+
+    //! Сброс статистики.
+    void reset();
+private:
+    //! Значения счетчиков.
+    qint64 counters[CountersCount];
+    //! Значения таймеров.
+    qint64 timers[TimersCount];
+    //! Значения протяженностей.
+    double extents[ExtentsCount];
+};
+
+
+//! Замер времени участка кода до конца области видимости с учетом в статистике.
+class GRAPHICS_EXPORT PlotStatisticsTimer {
+    Q_DISABLE_COPY(PlotStatisticsTimer)
+public:
+    //! Конструктор с учетом времени в таймере \c timer статистики \c statistics.
+    PlotStatisticsTimer(PlotStatistics *statistics, PlotStatistics::Timer timer);
+    //! Деструктор, учитывающий прошедшее время.
+    ~PlotStatisticsTimer();
+private:
+    //! Статистика.
+    PlotStatistics *statistics;
+    //! Таймер статистики.
+    PlotStatistics::Timer timer;
+    //! Замер времени.
+    QElapsedTimer elapsed_timer;
+};
+
+} // namespace Graphics
+
+
+#ifdef GRAPHICS_STATISTICS
+//! Увеличение счетчика \c counter статистики \c statistics на \c value.
+#   define GRAPHICS_STATISTICS_COUNT(statistics, counter, value) \
+        (statistics).addCounter(Graphics::PlotStatistics::counter, (value))
+//! Замер времени до конца области видимости в таймере \c timer статистики \c statistics.
+#   define GRAPHICS_STATISTICS_TIMER(statistics, timer) \
+        Graphics::PlotStatisticsTimer graphics_statistics_timer(&(statistics), Graphics::PlotStatistics::timer)
+//! Учет области значений от \c begin_value до \c end_value в протяженности \c extent статистики \c statistics.
+#   define GRAPHICS_STATISTICS_EXTENT(statistics, extent, begin_value, end_value) \
+        (statistics).addExtent(Graphics::PlotStatistics::extent, (begin_value), (end_value))
+#else
+#   define GRAPHICS_STATISTICS_COUNT(statistics, counter, value)
+#   define GRAPHICS_STATISTICS_TIMER(statistics, timer)
+#   define GRAPHICS_STATISTICS_EXTENT(statistics, extent, begin_value, end_value)
+#endif
+
+#endif // GRAPHICS_PLOTSTATISTICS_H
@@ -0,0 +1,182 @@
+#ifndef GRAPHICS_SCALEMAPPER_H
+#define GRAPHICS_SCALEMAPPER_H
+
+/*!
+  * \file scalemapper.h
+  * \brief Объявление классов отображения значений шкал без виртуальных вызовов.
+  *
+  * Отображение создается на время одного пересчета и хранит копию состояния шкалы,
+  * поэтому вызовы position() и distance() раскрываются компилятором на месте.
+  * Пока отображение используется, шкала не должна изменяться.
+  */
+
+#include <cmath>
+#include <QVector>
+#include "commonprerequisites.h"
+#include "abstractscale.h"
+#include "abstractplotitem.h"
+#include "numericscale.h"
+#include "datetimescale.h"
+#include "sectionscale.h"
+
+namespace Graphics {
+
+/*!
+ * \brief Отображение значений шкалы типа \c Scale.
+ *
+ * Общий вариант обращается к шкале через виртуальные методы и подходит для любой шкалы.
+ */
+template <class Scale>
+class ScaleMapper {
+public:
+    //! Конструктор для шкалы \c scale.
+    explicit ScaleMapper(const AbstractScale *scale) : scale(scale) {}
+
+    //! Положение значения \c value.
+    inline double position(double value) const { return scale->position(value); }
+    //! Расстояние между значениями \c value_from и \c value_to.
+    inline double distance(double value_from, double value_to) const { return scale->distance(value_from, value_to); }
+    //! Положение графического элемента \c item.
+    inline double position(const AbstractPlotItem *item) const { return scale->position(item); }
+private:
+    //! Отображаемая шкала.
+    const AbstractScale *scale;
+};
+
+//! Отображение значений линейной шкалы.
+class LinearScaleMapper {
+public:
+    //! Конструктор для шкалы \c scale.
+    explicit LinearScaleMapper(const AbstractScale *scale) :
+        origin(scale->origin()),
+        factor((scale->maximum() != scale->minimum()) ? (scale->length() / (scale->maximum() - scale->minimum()))
+                                                      : 0.0),
+        orientation(scale->orientation())
+    {}
+
+    //! Положение значения \c value.
+    inline double position(double value) const { return (value - origin) * factor; }
+    //! Расстояние между значениями \c value_from и \c value_to.
+    inline double distance(double value_from, double value_to) const { return qAbs((value_to - value_from) * factor); }
+    //! Положение графического элемента \c item.
+    inline double position(const AbstractPlotItem *item) const
+    {
+        return (orientation == Qt::Horizontal) ? (position(item->beginCoordinateX()) + item->width() * 0.5)
+                                               : (position(item->beginCoordinateY()) + item->height() * 0.5);
+    }
+private:
+    //! Значение шкалы в нулевой позиции.
+    double origin;
+    //! Длина единицы значения шкалы.
+    double factor;
+    //! Ориентация шкалы.
+    Qt::Orientation orientation;
+};
+
+//! Отображение значений числовой шкалы.
+template <>
+class ScaleMapper<NumericScale> : public LinearScaleMapper {
+public:
+    //! Конструктор для шкалы \c scale.
+    explicit ScaleMapper(const AbstractScale *scale) : LinearScaleMapper(scale) {}
+};
+
+//! Отображение значений временной шкалы.
+template <>
+class ScaleMapper<DateTimeScale> : public LinearScaleMapper {
+public:
+    //! Конструктор для шкалы \c scale.
+    explicit ScaleMapper(const AbstractScale *scale) : LinearScaleMapper(scale) {}
+};
+
+/*!
+ * \brief Отображение значений дискретной шкалы.
+ *
+ * Положения секций копируются в массив с дополнительным элементом в конце, поэтому
+ * расстояние между секциями считается разностью двух элементов вместо суммирования.
+ */
+template <>
+class ScaleMapper<SectionScale> {
+public:
+    //! Конструктор для шкалы \c scale.
+    explicit ScaleMapper(const AbstractScale *scale) :
+        orientation(scale->orientation())
+    {
+        const SectionScale *section_scale = static_cast<const SectionScale *>(scale);
+        const uint sections_count = section_scale->sectionsCount();
+
+        section_positions.resize(int(sections_count) + 1);
+        section_alignments.resize(int(sections_count));
+
+        double position_offset = 0.0;
+
+        for (uint section = 0; section < sections_count; ++ section) {
+            section_positions[int(section)] = position_offset;
+            section_alignments[int(section)] = section_scale->sectionAlignment(section);
+            position_offset += section_scale->sectionSize(section);
+        }
+
+        section_positions[int(sections_count)] = position_offset;
+    }
+
+    //! Положение значения \c value.
+    inline double position(double value) const
+    {
+        const double section = floor(value);
+        return ((section >= 0.0) && (section < sectionsCount())) ? section_positions.at(int(section)) : 0.0;
+    }
+
+    //! Расстояние между значениями \c value_from и \c value_to.
+    inline double distance(double value_from, double value_to) const
+    {
+        const double first_section = floor(value_from);
+        const double last_section = qMin(floor(value_to), sectionsCount() - 1.0);
+
+        if ((first_section < 0.0) || (first_section > last_section))
+            return 0.0;
+
+        return section_positions.at(int(last_section) + 1) - section_positions.at(int(first_section));
+    }
+
+    //! Положение графического элемента \c item.
+    inline double position(const AbstractPlotItem *item) const
+    {
+        const bool is_horizontal = (orientation == Qt::Horizontal);
+
+        const double section = is_horizontal ? item->beginCoordinateX() : item->beginCoordinateY();
+        const double alignment_offset = (is_horizontal ? item->width() : item->height()) * 0.5;
+        const double section_width = is_horizontal ? distance(item->beginCoordinateX(), item->endCoordinateX())
+                                                   : distance(item->beginCoordinateY(), item->endCoordinateY());
+
+        const double item_position = position(section);
+
+        const uint section_index = uint(section);
+        const SectionScale::SectionAlignment alignment =
+                (section_index < uint(section_alignments.size())) ? section_alignments.at(int(section_index))
+                                                                  : SectionScale::SectionAlignMiddle;
+
+        switch (alignment) {
+            case SectionScale::SectionAlignStart:
+                return item_position + alignment_offset;
+            case SectionScale::SectionAlignEnd:
+                return item_position + section_width - alignment_offset;
+            case SectionScale::SectionAlignMiddle:
+            default:
+                return item_position + section_width * 0.5;
+        }
+    }
+private:
+    //! Количество секций.
+    inline double sectionsCount() const { return double(section_alignments.size()); }
+
+    //! Ориентация шкалы.
+    Qt::Orientation orientation;
+    //! Положения начала секций и конца последней секции.
+    QVector<double> section_positions;
+    //! Выравнивание элементов внутри секций.
+    QVector<SectionScale::SectionAlignment> section_alignments;
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_SCALEMAPPER_H
@@ -0,0 +1,113 @@
+#ifndef GRAPHICS_SCHEDULEIMPORTER_H
+#define GRAPHICS_SCHEDULEIMPORTER_H
+
+/*!
+  * \file scheduleimporter.h
+  * \brief Объявление класса фонового импорта расписания из текстовых файлов.
+  *
+  * \file scheduleimporter.cpp
+  * \brief Реализация класса фонового импорта расписания из текстовых файлов.
+  */
+
+#include <QObject>
+#include <QString>
+#include "commonprerequisites.h"
+
+namespace Graphics {
+
+class ScheduleImporterPrivate;
+
+/*!
+ * \brief Класс фонового импорта расписания из текстовых файлов.
+ *
+ * Файл читается построчно в рабочем потоке. Каждая строка содержит поля section
+ * (номер секции), begin, end и необязательное поле label. Разобранные строки
+ * передаются в поток сцены пачками по batchSize() строк, где из них создаются элементы
+ * фабрикой plotItemFactory() и добавляются на график одним вызовом addPlotItems().
+ * Рабочий поток ждет, пока сцена не разберет очередь, если в ней maximumPendingBatches()
+ * пачек, поэтому память не зависит от размера файла.
+ *
+ * Время задается в формате ISO 8601 (2014-09-30T12:00:00[.zzz][Z|+hh:mm]) или числом
+ * секунд от начала эпохи. Время без смещения считается местным (timeSpec() == Qt::LocalTime)
+ * или UTC и переводится без создания QDateTime.
+ *
+ * CSV может начинаться со строки заголовка с именами полей в любом порядке, иначе
+ * поля идут в порядке section, begin, end, label. Переводы строк внутри полей
+ * в кавычках не поддерживаются. В JSON Lines каждая строка - плоский объект.
+ */
+class GRAPHICS_EXPORT ScheduleImporter : public QObject {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(ScheduleImporter)
+
+    //! Указатель на реализацию.
+    ScheduleImporterPrivate * const d_ptr;
+public:
+    //! Формат файла.
+    enum Format {
+        //! Значения, разделенные запятыми.
+        FormatCsv,
+        //! Объекты JSON по одному в строке.
+        FormatJsonLines
+    };
+
+    //! Конструктор с установкой родительского объекта \c parent.
+    explicit ScheduleImporter(QObject *parent = 0);
+    //! Деструктор.
+    ~ScheduleImporter();
+
+    //! Сцена, в которую добавляются элементы.
+    AbstractPlotScene *plotScene() const;
+    //! Смена сцены на \c plot_scene.
+    void setPlotScene(AbstractPlotScene *plot_scene);
+
+    //! Фабрика элементов графика.
+    AbstractPlotItemFactory *plotItemFactory() const;
+    //! Смена фабрики элементов графика на \c factory (фабрика передается во владение импорту).
+    void setPlotItemFactory(AbstractPlotItemFactory *factory);
+
+    //! Количество строк в пачке.
+    int batchSize() const;
+    //! Смена количества строк в пачке на \c size.
+    void setBatchSize(int size);
+
+    //! Наибольшее количество пачек, ожидающих добавления на график.
+    int maximumPendingBatches() const;
+    //! Смена наибольшего количества ожидающих пачек на \c count.
+    void setMaximumPendingBatches(int count);
+
+    //! Разделитель полей CSV.
+    char csvSeparator() const;
+    //! Смена разделителя полей CSV на \c separator.
+    void setCsvSeparator(char separator);
+
+    //! Трактовка времени без смещения (Qt::LocalTime или Qt::UTC).
+    Qt::TimeSpec timeSpec() const;
+    //! Смена трактовки времени без смещения на \c spec.
+    void setTimeSpec(Qt::TimeSpec spec);
+
+    //! Проверка выполнения импорта.
+    bool isRunning() const;
+    //! Количество строк, добавленных на график текущим или последним импортом.
+    qint64 importedCount() const;
+    //! Количество пропущенных строк с ошибками разбора.
+    qint64 skippedCount() const;
+    //! Описание ошибки последнего импорта.
+    QString errorString() const;
+
+    //! Запуск импорта файла \c file_name в формате \c format (прерывает текущий импорт).
+    void start(const QString &file_name, Format format);
+    //! Прерывание импорта с ожиданием остановки рабочего потока.
+    void cancel();
+signals:
+    //! Сигнал добавления пачки элементов: прочитано \c bytes_read байт из \c bytes_total.
+    void progress(qint64 bytes_read, qint64 bytes_total);
+    //! Сигнал завершения импорта (\c success - без ошибок чтения файла).
+    void finished(bool success);
+private slots:
+    //! Добавление на график пачек, подготовленных рабочим потоком.
+    void processBatches();
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_SCHEDULEIMPORTER_H
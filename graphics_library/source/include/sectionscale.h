@@ -61,14 +61,23 @@ public:
     //! Установка расчитываемого размера для секции \c section.
     void setSectionSizeAdjusted(uint section);
 
+    //! Положение начала секции \c section.
+    double sectionPosition(uint section) const;
+    //! Размер секции \c section.
+    double sectionSize(uint section) const;
+
     double position(double value) const;
     double value(double position) const;
 
     double position(const AbstractPlotItem *item) const;
+    double position(double value_from, double value_to, double extent) const;
 
     double distance(double value_from, double value_to) const;
 
     QString label(double position) const;
+
+    //! Копия шкалы или 0 для наследника, не переопределившего метод.
+    SectionScale *clone() const;
 };
 
 } // namespace Graphics
@@ -26,6 +26,15 @@ class GRAPHICS_EXPORT StandardPlotItem : public AbstractPlotItem {
 protected:
     //! Конструктор.
     StandardPlotItem();
+
+    /*!
+     * \brief Вывод текста \c text с флагами выравнивания \c flags в прямоугольнике \c rect элемента.
+     *
+     * Растяжение, которое задает преобразование виджета при масштабировании ZoomTransform,
+     * для текста отменяется: текст выводится в растянутом прямоугольнике в обычном размере.
+     * Элементы с подписями должны выводить их этим методом.
+     */
+    static void drawText(QPainter *painter, const QRectF &rect, int flags, const QString &text);
 public:
     //! Деструктор.
     virtual ~StandardPlotItem();
@@ -69,6 +78,15 @@ public:
     AbstractPlotScene *plotScene() const;
     void setPlotScene(AbstractPlotScene *plot_scene);
 
+    /*!
+     * \brief Флаг выделения элемента.
+     *
+     * Если у сцены графика есть модель выделения, флаг берется из нее, иначе совпадает
+     * с QGraphicsItem::isSelected(). Элементы, которые должны рисовать выделение и при
+     * выделении моделью, проверяют этот флаг, а не состояние QStyle::State_Selected.
+     */
+    bool isPlotSelected() const;
+
     QRectF boundingRect() const;
 };
 
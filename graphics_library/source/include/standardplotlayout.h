@@ -32,8 +32,30 @@ public:
     AbstractPlotScene *plotScene() const;
     void setPlotScene(AbstractPlotScene *plot_scene);
 
+    /*!
+     * \brief Флаг расчета геометрии элементов в рабочих потоках.
+     *
+     * Размеры и положения элементов рассчитываются параллельно через QtConcurrent,
+     * после чего применяются к элементам в потоке GUI одним проходом. Методы координат
+     * элементов и методы шкал при этом вызываются из рабочих потоков и не должны
+     * изменять состояние. Наследники пересчитывают элементы по одному методом
+     * refresh(AbstractPlotItem*), и флаг на них не действует.
+     */
+    bool isConcurrent() const;
+    //! Смена флага расчета геометрии элементов в рабочих потоках на \c on.
+    void setConcurrent(bool on);
+
+    //! Минимальное количество пересчитываемых элементов для расчета в рабочих потоках.
+    int concurrentThreshold() const;
+    //! Смена минимального количества элементов для расчета в рабочих потоках на \c count.
+    void setConcurrentThreshold(int count);
+
     void refresh();
     void refresh(AbstractPlotItem *item);
+    void refresh(const QList<AbstractPlotItem *> &items);
+
+    //! Флаг возможности расчета геометрии вне потока GUI (только для самого StandardPlotLayout, не для наследников).
+    bool isGeometryReentrant() const;
 };
 
 } // namespace Graphics
@@ -0,0 +1,133 @@
+#ifndef GRAPHICS_STANDARDPLOTLAYOUTT_H
+#define GRAPHICS_STANDARDPLOTLAYOUTT_H
+
+/*!
+  * \file standardplotlayoutt.h
+  * \brief Объявление шаблона класса для позиционирования объектов на графике с известными типами шкал.
+  */
+
+#include <typeinfo>
+#include "commonprerequisites.h"
+#include "abstractplotlayout.h"
+#include "abstractplotscene.h"
+#include "plotstatistics.h"
+#include "scalemapper.h"
+
+namespace Graphics {
+
+/*!
+ * \brief Шаблон класса для позиционирования объектов на графике с шкалами типов \c XScale и \c YScale.
+ *
+ * Размещает элементы так же, как StandardPlotLayout, но обращается к шкалам через
+ * ScaleMapper, поэтому расчет положений не требует виртуальных вызовов. Если тип шкалы
+ * сцены не совпадает с параметром шаблона, используются виртуальные методы шкалы.
+ *
+ * \code
+ * scene->setLayout(new StandardPlotLayoutT<DateTimeScale, SectionScale>());
+ * \endcode
+ */
+template <class XScale, class YScale>
+class StandardPlotLayoutT : public AbstractPlotLayout {
+    Q_DISABLE_COPY(StandardPlotLayoutT)
+
+    //! Графическая сцена.
+    AbstractPlotScene *plot_scene;
+public:
+    //! Конструктор.
+    StandardPlotLayoutT() : AbstractPlotLayout(), plot_scene(0) {}
+    //! Деструктор.
+    ~StandardPlotLayoutT() {}
+
+    AbstractPlotScene *plotScene() const { return plot_scene; }
+    void setPlotScene(AbstractPlotScene *scene) { plot_scene = scene; }
+
+    void refresh()
+    {
+        if (!hasScales())
+            return;
+
+        GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), LayoutRefreshes, 1);
+        GRAPHICS_STATISTICS_TIMER(plot_scene->statistics(), LayoutTime);
+
+        const AbstractScale *x_scale = plot_scene->xScale();
+        const AbstractScale *y_scale = plot_scene->yScale();
+
+        plot_scene->setSceneRect(x_scale->minimumPosition(), y_scale->minimumPosition(),
+                                 x_scale->length(), y_scale->length());
+
+        const QList<AbstractPlotItem *> items = plot_scene->plotItems();
+
+        if (isExactType<XScale>(plot_scene->xScale()) && isExactType<YScale>(plot_scene->yScale()))
+            layoutItems(items, ScaleMapper<XScale>(plot_scene->xScale()), ScaleMapper<YScale>(plot_scene->yScale()));
+        else
+            layoutItems(items, ScaleMapper<AbstractScale>(plot_scene->xScale()), ScaleMapper<AbstractScale>(plot_scene->yScale()));
+    }
+
+    void refresh(AbstractPlotItem *item)
+    {
+        if (!hasScales() || (item == 0))
+            return;
+
+        // для одного элемента копирование состояния шкал дороже виртуальных вызовов
+        layoutItem(item, ScaleMapper<AbstractScale>(plot_scene->xScale()), ScaleMapper<AbstractScale>(plot_scene->yScale()));
+
+        GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), ItemsLaidOut, 1);
+    }
+
+    void refresh(const QList<AbstractPlotItem *> &items)
+    {
+        if (!hasScales())
+            return;
+
+        GRAPHICS_STATISTICS_TIMER(plot_scene->statistics(), LayoutTime);
+
+        if (isExactType<XScale>(plot_scene->xScale()) && isExactType<YScale>(plot_scene->yScale()))
+            layoutItems(items, ScaleMapper<XScale>(plot_scene->xScale()), ScaleMapper<YScale>(plot_scene->yScale()));
+        else
+            layoutItems(items, ScaleMapper<AbstractScale>(plot_scene->xScale()), ScaleMapper<AbstractScale>(plot_scene->yScale()));
+    }
+private:
+    //! Проверка наличия сцены и обеих шкал.
+    bool hasScales() const
+    {
+        return (plot_scene != 0) && (plot_scene->xScale() != 0) && (plot_scene->yScale() != 0);
+    }
+
+    //! Проверка точного совпадения типа шкалы \c scale с \c Scale.
+    template <class Scale>
+    static bool isExactType(const AbstractScale *scale)
+    {
+        return typeid(*scale) == typeid(Scale);
+    }
+
+    //! Пересчет позиции элемента \c item с отображениями шкал \c x_mapper и \c y_mapper.
+    template <class XMapper, class YMapper>
+    static void layoutItem(AbstractPlotItem *item, const XMapper &x_mapper, const YMapper &y_mapper)
+    {
+        if (item->isWidthCalculated())
+            item->setWidth(x_mapper.distance(item->beginCoordinateX(), item->endCoordinateX()));
+
+        if (item->isHeightCalculated())
+            item->setHeight(y_mapper.distance(item->beginCoordinateY(), item->endCoordinateY()));
+
+        item->setPos(x_mapper.position(item), y_mapper.position(item));
+
+        item->update();
+    }
+
+    //! Пересчет позиций элементов \c items с отображениями шкал \c x_mapper и \c y_mapper.
+    template <class XMapper, class YMapper>
+    void layoutItems(const QList<AbstractPlotItem *> &items, const XMapper &x_mapper, const YMapper &y_mapper)
+    {
+        foreach (AbstractPlotItem *item, items) {
+            if (item != 0)
+                layoutItem(item, x_mapper, y_mapper);
+        }
+
+        GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), ItemsLaidOut, items.size());
+    }
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_STANDARDPLOTLAYOUTT_H
@@ -20,7 +20,17 @@ class StandardPlotScenePrivate;
 class GRAPHICS_EXPORT StandardPlotScene : public AbstractPlotScene {
     Q_OBJECT
     Q_DECLARE_PRIVATE(StandardPlotScene)
-
+public:
+    //! Способ индексации элементов графика.
+    enum PlotIndexMethod {
+        //! BSP-дерево QGraphicsScene в координатах сцены.
+        PlotIndexBspTree,
+        //! Без индекса сцены, поиск элементов по индексу значений.
+        PlotIndexNone,
+        //! Без индекса сцены, поиск элементов по индексу значений, разбитому на строки секций.
+        PlotIndexRows
+    };
+private:
     //! Указатель на реализацию.
     StandardPlotScenePrivate * const d_ptr;
 public:
@@ -41,13 +51,46 @@ public:
     Qt::Orientation sceneOrientation() const;
     void setSceneOrientation(Qt::Orientation orientation);
 
+    ZoomMode zoomMode() const;
+    void setZoomMode(ZoomMode mode);
+
+    QTransform zoomTransform() const;
+
     double zoomExtent() const;
     void setZoomExtent(double extent);
 
+    //! Способ индексации элементов графика.
+    PlotIndexMethod plotIndexMethod() const;
+    //! Смена способа индексации элементов графика на \c method.
+    void setPlotIndexMethod(PlotIndexMethod method);
+
+    //! Глубина BSP-дерева при индексации \c PlotIndexBspTree (0 - автоматический выбор).
+    int plotIndexBspDepth() const;
+    //! Смена глубины BSP-дерева на \c depth.
+    void setPlotIndexBspDepth(int depth);
+
     void addPlotItem(AbstractPlotItem *item);
     void removePlotItem(AbstractPlotItem *item);
 
+    /*!
+     * \brief Добавление элементов \c items на график с расчетом их положения.
+     *
+     * Если пакет составляет не меньше четверти элементов графика, индекс сцены на время
+     * добавления отключается и строится заново один раз, иначе обновляется по элементу.
+     * Положение добавленных элементов рассчитывается одним проходом объекта позиционирования.
+     * Уже добавленные и повторяющиеся элементы пропускаются.
+     */
+    void addPlotItems(const QList<AbstractPlotItem *> &items);
+    /*!
+     * \brief Удаление элементов \c items с графика.
+     *
+     * Индекс сцены перестраивается один раз по тому же правилу, что и при добавлении.
+     */
+    void removePlotItems(const QList<AbstractPlotItem *> &items);
+
     QList<AbstractPlotItem *> plotItems() const;
+    //! Элементы графика, координаты которых зависят от диапазона шкал (AbstractPlotItem::isScaleRangeDependent()).
+    QList<AbstractPlotItem *> rangeDependentPlotItems() const;
     QList<AbstractPlotItem *> plotItems(const QPointF &scale_values, bool exact = true) const;
     QList<AbstractPlotItem *> plotItems(const QRectF &value_rect, bool exact = true) const;
 
@@ -67,8 +110,112 @@ public:
     int maximumZoomStep() const;
     void setMaximumZoomStep(int step);
 
+    const PlotStatistics &statistics() const;
+    PlotStatistics &statistics();
+    void resetStatistics();
+
     QPointF mapToScales(const QPointF &scene_pos) const;
     QPointF mapFromScales(const QPointF &scale_values) const;
+
+    /*!
+     * \brief Очередь изменений элементов графика.
+     *
+     * Изменения можно добавлять из любых потоков. Они применяются в потоке сцены один раз
+     * за проход цикла событий: изменения одного элемента объединяются, положение всех
+     * измененных элементов пересчитывается одним вызовом объекта позиционирования.
+     * Изменения элементов, удаленных с графика до применения, пропускаются.
+     */
+    PlotItemUpdateQueue *updateQueue() const;
+
+    bool isHoverResolved() const;
+    /*!
+     * \brief Смена флага поиска элемента под курсором мыши сценой на \c on.
+     *
+     * Элемент под курсором ищется по индексу значений среди элементов с типом
+     * взаимодействия InteractionHover, последний найденный элемент проверяется первым.
+     * Элементам отправляются обычные события наведения курсора, поэтому обработчики
+     * InteractivePlotItem и методы plotItemHover*() сцены вызываются как прежде.
+     * Прием событий наведения уже добавленными элементами меняется вместе с флагом.
+     * QGraphicsScene не перестает рассылать события наведения, если их хотя бы раз
+     * принял один из элементов, поэтому флаг выгоднее устанавливать до добавления элементов.
+     */
+    void setHoverResolved(bool on);
+
+    //! Элемент под курсором мыши при поиске элемента сценой (0 - если курсор вне элементов).
+    AbstractPlotItem *hoveredPlotItem() const;
+
+    /*!
+     * \brief Модель выделения элементов графика (0 - если выделение моделью выключено).
+     *
+     * Элементы исключаются из выделения при удалении с графика.
+     */
+    PlotSelectionModel *selectionModel() const;
+
+    //! Флаг выделения элементов моделью выделения.
+    bool isSelectionModelEnabled() const;
+    /*!
+     * \brief Смена флага выделения элементов моделью выделения на \c on.
+     *
+     * По умолчанию флаг сброшен и элементы выделяются флагами QGraphicsItem, как обычно
+     * в QGraphicsScene. При установке флага выделение хранится в selectionModel(),
+     * нажатия на элементы передаются в модель, а флаг ItemIsSelectable элементов снимается.
+     * Текущее выделение при смене флага сбрасывается.
+     */
+    void setSelectionModelEnabled(bool on);
+
+    //! Пометка элемента \c item для обновления в индексе значений при следующем запросе.
+    void plotItemCoordinatesChanged(AbstractPlotItem *item);
+
+    bool isValueMoveEnabled() const;
+    /*!
+     * \brief Смена флага перемещения элементов сценой в значениях шкал на \c on.
+     *
+     * Левой кнопкой мыши перетаскивается верхний элемент с типом взаимодействия
+     * InteractionMove, а если он выделен в модели выделения - все выделенные перемещаемые
+     * элементы. Смещение курсора переводится в значения шкал: вдоль оси прокрутки начало
+     * перетаскиваемого элемента привязывается к засечкам snapEngine(), по дискретной шкале
+     * элементы смещаются на целые секции. При движении мыши пересчитывается положение только
+     * перетаскиваемых элементов, индекс значений обновляется один раз при отпускании кнопки,
+     * после чего вызывается plotItemsMoved(). Нажатие левой кнопки на перемещаемом элементе
+     * начинает перетаскивание и не передается элементу.
+     */
+    void setValueMoveEnabled(bool on);
+
+    //! Движок шкалы, к засечкам которого привязываются перемещаемые элементы (0 - без привязки).
+    AbstractScaleEngine *snapEngine() const;
+    //! Смена движка шкалы для привязки перемещаемых элементов на \c engine (движок не передается во владение).
+    void setSnapEngine(AbstractScaleEngine *engine);
+protected:
+    //! Обработка события \c event сцены.
+    bool event(QEvent *event);
+    //! Обработка события \c event нажатия кнопки мыши.
+    void mousePressEvent(QGraphicsSceneMouseEvent *event);
+    //! Обработка события \c event перемещения курсора мыши.
+    void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
+    //! Обработка события \c event отпускания кнопки мыши.
+    void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
+
+    /*!
+     * \brief Пересчет положения элементов в фоновом потоке по копиям шкал.
+     *
+     * Незавершенный пересчет отменяется следующим вызовом или вызовом refresh().
+     * Если шкалы не поддерживают копирование или объект позиционирования не позволяет
+     * рассчитывать геометрию вне потока GUI, выполняется обычный refresh().
+     */
+    void refreshDeferred();
+
+    /*!
+     * \brief Приращение масштабирования ZoomTransform в единицах сцены для шкалы \c scale.
+     *
+     * Вызывается в начале масштабирования преобразованием. По умолчанию zoomExtent()
+     * задает приращение длины шкалы и возвращается без изменений.
+     */
+    virtual double transformZoomExtent(const AbstractScale *scale) const;
+private slots:
+    //! Применение геометрии, рассчитанной фоновым пересчетом с номером \c generation.
+    void applyDeferredLayout(int generation);
+    //! Применение накопленных изменений из очереди изменений элементов.
+    void processPlotItemUpdates();
 };
 
 } // namespace Graphics
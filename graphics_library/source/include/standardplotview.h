@@ -47,6 +47,45 @@ public:
     //! Смена клавиши-модификатора для масштабирования на \c modifier.
     void setZoomKeyboardModifier(Qt::KeyboardModifier modifier);
 
+    /*!
+     * \brief Флаг выделения элементов рамкой.
+     *
+     * Рамка растягивается левой кнопкой мыши с зажатой клавишей selectionKeyboardModifier(),
+     * после отпускания кнопки элементы в рамке выделяются моделью выделения сцены
+     * (с зажатой клавишей Ctrl выделение элементов в рамке инвертируется).
+     * Рамка работает, только если у сцены есть модель выделения
+     * (см. StandardPlotScene::setSelectionModelEnabled()).
+     */
+    bool isRubberBandSelectionEnabled() const;
+    //! Смена флага выделения элементов рамкой на \c on.
+    void setRubberBandSelectionEnabled(bool on);
+
+    //! Клавиша-модификатор для выделения элементов рамкой.
+    Qt::KeyboardModifier selectionKeyboardModifier() const;
+    //! Смена клавиши-модификатора для выделения элементов рамкой на \c modifier.
+    void setSelectionKeyboardModifier(Qt::KeyboardModifier modifier);
+
+    /*!
+     * \brief Флаг прокрутки графика перетаскиванием с инерцией.
+     *
+     * Левой кнопкой мыши (или касанием, преобразованным в события мыши) график перетаскивается
+     * вдоль оси прокрутки, если нажатие не принял элемент или сцена. После отпускания график
+     * продолжает движение с затухающей скоростью. Во время движения сцене сообщается скорость
+     * прокрутки методом AbstractPlotScene::predictScroll(), кадры инерции отрисовываются по
+     * таймеру без ожидания подгрузки данных.
+     */
+    bool isKineticScrollEnabled() const;
+    //! Смена флага прокрутки графика перетаскиванием с инерцией на \c on.
+    void setKineticScrollEnabled(bool on);
+
+    //! Время затухания скорости инерционной прокрутки в e раз в миллисекундах.
+    int kineticDecayTime() const;
+    //! Смена времени затухания скорости инерционной прокрутки на \c msecs.
+    void setKineticDecayTime(int msecs);
+
+    //! Остановка инерционной прокрутки.
+    void stopKineticScroll();
+
     //! Прокрутка графика на \c steps_count шагов.
     void scrollPlot(int steps_count);
     //! Увеличение масштаба графика.
@@ -55,11 +94,26 @@ public:
     void zoomOut();
 
     void scrollTo(const QPointF &scale_values);
+private slots:
+    //! Применение преобразования масштабирования, измененного сценой.
+    void updateZoomTransform();
+    //! Прокрутка виджета вдоль оси прокрутки до показа значений шкал \c scale_values.
+    void followScaleValues(const QPointF &scale_values);
+    //! Кадр инерционной прокрутки.
+    void kineticScrollStep();
 protected:
     //! Обработка события \c event отображения виджета графика.
     void showEvent(QShowEvent *event);
     //! Обработка события \c event прокрутки колеса мыши.
     void wheelEvent(QWheelEvent *event);
+    //! Обработка события \c event отрисовки виджета графика.
+    void paintEvent(QPaintEvent *event);
+    //! Обработка события \c event нажатия кнопки мыши.
+    void mousePressEvent(QMouseEvent *event);
+    //! Обработка события \c event перемещения курсора мыши.
+    void mouseMoveEvent(QMouseEvent *event);
+    //! Обработка события \c event отпускания кнопки мыши.
+    void mouseReleaseEvent(QMouseEvent *event);
 };
 
 } // namespace Graphics
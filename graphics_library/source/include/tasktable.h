@@ -0,0 +1,79 @@
+#ifndef GRAPHICS_TASKTABLE_H
+#define GRAPHICS_TASKTABLE_H
+
+/*!
+  * \file tasktable.h
+  * \brief Объявление класса таблицы задач, хранящей значения без графических элементов.
+  *
+  * \file tasktable.cpp
+  * \brief Реализация класса таблицы задач.
+  */
+
+#include <QVector>
+#include "commonprerequisites.h"
+
+namespace Graphics {
+
+class TaskTablePrivate;
+
+/*!
+ * \brief Таблица задач, хранящая значения без графических элементов.
+ *
+ * Каждое поле задачи (секция, начало, конец, стиль и идентификатор) хранится в отдельном
+ * плоском массиве, задача адресуется номером строки. Для поиска задачи каждой секции
+ * упорядочиваются по началу; индекс строится при первом запросе после изменения таблицы.
+ * Запросы к таблице из нескольких потоков без изменений допустимы только после
+ * построения индекса методом buildIndex().
+ */
+class GRAPHICS_EXPORT TaskTable {
+    Q_DISABLE_COPY(TaskTable)
+    Q_DECLARE_PRIVATE(TaskTable)
+
+    //! Указатель на реализацию.
+    TaskTablePrivate * const d_ptr;
+public:
+    //! Конструктор.
+    TaskTable();
+    //! Деструктор.
+    ~TaskTable();
+
+    //! Количество задач.
+    int count() const;
+    //! Резервирование памяти под \c count задач.
+    void reserve(int count);
+    //! Удаление всех задач.
+    void clear();
+
+    //! Добавление задачи с секцией \c section от \c begin_value до \c end_value, возвращает номер строки.
+    int append(uint section, double begin_value, double end_value, quint32 style = 0, quint64 id = 0);
+    //! Смена интервала задачи \c row на интервал от \c begin_value до \c end_value.
+    void setInterval(int row, double begin_value, double end_value);
+    //! Смена секции задачи \c row на \c section.
+    void setSection(int row, uint section);
+    //! Смена стиля задачи \c row на \c style.
+    void setStyle(int row, quint32 style);
+
+    //! Секция задачи \c row.
+    uint section(int row) const;
+    //! Начало задачи \c row.
+    double beginValue(int row) const;
+    //! Конец задачи \c row.
+    double endValue(int row) const;
+    //! Стиль задачи \c row.
+    quint32 style(int row) const;
+    //! Идентификатор задачи \c row в приложении.
+    quint64 id(int row) const;
+
+    //! Количество секций (наибольший номер секции задач + 1).
+    uint sectionsCount() const;
+
+    //! Построение индекса задач, если таблица изменилась.
+    void buildIndex() const;
+
+    //! Номера строк задач секций от \c first_section до \c last_section, пересекающих интервал от \c begin_value до \c end_value.
+    QVector<int> find(double begin_value, double end_value, uint first_section, uint last_section) const;
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_TASKTABLE_H
@@ -0,0 +1,99 @@
+#ifndef GRAPHICS_TASKTABLEITEM_H
+#define GRAPHICS_TASKTABLEITEM_H
+
+/*!
+  * \file tasktableitem.h
+  * \brief Объявление класса графического элемента, отрисовывающего таблицу задач.
+  *
+  * \file tasktableitem.cpp
+  * \brief Реализация класса графического элемента, отрисовывающего таблицу задач.
+  */
+
+#include <QBrush>
+#include <QPen>
+#include <QVector>
+#include <QGraphicsObject>
+#include "commonprerequisites.h"
+
+namespace Graphics {
+
+class TaskTableItemPrivate;
+
+/*!
+ * \brief Графический элемент, отрисовывающий таблицу задач.
+ *
+ * Один элемент занимает всю сцену и рисует задачи таблицы, попавшие в обновляемую
+ * область, по шкалам сцены: начало и конец задачи откладываются вдоль оси прокрутки,
+ * секция - вдоль второй оси. Отдельные графические элементы создаются фабрикой только
+ * для задач, с которыми работает пользователь: при наведении курсора (если включено
+ * setHoverMaterialized()) или вызовом materialize(). Пока у задачи есть элемент,
+ * таблица ее не рисует.
+ *
+ * Геометрия обновляется по сигналу сцены AbstractPlotScene::layoutChanged(), после
+ * изменения таблицы нужно вызвать refresh(). Созданные элементы принадлежат этому
+ * элементу (являются его дочерними элементами) и не синхронизируются с таблицей.
+ */
+class GRAPHICS_EXPORT TaskTableItem : public QGraphicsObject {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(TaskTableItem)
+
+    //! Указатель на реализацию.
+    TaskTableItemPrivate * const d_ptr;
+public:
+    //! Конструктор с добавлением на сцену \c plot_scene элемента для таблицы \c table (таблица не передается во владение).
+    TaskTableItem(TaskTable *table, AbstractPlotScene *plot_scene);
+    //! Деструктор.
+    ~TaskTableItem();
+
+    //! Таблица задач.
+    TaskTable *taskTable() const;
+    //! Сцена графика.
+    AbstractPlotScene *plotScene() const;
+
+    //! Фабрика элементов для задач.
+    AbstractPlotItemFactory *plotItemFactory() const;
+    //! Смена фабрики элементов на \c factory (фабрика передается во владение элементу).
+    void setPlotItemFactory(AbstractPlotItemFactory *factory);
+
+    //! Кисть задач стиля \c style.
+    QBrush styleBrush(quint32 style) const;
+    //! Смена кисти задач стиля \c style на \c brush.
+    void setStyleBrush(quint32 style, const QBrush &brush);
+
+    //! Перо задач стиля \c style.
+    QPen stylePen(quint32 style) const;
+    //! Смена пера задач стиля \c style на \c pen.
+    void setStylePen(quint32 style, const QPen &pen);
+
+    //! Флаг создания элемента для задачи под курсором.
+    bool isHoverMaterialized() const;
+    //! Смена флага создания элемента для задачи под курсором на \c on.
+    void setHoverMaterialized(bool on);
+
+    //! Номер строки верхней задачи в точке сцены \c scene_pos (-1 - если задачи нет).
+    int taskAt(const QPointF &scene_pos) const;
+    //! Номера строк задач, пересекающих прямоугольник сцены \c scene_rect.
+    QVector<int> tasks(const QRectF &scene_rect) const;
+    //! Прямоугольник задачи \c row в координатах сцены.
+    QRectF taskRect(int row) const;
+
+    //! Создание элемента для задачи \c row, который остается до вызова release().
+    AbstractPlotItem *materialize(int row);
+    //! Удаление элемента задачи \c row.
+    void release(int row);
+    //! Элемент задачи \c row (0 - если не создан).
+    AbstractPlotItem *materializedItem(int row) const;
+
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = 0);
+public slots:
+    //! Обновление геометрии после пересчета положения элементов сцены или изменения таблицы.
+    void refresh();
+protected:
+    //! Обработка события \c event перемещения курсора над элементом.
+    void hoverMoveEvent(QGraphicsSceneHoverEvent *event);
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_TASKTABLEITEM_H
@@ -0,0 +1,101 @@
+#ifndef GRAPHICS_TIMELINEFILE_H
+#define GRAPHICS_TIMELINEFILE_H
+
+/*!
+  * \file timelinefile.h
+  * \brief Объявление класса файла расписания с доступом через отображение в память.
+  *
+  * \file timelinefile.cpp
+  * \brief Реализация класса файла расписания.
+  */
+
+#include <QString>
+#include <QVector>
+#include "commonprerequisites.h"
+
+namespace Graphics {
+
+/*!
+ * \brief Запись файла расписания.
+ *
+ * Запись хранится в файле в том же виде (32 байта, порядок байтов платформы записи).
+ */
+struct GRAPHICS_EXPORT TimelineRecord {
+    //! Начало записи по оси прокрутки.
+    double begin_value;
+    //! Конец записи по оси прокрутки.
+    double end_value;
+    //! Идентификатор записи в приложении.
+    quint64 id;
+    //! Номер секции.
+    quint32 section;
+    //! Вид записи в приложении.
+    quint32 kind;
+
+    //! Конструктор.
+    TimelineRecord() : begin_value(0.0), end_value(0.0), id(0), section(0), kind(0) {}
+};
+
+class TimelineFilePrivate;
+
+/*!
+ * \brief Файл расписания с доступом через отображение в память.
+ *
+ * Записи в файле упорядочены по секции и началу и разбиты на блоки. Для каждой секции
+ * хранится диапазон ее блоков, для каждого блока - начало первой записи и наибольший
+ * конец записей секции до конца блока включительно, поэтому блоки, пересекающие
+ * диапазон значений, находятся двоичным поиском без чтения самих записей.
+ *
+ * Открытие файла проверяет только заголовок и таблицу секций, страницы записей
+ * подгружаются операционной системой при обращении к ним.
+ */
+class GRAPHICS_EXPORT TimelineFile {
+    Q_DISABLE_COPY(TimelineFile)
+    Q_DECLARE_PRIVATE(TimelineFile)
+
+    //! Указатель на реализацию.
+    TimelineFilePrivate * const d_ptr;
+public:
+    //! Конструктор.
+    TimelineFile();
+    //! Деструктор.
+    ~TimelineFile();
+
+    //! Открытие файла \c file_name, false - при ошибке (см. errorString()).
+    bool open(const QString &file_name);
+    //! Закрытие файла.
+    void close();
+    //! Проверка открытия файла.
+    bool isOpen() const;
+    //! Описание последней ошибки.
+    QString errorString() const;
+
+    //! Количество записей.
+    quint64 recordsCount() const;
+    //! Количество секций.
+    uint sectionsCount() const;
+    //! Наименьшее начало записей.
+    double beginValue() const;
+    //! Наибольший конец записей.
+    double endValue() const;
+
+    //! Запись с номером \c index (номер должен быть меньше recordsCount()).
+    const TimelineRecord &record(quint64 index) const;
+
+    //! Номера записей, пересекающих диапазон значений от \c begin_value до \c end_value.
+    QVector<quint64> findRecords(double begin_value, double end_value) const;
+
+    /*!
+     * \brief Запись файла \c file_name из записей \c records с разбиением на блоки по \c block_size записей.
+     *
+     * Записи упорядочиваются по секции и началу. Таблица секций хранится для всех номеров
+     * до наибольшего номера секции записей, поэтому записи со слишком большим номером секции
+     * не записываются. При ошибке возвращается false, а описание ошибки помещается в \c error_string.
+     */
+    static bool write(const QString &file_name, const QVector<TimelineRecord> &records,
+                      int block_size = 1024, QString *error_string = 0);
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_TIMELINEFILE_H
@@ -0,0 +1,65 @@
+#ifndef GRAPHICS_TIMELINEPLOTSCENE_H
+#define GRAPHICS_TIMELINEPLOTSCENE_H
+
+/*!
+  * \file timelineplotscene.h
+  * \brief Объявление класса сцены, подгружающей элементы из файла расписания.
+  *
+  * \file timelineplotscene.cpp
+  * \brief Реализация класса сцены, подгружающей элементы из файла расписания.
+  */
+
+#include "commonprerequisites.h"
+#include "infiniteplotscene.h"
+
+namespace Graphics {
+
+class TimelinePlotScenePrivate;
+
+/*!
+ * \brief Сцена, подгружающая элементы из файла расписания.
+ *
+ * Элементы создаются фабрикой только для записей, пересекающих подгружаемую область
+ * шкалы прокрутки, добавляются на график через очередь подгрузки и уничтожаются при
+ * очистке области, поэтому количество элементов
+ * определяется диапазоном шкалы, а не размером файла.
+ */
+class GRAPHICS_EXPORT TimelinePlotScene : public InfinitePlotScene {
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(TimelinePlotScene)
+
+    //! Указатель на реализацию.
+    TimelinePlotScenePrivate * const d_ptr;
+public:
+    //! Конструктор с установкой родительского объекта \c parent.
+    explicit TimelinePlotScene(QObject *parent = 0);
+    //! Деструктор.
+    ~TimelinePlotScene();
+
+    //! Файл расписания.
+    TimelineFile *timelineFile() const;
+    //! Смена файла расписания на \c file (файл не передается во владение сцене).
+    void setTimelineFile(TimelineFile *file);
+
+    //! Фабрика элементов графика.
+    AbstractPlotItemFactory *plotItemFactory() const;
+    //! Смена фабрики элементов графика на \c factory (фабрика передается во владение сцене).
+    void setPlotItemFactory(AbstractPlotItemFactory *factory);
+
+    //! Уничтожение созданных элементов и подгрузка элементов для текущего диапазона шкалы прокрутки.
+    void reload();
+
+    void removePlotItem(AbstractPlotItem *item);
+    void removePlotItems(const QList<AbstractPlotItem *> &items);
+
+    //! Уничтожение элементов, записи которых не пересекают остающуюся после очистки от \c begin_value до \c end_value часть диапазона шкалы.
+    void cleanup(double begin_value, double end_value);
+    //! Создание элементов для записей, пересекающих область от \c begin_value до \c end_value, и постановка их в очередь подгрузки.
+    void populate(double begin_value, double end_value);
+    //! Удаление из таблиц созданных элементов и уничтожение фабрикой элементов \c items из очереди подгрузки.
+    void discard(const QList<AbstractPlotItem *> &items);
+};
+
+} // namespace Graphics
+
+#endif // GRAPHICS_TIMELINEPLOTSCENE_H
@@ -1,37 +1,471 @@
+#include <QHash>
+#include <QQueue>
+#include <QTimer>
+#include <QVector>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <algorithm>
 
 #include "include/converter.h"
 #include "include/infiniteplotscene.h"
 #include "include/abstractscale.h"
+#include "include/abstractplotitem.h"
+#include "include/plotstatistics.h"
 
 
 namespace Graphics {
 
+namespace {
+
+//! Элемент в очереди потока.
+struct StreamEntry {
+    //! Элемент графика.
+    AbstractPlotItem *item;
+    //! Порядковый номер добавления элемента.
+    quint64 sequence;
+    //! Конец элемента по оси прокрутки при добавлении.
+    double end_value;
+};
+
+//! Элемент в очереди подгрузки.
+struct PendingEntry {
+    //! Элемент графика.
+    AbstractPlotItem *item;
+    //! Начало элемента по оси прокрутки.
+    double begin_value;
+    //! Конец элемента по оси прокрутки.
+    double end_value;
+    //! Расстояние от элемента до центра видимой области при последнем упорядочивании.
+    double distance;
+};
+
+//! Сравнение записей очереди подгрузки: дальние от центра видимой области - в начале.
+bool fartherEntry(const PendingEntry &left, const PendingEntry &right)
+{
+    return left.distance > right.distance;
+}
+
+//! Наибольшее количество элементов в одной порции подгрузки.
+const int maximum_population_chunk = 4096;
+
+//! Наибольшее удаление начала шкалы прокрутки от нулевой позиции, после которого нулевая позиция переносится.
+const double maximum_origin_offset = 1048576.0;
+
+} // namespace
+
 //! Реализация сцены для графика с бесконечной прокруткой по одной из осей.
 class InfinitePlotScenePrivate {
-    friend class InfinitePlotScene;
-
-    //! Конструктор.
-    InfinitePlotScenePrivate() {}
+    Q_DECLARE_PUBLIC(InfinitePlotScene)
+
+    //! Указатель на объявление.
+    InfinitePlotScene *q_ptr;
+
+    //! Окно хранения элементов потока.
+    double retention;
+    //! Флаг следования за последним элементом потока.
+    bool is_following_head;
+    //! Наибольшее значение конца элементов потока.
+    double stream_head;
+    //! Флаг наличия элементов в потоке.
+    bool has_stream_head;
+
+    //! Элементы потока в порядке добавления.
+    QQueue<StreamEntry> stream_entries;
+    //! Порядковые номера добавления элементов потока, находящихся на графике.
+    QHash<AbstractPlotItem *, quint64> stream_sequences;
+    //! Порядковый номер следующего добавляемого элемента.
+    quint64 next_sequence;
+
+    //! Элементы очереди подгрузки, ближайшие к центру видимой области - в конце.
+    QVector<PendingEntry> pending_entries;
+    //! Флаг упорядоченности очереди подгрузки.
+    bool is_pending_sorted;
+    //! Значение шкалы прокрутки в центре видимой области при последнем упорядочивании.
+    double pending_focus;
+    //! Таймер добавления следующей порции элементов.
+    QTimer population_timer;
+    //! Бюджет времени порции в миллисекундах.
+    int population_budget;
+    //! Оценка времени добавления одного элемента в наносекундах.
+    qint64 item_population_cost;
+
+    //! Время упреждения прокрутки в миллисекундах.
+    int scroll_prediction_time;
+
+    //! Конструктор с указателем на объявление \c q.
+    InfinitePlotScenePrivate(InfinitePlotScene *q) :
+        q_ptr(q),
+        retention(0.0),
+        is_following_head(true),
+        stream_head(0.0),
+        has_stream_head(false),
+        next_sequence(0),
+        is_pending_sorted(true),
+        pending_focus(0.0),
+        population_budget(8),
+        item_population_cost(20000),
+        scroll_prediction_time(500)
+    {
+        population_timer.setSingleShot(true);
+        population_timer.setInterval(0);
+    }
     //! Деструктор.
     ~InfinitePlotScenePrivate() {}
+
+    //! Очистка области графика от \c begin_value до \c end_value с учетом в статистике.
+    void cleanupRange(double begin_value, double end_value);
+    //! Подгрузка данных графика в область от \c begin_value до \c end_value с учетом в статистике.
+    void populateRange(double begin_value, double end_value);
+
+    //! Шкала, вдоль которой выполняется прокрутка.
+    AbstractScale *scrollScale() const;
+    //! Конец элемента \c item по оси прокрутки.
+    double endValue(const AbstractPlotItem *item) const;
+
+    //! Сдвиг диапазона шкалы вперед до последнего элемента потока, true - если диапазон сдвинут.
+    bool followHead();
+    //! Удаление элементов потока, закончившихся раньше окна хранения.
+    void evictExpired();
+    //! Удаление из очереди записей элементов, удаленных с графика вне окна хранения.
+    void compactStream();
+
+    //! Значение шкалы прокрутки в центре видимой области первого виджета отображения.
+    double focusValue() const;
+    //! Упорядочивание очереди подгрузки по удаленности от центра видимой области.
+    void sortPending();
+    //! Извлечение из очереди подгрузки не более \c count элементов, попадающих в диапазон шкалы \c scroll_scale.
+    QList<AbstractPlotItem *> takePending(const AbstractScale *scroll_scale, int count);
+
+    //! Закрепление нулевой позиции шкалы \c scroll_scale перед сдвигом ее диапазона.
+    static void anchorOrigin(AbstractScale *scroll_scale);
+    //! Перенос закрепленной нулевой позиции шкалы \c scroll_scale к ее минимальному значению.
+    static void rebaseOrigin(AbstractScale *scroll_scale);
+    //! Обновление графика после сдвига диапазона шкалы \c scroll_scale.
+    void shiftWindow(AbstractScale *scroll_scale);
+    //! Расширение диапазона шкалы прокрутки до области, открываемой отдалением преобразованием.
+    void revealZoomedOut();
 };
 
+void InfinitePlotScenePrivate::cleanupRange(double begin_value, double end_value)
+{
+    Q_Q(InfinitePlotScene);
+
+    GRAPHICS_STATISTICS_COUNT(q->statistics(), CleanupCalls, 1);
+    GRAPHICS_STATISTICS_EXTENT(q->statistics(), CleanedExtent, begin_value, end_value);
+    GRAPHICS_STATISTICS_TIMER(q->statistics(), CleanupTime);
+
+    // элементы очереди, целиком лежащие в очищаемой области, на график уже не попадут
+    QList<AbstractPlotItem *> discarded_items;
+
+    int kept_count = 0;
+    for (int i = 0; i < pending_entries.size(); ++ i) {
+        const PendingEntry &entry = pending_entries.at(i);
+
+        if ((entry.begin_value >= begin_value) && (entry.end_value <= end_value))
+            discarded_items.append(entry.item);
+        else
+            pending_entries[kept_count ++] = entry;
+    }
+
+    pending_entries.resize(kept_count);
+
+    if (!discarded_items.isEmpty())
+        q->discard(discarded_items);
+
+    q->cleanup(begin_value, end_value);
+}
+
+void InfinitePlotScenePrivate::populateRange(double begin_value, double end_value)
+{
+    Q_Q(InfinitePlotScene);
+
+    GRAPHICS_STATISTICS_COUNT(q->statistics(), PopulateCalls, 1);
+    GRAPHICS_STATISTICS_EXTENT(q->statistics(), PopulatedExtent, begin_value, end_value);
+    GRAPHICS_STATISTICS_TIMER(q->statistics(), PopulateTime);
+
+    q->populate(begin_value, end_value);
+}
+
+AbstractScale *InfinitePlotScenePrivate::scrollScale() const
+{
+    Q_Q(const InfinitePlotScene);
+    return (q->sceneOrientation() == Qt::Horizontal) ? q->xScale() : q->yScale();
+}
+
+double InfinitePlotScenePrivate::endValue(const AbstractPlotItem *item) const
+{
+    Q_Q(const InfinitePlotScene);
+    return (q->sceneOrientation() == Qt::Horizontal) ? item->endCoordinateX() : item->endCoordinateY();
+}
+
+bool InfinitePlotScenePrivate::followHead()
+{
+    AbstractScale *scroll_scale = scrollScale();
+    if ((scroll_scale == 0) || (stream_head <= scroll_scale->maximum()))
+        return false;
+
+    const double old_minimum_value = scroll_scale->minimum();
+    const double old_maximum_value = scroll_scale->maximum();
+
+    // сдвиг не меньше половины диапазона, чтобы пересчет всех элементов выполнялся редко
+    const double extension_value = qMax((old_maximum_value - old_minimum_value) * 0.5,
+                                        stream_head - old_maximum_value);
+
+    const double new_minimum_value = old_minimum_value + extension_value;
+    const double new_maximum_value = old_maximum_value + extension_value;
+
+    cleanupRange(old_minimum_value, qMin(new_minimum_value, old_maximum_value));
+
+    anchorOrigin(scroll_scale);
+    scroll_scale->setRange(new_minimum_value, new_maximum_value);
+
+    populateRange(qMax(new_minimum_value, old_maximum_value), new_maximum_value);
+
+    shiftWindow(scroll_scale);
+
+    return true;
+}
+
+void InfinitePlotScenePrivate::evictExpired()
+{
+    Q_Q(InfinitePlotScene);
+
+    if ((retention <= 0.0) || !has_stream_head)
+        return;
+
+    const double expiration_value = stream_head - retention;
+
+    QList<AbstractPlotItem *> expired_items;
+
+    while (!stream_entries.isEmpty() && (stream_entries.head().end_value < expiration_value)) {
+        const StreamEntry entry = stream_entries.dequeue();
+
+        // элемент мог быть удален с графика, а его адрес - занят новым элементом
+        QHash<AbstractPlotItem *, quint64>::iterator it = stream_sequences.find(entry.item);
+        if ((it == stream_sequences.end()) || (it.value() != entry.sequence))
+            continue;
+
+        stream_sequences.erase(it);
+        expired_items.append(entry.item);
+    }
+
+    if (!expired_items.isEmpty())
+        q->evict(expired_items);
+}
+
+void InfinitePlotScenePrivate::compactStream()
+{
+    // очередь сжимается, только когда устаревших записей больше действующих,
+    // поэтому на каждый добавленный элемент приходится O(1) работы
+    if (stream_entries.size() <= 2 * stream_sequences.size() + 1024)
+        return;
+
+    QQueue<StreamEntry> actual_entries;
+    actual_entries.reserve(stream_sequences.size());
+
+    foreach (const StreamEntry &entry, stream_entries) {
+        QHash<AbstractPlotItem *, quint64>::const_iterator it = stream_sequences.constFind(entry.item);
+        if ((it != stream_sequences.constEnd()) && (it.value() == entry.sequence))
+            actual_entries.enqueue(entry);
+    }
+
+    stream_entries = actual_entries;
+}
+
+double InfinitePlotScenePrivate::focusValue() const
+{
+    Q_Q(const InfinitePlotScene);
+
+    QPointF focus_pos = q->sceneRect().center();
+
+    const QList<QGraphicsView *> plot_views = q->views();
+    if (!plot_views.isEmpty()) {
+        QGraphicsView *plot_view = plot_views.first();
+        focus_pos = plot_view->mapToScene(plot_view->viewport()->rect().center());
+    }
+
+    const QPointF focus_values = q->mapToScales(focus_pos);
+    return (q->sceneOrientation() == Qt::Horizontal) ? focus_values.x() : focus_values.y();
+}
+
+void InfinitePlotScenePrivate::sortPending()
+{
+    const double focus_value = focusValue();
+
+    // при неизменной видимой области очередь упорядочивается только после добавления элементов
+    if (is_pending_sorted && (focus_value == pending_focus))
+        return;
+
+    for (int i = 0; i < pending_entries.size(); ++ i) {
+        PendingEntry &entry = pending_entries[i];
+
+        if (focus_value < entry.begin_value)
+            entry.distance = entry.begin_value - focus_value;
+        else if (focus_value > entry.end_value)
+            entry.distance = focus_value - entry.end_value;
+        else
+            entry.distance = 0.0;
+    }
+
+    std::sort(pending_entries.begin(), pending_entries.end(), fartherEntry);
+
+    pending_focus = focus_value;
+    is_pending_sorted = true;
+}
+
+void InfinitePlotScenePrivate::anchorOrigin(AbstractScale *scroll_scale)
+{
+    // нулевая позиция у текущего минимума не меняет положение уже рассчитанных элементов
+    if (!scroll_scale->isOriginFixed())
+        scroll_scale->setOrigin(scroll_scale->minimum());
+}
+
+void InfinitePlotScenePrivate::rebaseOrigin(AbstractScale *scroll_scale)
+{
+    if (scroll_scale->isOriginFixed())
+        scroll_scale->setOrigin(scroll_scale->minimum());
+}
+
+void InfinitePlotScenePrivate::shiftWindow(AbstractScale *scroll_scale)
+{
+    Q_Q(InfinitePlotScene);
+
+    // шкала без закрепления нулевой позиции или слишком далекое начало требуют полного пересчета,
+    // иначе прежние элементы остаются на месте, новые уже расположены при добавлении,
+    // а пересчитываются только элементы, зависящие от диапазона шкалы
+    if (!scroll_scale->isOriginFixed() || (qAbs(scroll_scale->minimumPosition()) > maximum_origin_offset)) {
+        rebaseOrigin(scroll_scale);
+        q->refresh();
+        return;
+    }
+
+    const AbstractScale *x_scale = q->xScale();
+    const AbstractScale *y_scale = q->yScale();
+
+    q->setSceneRect(x_scale->minimumPosition(), y_scale->minimumPosition(),
+                    x_scale->length(), y_scale->length());
+
+    foreach (AbstractPlotItem *item, q->rangeDependentPlotItems())
+        q->refresh(item);
+}
+
+void InfinitePlotScenePrivate::revealZoomedOut()
+{
+    Q_Q(InfinitePlotScene);
+
+    AbstractScale *scroll_scale = scrollScale();
+    const QList<QGraphicsView *> plot_views = q->views();
+
+    if ((scroll_scale == 0) || plot_views.isEmpty() || (scroll_scale->length() <= 0.0))
+        return;
+
+    const bool is_horizontal = (q->sceneOrientation() == Qt::Horizontal);
+
+    // виджет отображения еще не применил новое преобразование
+    QGraphicsView *plot_view = plot_views.first();
+    const QTransform old_transform = plot_view->transform();
+    const QTransform new_transform = q->zoomTransform();
+
+    const double old_zoom_factor = is_horizontal ? old_transform.m11() : old_transform.m22();
+    const double new_zoom_factor = is_horizontal ? new_transform.m11() : new_transform.m22();
+
+    if ((old_zoom_factor <= 0.0) || (new_zoom_factor <= 0.0))
+        return;
+
+    const QRectF visible_rect = plot_view->mapToScene(plot_view->viewport()->rect()).boundingRect();
+    const QRectF scene_rect = q->sceneRect();
+
+    const double visible_begin = is_horizontal ? visible_rect.left() : visible_rect.top();
+    const double visible_end = is_horizontal ? visible_rect.right() : visible_rect.bottom();
+
+    // точка, вокруг которой отдаляет виджет, лежит в видимой области, поэтому новая видимая
+    // область не выходит за прежнюю больше чем на ее прирост с каждой стороны
+    const double visible_growth = (visible_end - visible_begin) * (old_zoom_factor / new_zoom_factor - 1.0);
+    if (visible_growth <= 0.0)
+        return;
+
+    const double begin_extension = qMax(0.0, (is_horizontal ? scene_rect.left() : scene_rect.top()) -
+                                             (visible_begin - visible_growth));
+    const double end_extension = qMax(0.0, (visible_end + visible_growth) -
+                                           (is_horizontal ? scene_rect.right() : scene_rect.bottom()));
+
+    if ((begin_extension <= 0.0) && (end_extension <= 0.0))
+        return;
+
+    const double old_minimum_value = scroll_scale->minimum();
+    const double old_maximum_value = scroll_scale->maximum();
+    const double position_value = (old_maximum_value - old_minimum_value) / scroll_scale->length();
+
+    const double new_minimum_value = old_minimum_value - begin_extension * position_value;
+    const double new_maximum_value = old_maximum_value + end_extension * position_value;
+
+    // длина растет вместе с диапазоном, поэтому плотность шкалы и положение прежних элементов
+    // не меняются, а преобразование отдаления рассчитано от длины в начале масштабирования
+    anchorOrigin(scroll_scale);
+    scroll_scale->setRange(new_minimum_value, new_maximum_value);
+    scroll_scale->setLength(scroll_scale->length() + begin_extension + end_extension);
+
+    if (new_minimum_value < old_minimum_value)
+        populateRange(new_minimum_value, old_minimum_value);
+    if (new_maximum_value > old_maximum_value)
+        populateRange(old_maximum_value, new_maximum_value);
+
+    shiftWindow(scroll_scale);
+}
+
+QList<AbstractPlotItem *> InfinitePlotScenePrivate::takePending(const AbstractScale *scroll_scale, int count)
+{
+    Q_Q(InfinitePlotScene);
+
+    QList<AbstractPlotItem *> items;
+    QList<AbstractPlotItem *> discarded_items;
+
+    while ((items.size() < count) && !pending_entries.isEmpty()) {
+        const PendingEntry entry = pending_entries.last();
+        pending_entries.pop_back();
+
+        // область элемента могла быть очищена прокруткой или масштабированием
+        if ((entry.end_value < scroll_scale->minimum()) || (entry.begin_value > scroll_scale->maximum())) {
+            discarded_items.append(entry.item);
+            continue;
+        }
+
+        items.append(entry.item);
+    }
+
+    if (!discarded_items.isEmpty())
+        q->discard(discarded_items);
+
+    return items;
+}
+
 
 
 InfinitePlotScene::InfinitePlotScene(QObject *parent) :
     StandardPlotScene(parent),
-    d_ptr(new InfinitePlotScenePrivate())
+    d_ptr(new InfinitePlotScenePrivate(this))
 {
+    Q_D(InfinitePlotScene);
+    connect(&d->population_timer, SIGNAL(timeout()), this, SLOT(populatePendingItems()));
 }
 
 InfinitePlotScene::~InfinitePlotScene()
 {
+    clearPendingPlotItems();
     delete d_ptr;
 }
 
 void InfinitePlotScene::zoomIn()
 {
+    Q_D(InfinitePlotScene);
+
+    // при масштабировании преобразованием диапазон шкалы не меняется
+    if (zoomMode() == ZoomTransform) {
+        StandardPlotScene::zoomIn();
+        return;
+    }
+
     if (zoomStep() >= maximumZoomStep())
         return;
 
@@ -54,12 +488,27 @@ void InfinitePlotScene::zoomIn()
     active_scale->setRange(active_scale->minimum() + value_zoom_extent,
                            active_scale->maximum() - value_zoom_extent);
 
-    cleanup(old_scale_minimum, active_scale->minimum());
-    cleanup(active_scale->maximum(), old_scale_maximum);
+    // после масштабирования все элементы пересчитываются, поэтому нулевая позиция переносится к началу
+    d->rebaseOrigin(active_scale);
+
+    d->cleanupRange(old_scale_minimum, active_scale->minimum());
+    d->cleanupRange(active_scale->maximum(), old_scale_maximum);
+
+    if (zoomMode() == ZoomDeferred)
+        refreshDeferred();
 }
 
 void InfinitePlotScene::zoomOut()
 {
+    Q_D(InfinitePlotScene);
+
+    // геометрия элементов не меняется, но открывшиеся края сцены подгружаются
+    if (zoomMode() == ZoomTransform) {
+        StandardPlotScene::zoomOut();
+        d->revealZoomedOut();
+        return;
+    }
+
     if (zoomStep() <= minimumZoomStep())
         return;
 
@@ -76,14 +525,21 @@ void InfinitePlotScene::zoomOut()
     active_scale->setRange(active_scale->minimum() - value_zoom_extent,
                            active_scale->maximum() + value_zoom_extent);
 
-    populate(active_scale->minimum(), old_scale_minimum);
-    populate(old_scale_maximum, active_scale->maximum());
+    d->rebaseOrigin(active_scale);
+
+    d->populateRange(active_scale->minimum(), old_scale_minimum);
+    d->populateRange(old_scale_maximum, active_scale->maximum());
 
     setZoomStep(zoomStep() - 1);
+
+    if (zoomMode() == ZoomDeferred)
+        refreshDeferred();
 }
 
 void InfinitePlotScene::scrollBack(const QRectF &visible_scene_rect)
 {
+    Q_D(InfinitePlotScene);
+
     const QRectF scene_rect = sceneRect();
 
     double scene_visible_limit = 0.0;
@@ -113,18 +569,21 @@ void InfinitePlotScene::scrollBack(const QRectF &visible_scene_rect)
         double new_minimum_value = old_minimum_value - extension_value;
         double new_maximum_value = old_maximum_value - extension_value;
 
-        cleanup(new_maximum_value, old_maximum_value);
+        d->cleanupRange(new_maximum_value, old_maximum_value);
 
+        d->anchorOrigin(scroll_scale);
         scroll_scale->setRange(new_minimum_value, new_maximum_value);
 
-        populate(new_minimum_value, old_minimum_value);
+        d->populateRange(new_minimum_value, old_minimum_value);
 
-        refresh();
+        d->shiftWindow(scroll_scale);
     }
 }
 
 void InfinitePlotScene::scrollForward(const QRectF &visible_scene_rect)
 {
+    Q_D(InfinitePlotScene);
+
     const QRectF scene_rect = sceneRect();
 
     double scene_visible_limit = 0.0;
@@ -154,18 +613,21 @@ void InfinitePlotScene::scrollForward(const QRectF &visible_scene_rect)
         double new_minimum_value = old_minimum_value + extension_value;
         double new_maximum_value = old_maximum_value + extension_value;
 
-        cleanup(old_minimum_value, new_minimum_value);
+        d->cleanupRange(old_minimum_value, new_minimum_value);
 
+        d->anchorOrigin(scroll_scale);
         scroll_scale->setRange(new_minimum_value, new_maximum_value);
 
-        populate(old_maximum_value, new_maximum_value);
+        d->populateRange(old_maximum_value, new_maximum_value);
 
-        refresh();
+        d->shiftWindow(scroll_scale);
     }
 }
 
 void InfinitePlotScene::scrollTo(const QRectF &visible_scene_rect, const QPointF &scale_values)
 {
+    Q_D(InfinitePlotScene);
+
     const QRectF scene_rect = sceneRect();
 
     if (sceneOrientation() == Qt::Horizontal) {
@@ -190,11 +652,14 @@ void InfinitePlotScene::scrollTo(const QRectF &visible_scene_rect, const QPointF
                 double new_minimum_value = scale_value - extension_value;
                 double new_maximum_value = scale_value + extension_value;
 
-                cleanup(qMax(old_minimum_value, new_maximum_value), old_maximum_value);
+                d->cleanupRange(qMax(old_minimum_value, new_maximum_value), old_maximum_value);
 
+                d->anchorOrigin(xScale());
                 xScale()->setRange(new_minimum_value, new_maximum_value);
 
-                populate(new_minimum_value, qMin(new_maximum_value, old_minimum_value));
+                d->populateRange(new_minimum_value, qMin(new_maximum_value, old_minimum_value));
+
+                d->shiftWindow(xScale());
             }
         }
         else {
@@ -205,11 +670,14 @@ void InfinitePlotScene::scrollTo(const QRectF &visible_scene_rect, const QPointF
                 double new_minimum_value = scale_value - extension_value;
                 double new_maximum_value = scale_value + extension_value;
 
-                cleanup(old_minimum_value, qMin(new_minimum_value, old_maximum_value));
+                d->cleanupRange(old_minimum_value, qMin(new_minimum_value, old_maximum_value));
 
+                d->anchorOrigin(xScale());
                 xScale()->setRange(new_minimum_value, new_maximum_value);
 
-                populate(qMax(new_minimum_value, old_maximum_value), new_maximum_value);
+                d->populateRange(qMax(new_minimum_value, old_maximum_value), new_maximum_value);
+
+                d->shiftWindow(xScale());
             }
         }
     }
@@ -235,11 +703,14 @@ void InfinitePlotScene::scrollTo(const QRectF &visible_scene_rect, const QPointF
                 double new_minimum_value = scale_value - extension_value;
                 double new_maximum_value = scale_value + extension_value;
 
-                cleanup(qMax(old_minimum_value, new_maximum_value), old_maximum_value);
+                d->cleanupRange(qMax(old_minimum_value, new_maximum_value), old_maximum_value);
 
+                d->anchorOrigin(yScale());
                 yScale()->setRange(new_minimum_value, new_maximum_value);
 
-                populate(new_minimum_value, qMin(new_maximum_value, old_minimum_value));
+                d->populateRange(new_minimum_value, qMin(new_maximum_value, old_minimum_value));
+
+                d->shiftWindow(yScale());
             }
         }
         else {
@@ -250,16 +721,65 @@ void InfinitePlotScene::scrollTo(const QRectF &visible_scene_rect, const QPointF
                 double new_minimum_value = scale_value - extension_value;
                 double new_maximum_value = scale_value + extension_value;
 
-                cleanup(old_minimum_value, qMin(new_minimum_value, old_maximum_value));
+                d->cleanupRange(old_minimum_value, qMin(new_minimum_value, old_maximum_value));
 
+                d->anchorOrigin(yScale());
                 yScale()->setRange(new_minimum_value, new_maximum_value);
 
-                populate(qMax(new_minimum_value, old_maximum_value), new_maximum_value);
+                d->populateRange(qMax(new_minimum_value, old_maximum_value), new_maximum_value);
+
+                d->shiftWindow(yScale());
             }
         }
     }
 }
 
+void InfinitePlotScene::predictScroll(const QRectF &visible_scene_rect, const QPointF &velocity)
+{
+    Q_D(InfinitePlotScene);
+
+    if (d->scroll_prediction_time <= 0)
+        return;
+
+    const QRectF scene_rect = sceneRect();
+
+    const bool is_horizontal = (sceneOrientation() == Qt::Horizontal);
+
+    const double lookahead = (is_horizontal ? velocity.x() : velocity.y()) * d->scroll_prediction_time / 1000.0;
+    if (lookahead == 0.0)
+        return;
+
+    const QRectF predicted_rect = is_horizontal ? visible_scene_rect.translated(lookahead, 0.0)
+                                                : visible_scene_rect.translated(0.0, lookahead);
+
+    const double visible_begin = is_horizontal ? visible_scene_rect.left() : visible_scene_rect.top();
+    const double visible_end = is_horizontal ? visible_scene_rect.right() : visible_scene_rect.bottom();
+    const double predicted_begin = is_horizontal ? predicted_rect.left() : predicted_rect.top();
+    const double predicted_end = is_horizontal ? predicted_rect.right() : predicted_rect.bottom();
+    const double scene_begin = is_horizontal ? scene_rect.left() : scene_rect.top();
+    const double scene_end = is_horizontal ? scene_rect.right() : scene_rect.bottom();
+
+    // сдвиг очищает половину диапазона позади, поэтому видимая область должна остаться в новом диапазоне
+    const double extension = (scene_end - scene_begin) * 0.5;
+
+    if ((lookahead > 0.0) && (predicted_end >= scene_end) && (visible_begin >= scene_begin + extension))
+        scrollForward(predicted_rect);
+    else if ((lookahead < 0.0) && (predicted_begin <= scene_begin) && (visible_end <= scene_end - extension))
+        scrollBack(predicted_rect);
+}
+
+int InfinitePlotScene::scrollPredictionTime() const
+{
+    Q_D(const InfinitePlotScene);
+    return d->scroll_prediction_time;
+}
+
+void InfinitePlotScene::setScrollPredictionTime(int msecs)
+{
+    Q_D(InfinitePlotScene);
+    d->scroll_prediction_time = qMax(msecs, 0);
+}
+
 void InfinitePlotScene::cleanup(double begin_value, double end_value)
 {
     Q_UNUSED(begin_value);
@@ -272,4 +792,230 @@ void InfinitePlotScene::populate(double begin_value, double end_value)
     Q_UNUSED(end_value);
 }
 
+void InfinitePlotScene::appendPlotItem(AbstractPlotItem *item)
+{
+    Q_D(InfinitePlotScene);
+
+    if ((item == 0) || (layout() == 0) || d->stream_sequences.contains(item))
+        return;
+
+    addPlotItem(item);
+
+    StreamEntry entry;
+    entry.item = item;
+    entry.sequence = d->next_sequence ++;
+    entry.end_value = d->endValue(item);
+
+    d->stream_entries.enqueue(entry);
+    d->stream_sequences.insert(item, entry.sequence);
+
+    if (!d->has_stream_head || (entry.end_value > d->stream_head)) {
+        d->stream_head = entry.end_value;
+        d->has_stream_head = true;
+    }
+
+    // при сдвиге шкалы положение элемента рассчитывается вместе со всеми
+    if (!d->is_following_head || !d->followHead())
+        refresh(item);
+
+    d->evictExpired();
+    d->compactStream();
+
+    if (d->is_following_head) {
+        emit followRequested((sceneOrientation() == Qt::Horizontal) ? QPointF(d->stream_head, item->beginCoordinateY())
+                                                                    : QPointF(item->beginCoordinateX(), d->stream_head));
+    }
+}
+
+double InfinitePlotScene::retention() const
+{
+    Q_D(const InfinitePlotScene);
+    return d->retention;
+}
+
+void InfinitePlotScene::setRetention(double extent)
+{
+    Q_D(InfinitePlotScene);
+
+    d->retention = qMax(extent, 0.0);
+    d->evictExpired();
+}
+
+bool InfinitePlotScene::isFollowingHead() const
+{
+    Q_D(const InfinitePlotScene);
+    return d->is_following_head;
+}
+
+void InfinitePlotScene::setFollowingHead(bool on)
+{
+    Q_D(InfinitePlotScene);
+    d->is_following_head = on;
+}
+
+double InfinitePlotScene::streamHead() const
+{
+    Q_D(const InfinitePlotScene);
+    return d->stream_head;
+}
+
+void InfinitePlotScene::queuePlotItem(AbstractPlotItem *item)
+{
+    Q_D(InfinitePlotScene);
+
+    if (item == 0)
+        return;
+
+    const bool is_horizontal = (sceneOrientation() == Qt::Horizontal);
+
+    const double begin_value = is_horizontal ? item->beginCoordinateX() : item->beginCoordinateY();
+    const double end_value = is_horizontal ? item->endCoordinateX() : item->endCoordinateY();
+
+    PendingEntry entry;
+    entry.item = item;
+    entry.begin_value = qMin(begin_value, end_value);
+    entry.end_value = qMax(begin_value, end_value);
+    entry.distance = 0.0;
+
+    d->pending_entries.append(entry);
+    d->is_pending_sorted = false;
+
+    if (!d->population_timer.isActive())
+        d->population_timer.start();
+}
+
+void InfinitePlotScene::queuePlotItems(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(InfinitePlotScene);
+
+    d->pending_entries.reserve(d->pending_entries.size() + items.size());
+
+    foreach (AbstractPlotItem *item, items)
+        queuePlotItem(item);
+}
+
+int InfinitePlotScene::pendingPlotItemsCount() const
+{
+    Q_D(const InfinitePlotScene);
+    return d->pending_entries.size();
+}
+
+void InfinitePlotScene::clearPendingPlotItems()
+{
+    Q_D(InfinitePlotScene);
+
+    d->population_timer.stop();
+
+    QList<AbstractPlotItem *> discarded_items;
+    discarded_items.reserve(d->pending_entries.size());
+
+    foreach (const PendingEntry &entry, d->pending_entries)
+        discarded_items.append(entry.item);
+
+    d->pending_entries.clear();
+    d->is_pending_sorted = true;
+
+    if (!discarded_items.isEmpty())
+        discard(discarded_items);
+}
+
+int InfinitePlotScene::populationBudget() const
+{
+    Q_D(const InfinitePlotScene);
+    return d->population_budget;
+}
+
+void InfinitePlotScene::setPopulationBudget(int msecs)
+{
+    Q_D(InfinitePlotScene);
+    d->population_budget = qMax(msecs, 1);
+}
+
+void InfinitePlotScene::populatePendingItems()
+{
+    Q_D(InfinitePlotScene);
+
+    AbstractScale *scroll_scale = d->scrollScale();
+
+    // без шкал и объекта позиционирования элементы ждут следующей постановки в очередь
+    if (d->pending_entries.isEmpty() || (scroll_scale == 0) || (layout() == 0))
+        return;
+
+    d->sortPending();
+
+    QElapsedTimer slice_timer;
+    slice_timer.start();
+
+    const qint64 budget = qint64(d->population_budget) * 1000000;
+
+    // размер порции подбирается по измеренному времени добавления элемента,
+    // при этом хотя бы одна порция добавляется за вызов, чтобы очередь всегда убывала
+    for (;;) {
+        const qint64 remaining = budget - slice_timer.nsecsElapsed();
+        if ((remaining <= 0) || d->pending_entries.isEmpty())
+            break;
+
+        const int chunk_size = int(qBound(qint64(1), remaining / d->item_population_cost,
+                                          qint64(maximum_population_chunk)));
+
+        const QList<AbstractPlotItem *> items = d->takePending(scroll_scale, chunk_size);
+        if (items.isEmpty())
+            continue;
+
+        const qint64 chunk_start = slice_timer.nsecsElapsed();
+
+        addPlotItems(items);
+
+        d->item_population_cost = qMax(qint64(1), (slice_timer.nsecsElapsed() - chunk_start) / items.size());
+
+        GRAPHICS_STATISTICS_COUNT(statistics(), ItemsPopulated, items.size());
+        GRAPHICS_STATISTICS_COUNT(statistics(), PopulationSlices, 1);
+    }
+
+    if (!d->pending_entries.isEmpty())
+        d->population_timer.start();
+}
+
+void InfinitePlotScene::removePlotItem(AbstractPlotItem *item)
+{
+    Q_D(InfinitePlotScene);
+
+    // запись в очереди остается и пропускается при удалении по окну хранения
+    d->stream_sequences.remove(item);
+
+    StandardPlotScene::removePlotItem(item);
+}
+
+void InfinitePlotScene::removePlotItems(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(InfinitePlotScene);
+
+    foreach (AbstractPlotItem *item, items)
+        d->stream_sequences.remove(item);
+
+    StandardPlotScene::removePlotItems(items);
+}
+
+void InfinitePlotScene::evict(const QList<AbstractPlotItem *> &items)
+{
+    // удаление одним пакетом: один проход по списку элементов сцены вместо поиска каждого элемента
+    removePlotItems(items);
+    qDeleteAll(items);
+}
+
+void InfinitePlotScene::discard(const QList<AbstractPlotItem *> &items)
+{
+    qDeleteAll(items);
+}
+
+double InfinitePlotScene::transformZoomExtent(const AbstractScale *scale) const
+{
+    const double value_range = scale->maximum() - scale->minimum();
+    if (value_range <= 0.0)
+        return StandardPlotScene::transformZoomExtent(scale);
+
+    // при пересчете шаг масштабирования сужает диапазон с обеих сторон шкалы
+    return 2.0 * zoomExtent() * scale->length() / value_range;
+}
+
 } // namespace Graphics
@@ -52,13 +52,19 @@ void InteractivePlotItemPrivate::updateFlags()
 void InteractivePlotItemPrivate::setMovable(bool on)
 {
     Q_Q(InteractivePlotItem);
-    q->setFlag(QGraphicsItem::ItemIsMovable, on);
+
+    // сцена, перемещающая элементы в значениях шкал, обрабатывает перетаскивание сама
+    const bool is_moved_by_scene = (q->plotScene() != 0) && q->plotScene()->isValueMoveEnabled();
+    q->setFlag(QGraphicsItem::ItemIsMovable, on && !is_moved_by_scene);
 }
 
 void InteractivePlotItemPrivate::setHoverable(bool on)
 {
     Q_Q(InteractivePlotItem);
-    q->setAcceptHoverEvents(on);
+
+    // сцена, которая сама находит элемент под курсором, отправляет события наведения напрямую
+    const bool is_resolved_by_scene = (q->plotScene() != 0) && q->plotScene()->isHoverResolved();
+    q->setAcceptHoverEvents(on && !is_resolved_by_scene);
 }
 
 void InteractivePlotItemPrivate::setClickable(bool on)
@@ -77,7 +83,10 @@ void InteractivePlotItemPrivate::setClickable(bool on)
 void InteractivePlotItemPrivate::setSelectable(bool on)
 {
     Q_Q(InteractivePlotItem);
-    q->setFlag(QGraphicsItem::ItemIsSelectable, on);
+
+    // выделение сцены с моделью выделения хранится в модели, а не во флагах QGraphicsItem
+    const bool is_selected_by_model = (q->plotScene() != 0) && (q->plotScene()->selectionModel() != 0);
+    q->setFlag(QGraphicsItem::ItemIsSelectable, on && !is_selected_by_model);
 }
 
 
@@ -123,6 +132,14 @@ void InteractivePlotItem::setSuppressedDefaultEvents(PlotItemInteractionFlags in
     d->suppressed_default_events = interaction_flags;
 }
 
+void InteractivePlotItem::setPlotScene(AbstractPlotScene *plot_scene)
+{
+    Q_D(InteractivePlotItem);
+
+    StandardPlotItem::setPlotScene(plot_scene);
+    d->updateFlags();
+}
+
 void InteractivePlotItem::onHoverEnter(const QPointF &item_pos)
 {
     plotScene()->plotItemHoverEnter(this, mapToScene(item_pos));
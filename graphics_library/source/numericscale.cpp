@@ -1,3 +1,5 @@
+#include <typeinfo>
+
 #include "include/numericscale.h"
 #include "include/abstractplotitem.h"
 
@@ -18,14 +20,23 @@ class NumericScalePrivate {
     Qt::Orientation orientation;
     //! Точность представления для дробных чисел.
     uint precision;
+    //! Значение в нулевой позиции при закреплении.
+    double origin;
+    //! Флаг закрепления нулевой позиции.
+    bool is_origin_fixed;
 
     //! Конструктор.
     NumericScalePrivate() :
         minimum(0.0), maximum(0.0),
         length(0.0), orientation(Qt::Horizontal),
-        precision(3)
+        precision(3),
+        origin(0.0), is_origin_fixed(false)
     {}
 
+    //! Значение в нулевой позиции.
+    double base() const
+    { return is_origin_fixed ? origin : minimum; }
+
     //! Деструктор.
     ~NumericScalePrivate() {}
 };
@@ -110,23 +121,61 @@ void NumericScale::setRange(double min, double max)
     d->maximum = max;
 }
 
+double NumericScale::origin() const
+{
+    Q_D(const NumericScale);
+    return d->base();
+}
+
+bool NumericScale::setOrigin(double value)
+{
+    Q_D(NumericScale);
+    d->origin = value;
+    d->is_origin_fixed = true;
+    return true;
+}
+
+bool NumericScale::isOriginFixed() const
+{
+    Q_D(const NumericScale);
+    return d->is_origin_fixed;
+}
+
+void NumericScale::resetOrigin()
+{
+    Q_D(NumericScale);
+    d->is_origin_fixed = false;
+}
+
+double NumericScale::minimumPosition() const
+{
+    Q_D(const NumericScale);
+    return d->is_origin_fixed ? position(d->minimum) : 0.0;
+}
+
 double NumericScale::position(double value) const
 {
     Q_D(const NumericScale);
-    return ((value - d->minimum) / (d->maximum - d->minimum) * d->length);
+    return ((value - d->base()) / (d->maximum - d->minimum) * d->length);
 }
 
 double NumericScale::value(double position) const
 {
     Q_D(const NumericScale);
-    return (d->minimum + position / d->length * (d->maximum - d->minimum));
+    return (d->base() + position / d->length * (d->maximum - d->minimum));
 }
 
 double NumericScale::position(const AbstractPlotItem *item) const
 {
     Q_D(const NumericScale);
-    return (d->orientation == Qt::Horizontal) ? (position(item->beginCoordinateX()) + item->width() * 0.5)
-                                              : (position(item->beginCoordinateY()) + item->height() * 0.5);
+    return (d->orientation == Qt::Horizontal) ? position(item->beginCoordinateX(), item->endCoordinateX(), item->width())
+                                              : position(item->beginCoordinateY(), item->endCoordinateY(), item->height());
+}
+
+double NumericScale::position(double value_from, double value_to, double extent) const
+{
+    Q_UNUSED(value_to);
+    return position(value_from) + extent * 0.5;
 }
 
 double NumericScale::distance(double value_from, double value_to) const
@@ -140,4 +189,18 @@ QString NumericScale::label(double position) const
     return QString::number(value(position), 'f', d->precision);
 }
 
+NumericScale *NumericScale::clone() const
+{
+    Q_D(const NumericScale);
+
+    // копия наследника была бы усечена до NumericScale и иначе отображала бы значения
+    if (typeid(*this) != typeid(NumericScale))
+        return 0;
+
+    NumericScale *scale = new NumericScale();
+    *scale->d_ptr = *d;
+
+    return scale;
+}
+
 } // namespace Graphics
@@ -0,0 +1,610 @@
+#include <cmath>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <QMap>
+#include <QSet>
+#include <QHash>
+#include <QVector>
+
+#include "include/packedplotlayout.h"
+#include "include/abstractplotscene.h"
+#include "include/abstractscale.h"
+#include "include/abstractplotitem.h"
+#include "include/plotstatistics.h"
+#include "include/plotitemgeometry.h"
+
+
+namespace Graphics {
+
+//! Реализация класса для позиционирования пересекающихся элементов секции по дорожкам.
+class PackedPlotLayoutPrivate {
+    Q_DECLARE_PUBLIC(PackedPlotLayout)
+
+    //! Место элемента в секции.
+    struct LaneSlot {
+        //! Секция.
+        uint section;
+        //! Дорожка секции.
+        int lane;
+        //! Начало элемента по оси прокрутки.
+        double begin_value;
+        //! Конец элемента по оси прокрутки.
+        double end_value;
+
+        //! Конструктор.
+        LaneSlot() : section(0), lane(-1), begin_value(0.0), end_value(0.0) {}
+
+        //! Проверка совпадения секции и интервала с местом \c other.
+        bool isSameInterval(const LaneSlot &other) const
+        {
+            return (section == other.section) && (begin_value == other.begin_value) && (end_value == other.end_value);
+        }
+    };
+
+    //! Конец последнего элемента дорожки при плотной перекладке.
+    struct LaneEnd {
+        //! Конец последнего элемента.
+        double end_value;
+        //! Дорожка.
+        int lane;
+
+        //! Упорядочивание для очереди с приоритетом, в вершине которой дорожка с наименьшим концом.
+        bool operator<(const LaneEnd &other) const { return end_value > other.end_value; }
+    };
+
+    /*!
+     * \brief Элементы дорожки, упорядоченные по началу.
+     *
+     * Элементы дорожки не пересекаются: конец каждого не больше начала следующего,
+     * поэтому одно начало могут иметь только элемент нулевой длины и следующий за ним.
+     */
+    typedef QMultiMap<double, AbstractPlotItem *> Lane;
+
+    //! Дорожки секции.
+    struct Section {
+        //! Дорожки.
+        QVector<Lane> lanes;
+        /*!
+         * \brief Номера дорожек, упорядоченные по концу их последнего элемента.
+         *
+         * Первой идет дорожка, освободившаяся раньше всех, пустые дорожки - в самом начале.
+         */
+        QMultiMap<double, int> lane_ends;
+    };
+
+    //! Указатель на объявление.
+    PackedPlotLayout *q_ptr;
+
+    //! Графическая сцена.
+    AbstractPlotScene *plot_scene;
+
+    //! Промежуток между дорожками.
+    double lane_spacing;
+
+    //! Места элементов.
+    QHash<const AbstractPlotItem *, LaneSlot> item_slots;
+    //! Дорожки секций.
+    QHash<uint, Section> sections;
+    //! Секции, количество дорожек которых изменилось после последнего пересчета позиций.
+    QSet<uint> dirty_sections;
+
+    //! Конструктор с указателем на объявление \c q.
+    PackedPlotLayoutPrivate(PackedPlotLayout *q) :
+        q_ptr(q),
+        plot_scene(0),
+        lane_spacing(0.0)
+    {}
+    //! Деструктор.
+    ~PackedPlotLayoutPrivate() {}
+
+    //! Проверка наличия сцены и обеих шкал.
+    bool hasScales() const
+    {
+        return (plot_scene != 0) && (plot_scene->xScale() != 0) && (plot_scene->yScale() != 0);
+    }
+
+    //! Проверка прокрутки сцены по горизонтали.
+    bool isHorizontal() const
+    {
+        return (plot_scene == 0) || (plot_scene->sceneOrientation() == Qt::Horizontal);
+    }
+
+    //! Секция и интервал элемента \c item.
+    LaneSlot interval(const AbstractPlotItem *item) const;
+    //! Проверка пересечения интервала от \c begin_value до \c end_value с элементами дорожки \c lane.
+    bool overlaps(const Lane &lane, double begin_value, double end_value) const;
+    //! Конец последнего элемента дорожки \c lane (для пустой дорожки - наименьшее значение).
+    double laneEnd(const Lane &lane) const;
+
+    //! Размещение элемента \c item в дорожке секции места \c slot, освободившейся раньше всех.
+    void insert(AbstractPlotItem *item, LaneSlot slot);
+    //! Освобождение места элемента \c item.
+    void take(const AbstractPlotItem *item);
+    //! Обновление места элемента \c item после изменения его значений.
+    void sync(AbstractPlotItem *item);
+
+    //! Сравнение элементов \c left и \c right по началу и концу.
+    static bool lessInterval(const QPair<LaneSlot, AbstractPlotItem *> &left, const QPair<LaneSlot, AbstractPlotItem *> &right)
+    {
+        if (left.first.begin_value != right.first.begin_value)
+            return left.first.begin_value < right.first.begin_value;
+        return left.first.end_value < right.first.end_value;
+    }
+
+    //! Плотная перекладка всех секций без пересчета позиций.
+    void repack();
+
+    //! Пересчет позиции элемента \c item.
+    void layoutItem(AbstractPlotItem *item);
+    //! Пересчет позиций элементов секции \c section, возвращает количество элементов.
+    int layoutSection(uint section);
+    //! Пересчет позиций элементов секций с изменившимся количеством дорожек.
+    void layoutDirtySections();
+};
+
+PackedPlotLayoutPrivate::LaneSlot PackedPlotLayoutPrivate::interval(const AbstractPlotItem *item) const
+{
+    LaneSlot slot;
+
+    if (isHorizontal()) {
+        slot.section = uint(floor(item->beginCoordinateY()));
+        slot.begin_value = qMin(item->beginCoordinateX(), item->endCoordinateX());
+        slot.end_value = qMax(item->beginCoordinateX(), item->endCoordinateX());
+    } else {
+        slot.section = uint(floor(item->beginCoordinateX()));
+        slot.begin_value = qMin(item->beginCoordinateY(), item->endCoordinateY());
+        slot.end_value = qMax(item->beginCoordinateY(), item->endCoordinateY());
+    }
+
+    return slot;
+}
+
+bool PackedPlotLayoutPrivate::overlaps(const Lane &lane, double begin_value, double end_value) const
+{
+    const Lane::const_iterator lower_it = lane.lowerBound(begin_value);
+
+    // элементы, начинающиеся внутри интервала; элемент нулевой длины в его начале не мешает
+    for (Lane::const_iterator it = lower_it; (it != lane.constEnd()) && (it.key() < end_value); ++ it) {
+        if ((it.key() > begin_value) || (item_slots.value(it.value()).end_value > begin_value))
+            return true;
+    }
+
+    // из начавшихся раньше достают до интервала только элементы с последним началом
+    if (lower_it == lane.constBegin())
+        return false;
+
+    Lane::const_iterator prev_it = lower_it;
+    -- prev_it;
+
+    const double prev_begin_value = prev_it.key();
+
+    for (;;) {
+        if (item_slots.value(prev_it.value()).end_value > begin_value)
+            return true;
+
+        if (prev_it == lane.constBegin())
+            return false;
+
+        -- prev_it;
+
+        if (prev_it.key() != prev_begin_value)
+            return false;
+    }
+}
+
+double PackedPlotLayoutPrivate::laneEnd(const Lane &lane) const
+{
+    if (lane.isEmpty())
+        return - std::numeric_limits<double>::max();
+
+    Lane::const_iterator it = lane.constEnd();
+    -- it;
+
+    const double last_begin_value = it.key();
+    double end_value = item_slots.value(it.value()).end_value;
+
+    while (it != lane.constBegin()) {
+        -- it;
+        if (it.key() != last_begin_value)
+            break;
+        end_value = qMax(end_value, item_slots.value(it.value()).end_value);
+    }
+
+    return end_value;
+}
+
+void PackedPlotLayoutPrivate::insert(AbstractPlotItem *item, LaneSlot slot)
+{
+    Section &section = sections[slot.section];
+
+    int lane = section.lanes.size();
+
+    // проверяется только дорожка, освободившаяся раньше всех: при добавлении в порядке начала
+    // это плотная раскладка, элементы не по порядку могут занять лишнюю дорожку до repack()
+    if (!section.lane_ends.isEmpty()) {
+        const QMultiMap<double, int>::iterator lane_end_it = section.lane_ends.begin();
+        const int first_free_lane = lane_end_it.value();
+
+        if ((lane_end_it.key() <= slot.begin_value) ||
+            !overlaps(section.lanes.at(first_free_lane), slot.begin_value, slot.end_value)) {
+            lane = first_free_lane;
+            section.lane_ends.erase(lane_end_it);
+        }
+    }
+
+    if (lane == section.lanes.size()) {
+        section.lanes.append(Lane());
+        dirty_sections.insert(slot.section);
+    }
+
+    slot.lane = lane;
+    item_slots.insert(item, slot);
+
+    section.lanes[lane].insert(slot.begin_value, item);
+    section.lane_ends.insert(laneEnd(section.lanes.at(lane)), lane);
+}
+
+void PackedPlotLayoutPrivate::take(const AbstractPlotItem *item)
+{
+    QHash<const AbstractPlotItem *, LaneSlot>::iterator slot_it = item_slots.find(item);
+    if (slot_it == item_slots.end())
+        return;
+
+    const LaneSlot slot = slot_it.value();
+
+    QHash<uint, Section>::iterator section_it = sections.find(slot.section);
+    if (section_it == sections.end()) {
+        item_slots.erase(slot_it);
+        return;
+    }
+
+    Section &section = section_it.value();
+    Lane &lane = section.lanes[slot.lane];
+
+    // конец дорожки считается до удаления места элемента, который может быть последним
+    section.lane_ends.remove(laneEnd(lane), slot.lane);
+
+    lane.remove(slot.begin_value, const_cast<AbstractPlotItem *>(item));
+    item_slots.erase(slot_it);
+
+    section.lane_ends.insert(laneEnd(lane), slot.lane);
+
+    // освобождаются только последние дорожки, остальные элементы секции не сдвигаются
+    const int lanes_count = section.lanes.size();
+    while (!section.lanes.isEmpty() && section.lanes.last().isEmpty()) {
+        section.lane_ends.remove(laneEnd(section.lanes.last()), section.lanes.size() - 1);
+        section.lanes.removeLast();
+    }
+
+    if (section.lanes.isEmpty()) {
+        sections.erase(section_it);
+        dirty_sections.remove(slot.section);
+    } else if (section.lanes.size() != lanes_count) {
+        dirty_sections.insert(slot.section);
+    }
+}
+
+void PackedPlotLayoutPrivate::sync(AbstractPlotItem *item)
+{
+    Q_Q(PackedPlotLayout);
+
+    // элементы вне сцены (например, уже удаленные) не раскладываются
+    if ((plot_scene == 0) || (item->scene() != plot_scene))
+        return;
+
+    QHash<const AbstractPlotItem *, LaneSlot>::const_iterator slot_it = item_slots.constFind(item);
+
+    if (!q->isPacked(item)) {
+        if (slot_it != item_slots.constEnd())
+            take(item);
+        return;
+    }
+
+    const LaneSlot slot = interval(item);
+
+    if (slot_it != item_slots.constEnd()) {
+        if (slot_it.value().isSameInterval(slot))
+            return;
+
+        take(item);
+    }
+
+    insert(item, slot);
+}
+
+void PackedPlotLayoutPrivate::repack()
+{
+    QHash<uint, QVector<QPair<LaneSlot, AbstractPlotItem *> > > section_items;
+
+    for (QHash<const AbstractPlotItem *, LaneSlot>::const_iterator it = item_slots.constBegin();
+         it != item_slots.constEnd(); ++ it)
+        section_items[it.value().section].append(qMakePair(it.value(), const_cast<AbstractPlotItem *>(it.key())));
+
+    sections.clear();
+    dirty_sections.clear();
+
+    for (QHash<uint, QVector<QPair<LaneSlot, AbstractPlotItem *> > >::iterator section_it = section_items.begin();
+         section_it != section_items.end(); ++ section_it) {
+        QVector<QPair<LaneSlot, AbstractPlotItem *> > &items = section_it.value();
+        std::sort(items.begin(), items.end(), lessInterval);
+
+        Section &section = sections[section_it.key()];
+        std::priority_queue<LaneEnd> lane_ends;
+
+        // проход по началам: элемент занимает дорожку, раньше всех освободившуюся к его началу,
+        // поэтому дорожек столько, сколько элементов пересекается в одной точке
+        for (int i = 0; i < items.size(); ++ i) {
+            LaneSlot slot = items.at(i).first;
+
+            LaneEnd lane_end;
+            if (!lane_ends.empty() && (lane_ends.top().end_value <= slot.begin_value)) {
+                lane_end = lane_ends.top();
+                lane_ends.pop();
+            } else {
+                lane_end.lane = section.lanes.size();
+                section.lanes.append(Lane());
+            }
+
+            lane_end.end_value = slot.end_value;
+            lane_ends.push(lane_end);
+
+            slot.lane = lane_end.lane;
+            section.lanes[slot.lane].insert(slot.begin_value, items.at(i).second);
+            item_slots.insert(items.at(i).second, slot);
+        }
+
+        while (!lane_ends.empty()) {
+            section.lane_ends.insert(lane_ends.top().end_value, lane_ends.top().lane);
+            lane_ends.pop();
+        }
+    }
+}
+
+void PackedPlotLayoutPrivate::layoutItem(AbstractPlotItem *item)
+{
+    Q_Q(PackedPlotLayout);
+
+    const AbstractScale *x_scale = plot_scene->xScale();
+    const AbstractScale *y_scale = plot_scene->yScale();
+
+    PlotItemGeometry item_geometry = q->AbstractPlotLayout::geometry(PlotItemValues(item), x_scale, y_scale);
+
+    QHash<const AbstractPlotItem *, LaneSlot>::const_iterator slot_it = item_slots.constFind(item);
+    if (slot_it != item_slots.constEnd()) {
+        const LaneSlot &slot = slot_it.value();
+        const int lanes_count = sections.value(slot.section).lanes.size();
+
+        // секция с одной дорожкой располагается по правилам шкалы, как в StandardPlotLayout
+        if (lanes_count > 1) {
+            const bool is_horizontal = isHorizontal();
+            const AbstractScale *section_scale = is_horizontal ? y_scale : x_scale;
+            const double section = double(slot.section);
+
+            // у дискретной шкалы расстояние от секции до нее же - размер секции, у числовой - ноль
+            double section_size = section_scale->distance(section, section);
+            if (section_size <= 0.0)
+                section_size = section_scale->distance(section, section + 1.0);
+
+            const double lane_size = section_size / double(lanes_count);
+            const double lane_center = section_scale->position(section) + lane_size * (double(slot.lane) + 0.5);
+            const double lane_extent = qMax(0.0, lane_size - lane_spacing);
+
+            if (is_horizontal) {
+                if (item->isHeightCalculated())
+                    item_geometry.height = lane_extent;
+                item_geometry.y = lane_center;
+            } else {
+                if (item->isWidthCalculated())
+                    item_geometry.width = lane_extent;
+                item_geometry.x = lane_center;
+            }
+        }
+    }
+
+    item_geometry.applyTo(item);
+}
+
+int PackedPlotLayoutPrivate::layoutSection(uint section)
+{
+    int items_count = 0;
+
+    const QVector<Lane> lanes = sections.value(section).lanes;
+    foreach (const Lane &lane, lanes) {
+        for (Lane::const_iterator it = lane.constBegin(); it != lane.constEnd(); ++ it) {
+            layoutItem(it.value());
+            ++ items_count;
+        }
+    }
+
+    return items_count;
+}
+
+void PackedPlotLayoutPrivate::layoutDirtySections()
+{
+    int items_count = 0;
+
+    foreach (uint section, dirty_sections)
+        items_count += layoutSection(section);
+
+    dirty_sections.clear();
+
+    GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), ItemsLaidOut, items_count);
+}
+
+
+
+PackedPlotLayout::PackedPlotLayout() :
+    AbstractPlotLayout(),
+    d_ptr(new PackedPlotLayoutPrivate(this))
+{
+}
+
+PackedPlotLayout::~PackedPlotLayout()
+{
+    delete d_ptr;
+}
+
+AbstractPlotScene *PackedPlotLayout::plotScene() const
+{
+    Q_D(const PackedPlotLayout);
+    return d->plot_scene;
+}
+
+void PackedPlotLayout::setPlotScene(AbstractPlotScene *plot_scene)
+{
+    Q_D(PackedPlotLayout);
+
+    // элементы новой сцены передаются через itemAdded()
+    d->item_slots.clear();
+    d->sections.clear();
+    d->dirty_sections.clear();
+
+    d->plot_scene = plot_scene;
+}
+
+double PackedPlotLayout::laneSpacing() const
+{
+    Q_D(const PackedPlotLayout);
+    return d->lane_spacing;
+}
+
+void PackedPlotLayout::setLaneSpacing(double spacing)
+{
+    Q_D(PackedPlotLayout);
+    d->lane_spacing = qMax(0.0, spacing);
+}
+
+int PackedPlotLayout::lanesCount(uint section) const
+{
+    Q_D(const PackedPlotLayout);
+    return d->sections.value(section).lanes.size();
+}
+
+int PackedPlotLayout::lane(const AbstractPlotItem *item) const
+{
+    Q_D(const PackedPlotLayout);
+
+    QHash<const AbstractPlotItem *, PackedPlotLayoutPrivate::LaneSlot>::const_iterator slot_it = d->item_slots.constFind(item);
+    return (slot_it != d->item_slots.constEnd()) ? slot_it.value().lane : -1;
+}
+
+void PackedPlotLayout::repack()
+{
+    Q_D(PackedPlotLayout);
+
+    d->repack();
+    refresh();
+}
+
+bool PackedPlotLayout::isPacked(const AbstractPlotItem *item) const
+{
+    Q_D(const PackedPlotLayout);
+
+    const double begin_value = d->isHorizontal() ? item->beginCoordinateY() : item->beginCoordinateX();
+    const double end_value = d->isHorizontal() ? item->endCoordinateY() : item->endCoordinateX();
+
+    return (begin_value >= 0.0) && (floor(begin_value) == floor(end_value));
+}
+
+void PackedPlotLayout::itemAdded(AbstractPlotItem *item)
+{
+    Q_D(PackedPlotLayout);
+
+    // позиции пересчитываются при следующем вызове refresh(), который следует за добавлением
+    if ((item != 0) && isPacked(item))
+        d->insert(item, d->interval(item));
+}
+
+void PackedPlotLayout::itemRemoved(AbstractPlotItem *item)
+{
+    itemsRemoved(QList<AbstractPlotItem *>() << item);
+}
+
+void PackedPlotLayout::itemsRemoved(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(PackedPlotLayout);
+
+    foreach (AbstractPlotItem *item, items)
+        d->take(item);
+
+    // оставшиеся элементы секций занимают освободившееся место один раз на всю операцию
+    if (!d->dirty_sections.isEmpty() && d->hasScales())
+        d->layoutDirtySections();
+}
+
+void PackedPlotLayout::refresh()
+{
+    Q_D(PackedPlotLayout);
+
+    if (!d->hasScales())
+        return;
+
+    GRAPHICS_STATISTICS_COUNT(d->plot_scene->statistics(), LayoutRefreshes, 1);
+    GRAPHICS_STATISTICS_TIMER(d->plot_scene->statistics(), LayoutTime);
+
+    const AbstractScale *x_scale = d->plot_scene->xScale();
+    const AbstractScale *y_scale = d->plot_scene->yScale();
+
+    d->plot_scene->setSceneRect(x_scale->minimumPosition(), y_scale->minimumPosition(),
+                                x_scale->length(), y_scale->length());
+
+    const QList<AbstractPlotItem *> items = d->plot_scene->plotItems();
+
+    foreach (AbstractPlotItem *item, items) {
+        if (item != 0)
+            d->sync(item);
+    }
+
+    // все элементы пересчитываются ниже, поэтому отдельный проход по секциям не нужен
+    d->dirty_sections.clear();
+
+    foreach (AbstractPlotItem *item, items) {
+        if (item != 0)
+            d->layoutItem(item);
+    }
+
+    GRAPHICS_STATISTICS_COUNT(d->plot_scene->statistics(), ItemsLaidOut, items.size());
+}
+
+void PackedPlotLayout::refresh(AbstractPlotItem *item)
+{
+    refresh(QList<AbstractPlotItem *>() << item);
+}
+
+void PackedPlotLayout::refresh(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(PackedPlotLayout);
+
+    if (!d->hasScales())
+        return;
+
+    GRAPHICS_STATISTICS_TIMER(d->plot_scene->statistics(), LayoutTime);
+
+    foreach (AbstractPlotItem *item, items) {
+        if (item != 0)
+            d->sync(item);
+    }
+
+    const QSet<uint> dirty_sections = d->dirty_sections;
+    d->layoutDirtySections();
+
+    int items_count = 0;
+
+    foreach (AbstractPlotItem *item, items) {
+        if (item == 0)
+            continue;
+
+        // элементы секций с изменившимся количеством дорожек уже пересчитаны
+        QHash<const AbstractPlotItem *, PackedPlotLayoutPrivate::LaneSlot>::const_iterator slot_it = d->item_slots.constFind(item);
+        if ((slot_it != d->item_slots.constEnd()) && dirty_sections.contains(slot_it.value().section))
+            continue;
+
+        d->layoutItem(item);
+        ++ items_count;
+    }
+
+    GRAPHICS_STATISTICS_COUNT(d->plot_scene->statistics(), ItemsLaidOut, items_count);
+}
+
+} // namespace Graphics
@@ -0,0 +1,40 @@
+#include "include/plotitemgeometry.h"
+#include "include/abstractplotitem.h"
+
+
+namespace Graphics {
+
+PlotItemValues::PlotItemValues() :
+    begin_x(0.0), end_x(0.0), begin_y(0.0), end_y(0.0),
+    width(0.0), height(0.0),
+    is_width_calculated(false), is_height_calculated(false)
+{
+}
+
+PlotItemValues::PlotItemValues(const AbstractPlotItem *item) :
+    begin_x(item->beginCoordinateX()), end_x(item->endCoordinateX()),
+    begin_y(item->beginCoordinateY()), end_y(item->endCoordinateY()),
+    width(item->width()), height(item->height()),
+    is_width_calculated(item->isWidthCalculated()), is_height_calculated(item->isHeightCalculated())
+{
+}
+
+PlotItemGeometry::PlotItemGeometry() :
+    width(0.0), height(0.0), x(0.0), y(0.0)
+{
+}
+
+void PlotItemGeometry::applyTo(AbstractPlotItem *item) const
+{
+    if (item->isWidthCalculated())
+        item->setWidth(width);
+
+    if (item->isHeightCalculated())
+        item->setHeight(height);
+
+    item->setPos(x, y);
+
+    item->update();
+}
+
+} // namespace Graphics
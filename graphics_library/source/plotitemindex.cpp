@@ -0,0 +1,325 @@
+#include <cmath>
+#include <QMap>
+#include <QHash>
+
+#include "include/plotitemindex.h"
+#include "include/abstractplotitem.h"
+
+
+namespace Graphics {
+
+//! Реализация класса индекса элементов графика в пространстве значений шкал.
+class PlotItemIndexPrivate {
+    friend class PlotItemIndex;
+
+    //! Ключ элемента в индексе.
+    struct Key {
+        //! Первая строка элемента.
+        qint64 row;
+        //! Последняя строка элемента.
+        qint64 row_end;
+        //! Начало интервала элемента.
+        double begin;
+        //! Конец интервала элемента.
+        double end;
+
+        //! Сравнение ключей.
+        bool operator==(const Key &other) const
+        {
+            return (row == other.row) && (row_end == other.row_end) &&
+                   (begin == other.begin) && (end == other.end);
+        }
+    };
+
+    //! Запись элемента в строке индекса.
+    struct Entry {
+        //! Элемент графика.
+        AbstractPlotItem *item;
+        //! Последняя строка элемента.
+        qint64 row_end;
+        //! Конец интервала элемента.
+        double end;
+    };
+
+    /*!
+     * \brief Строка индекса.
+     *
+     * Записи упорядочены по началу интервала в дереве, поэтому добавление и удаление
+     * элемента не требуют сдвига остальных записей строки.
+     */
+    struct Row {
+        //! Записи элементов строки по началу интервала.
+        QMultiMap<double, Entry> entries;
+        //! Максимальная длина интервала в строке.
+        double max_length;
+
+        //! Конструктор.
+        Row() : max_length(0.0) {}
+    };
+
+    //! Ориентация оси интервалов.
+    Qt::Orientation orientation;
+    //! Флаг разбиения элементов на строки.
+    bool is_row_bucketed;
+
+    //! Строки индекса.
+    QMap<qint64, Row> rows;
+    //! Ключи элементов.
+    QHash<AbstractPlotItem *, Key> item_keys;
+    //! Максимальное количество строк, занимаемых одним элементом, минус один.
+    qint64 max_row_span;
+
+    //! Конструктор.
+    PlotItemIndexPrivate() :
+        orientation(Qt::Horizontal),
+        is_row_bucketed(false),
+        max_row_span(0)
+    {}
+
+    //! Деструктор.
+    ~PlotItemIndexPrivate() {}
+
+    //! Расчет ключа элемента \c item.
+    Key key(const AbstractPlotItem *item) const;
+
+    //! Добавление элемента \c item с ключом \c item_key.
+    void insert(AbstractPlotItem *item, const Key &item_key);
+    //! Удаление элемента \c item с ключом \c item_key.
+    void remove(AbstractPlotItem *item, Key item_key);
+
+    //! Перестроение индекса.
+    void rebuild();
+
+    /*!
+     * \brief Сбор элементов строк от \c first_row до \c last_row, пересекающих интервал
+     * от \c begin до \c end, в список \c result.
+     */
+    void collect(qint64 first_row, qint64 last_row, double begin, double end,
+                 QList<AbstractPlotItem *> *result) const;
+};
+
+PlotItemIndexPrivate::Key PlotItemIndexPrivate::key(const AbstractPlotItem *item) const
+{
+    const bool is_horizontal = (orientation == Qt::Horizontal);
+
+    const double interval_begin = is_horizontal ? item->beginCoordinateX() : item->beginCoordinateY();
+    const double interval_end = is_horizontal ? item->endCoordinateX() : item->endCoordinateY();
+
+    const double cross_begin = is_horizontal ? item->beginCoordinateY() : item->beginCoordinateX();
+    const double cross_end = is_horizontal ? item->endCoordinateY() : item->endCoordinateX();
+
+    Key item_key;
+    item_key.begin = qMin(interval_begin, interval_end);
+    item_key.end = qMax(interval_begin, interval_end);
+
+    if (is_row_bucketed) {
+        item_key.row = qint64(floor(qMin(cross_begin, cross_end)));
+        item_key.row_end = qint64(floor(qMax(cross_begin, cross_end)));
+    }
+    else {
+        item_key.row = 0;
+        item_key.row_end = 0;
+    }
+
+    return item_key;
+}
+
+void PlotItemIndexPrivate::insert(AbstractPlotItem *item, const PlotItemIndexPrivate::Key &item_key)
+{
+    Row &row = rows[item_key.row];
+
+    Entry entry;
+    entry.item = item;
+    entry.row_end = item_key.row_end;
+    entry.end = item_key.end;
+
+    row.entries.insert(item_key.begin, entry);
+    row.max_length = qMax(row.max_length, item_key.end - item_key.begin);
+
+    max_row_span = qMax(max_row_span, item_key.row_end - item_key.row);
+
+    item_keys.insert(item, item_key);
+}
+
+void PlotItemIndexPrivate::remove(AbstractPlotItem *item, PlotItemIndexPrivate::Key item_key)
+{
+    item_keys.remove(item);
+
+    QMap<qint64, Row>::iterator row_it = rows.find(item_key.row);
+    if (row_it == rows.end())
+        return;
+
+    QMultiMap<double, Entry> &entries = row_it.value().entries;
+
+    // запись ищется среди элементов с тем же началом интервала
+    QMultiMap<double, Entry>::iterator entry_it = entries.find(item_key.begin);
+    for (; (entry_it != entries.end()) && (entry_it.key() == item_key.begin); ++ entry_it) {
+        if (entry_it.value().item == item) {
+            entries.erase(entry_it);
+            break;
+        }
+    }
+
+    if (entries.isEmpty())
+        rows.erase(row_it);
+}
+
+void PlotItemIndexPrivate::rebuild()
+{
+    const QList<AbstractPlotItem *> items = item_keys.keys();
+
+    rows.clear();
+    item_keys.clear();
+    max_row_span = 0;
+
+    foreach (AbstractPlotItem *item, items)
+        insert(item, key(item));
+}
+
+void PlotItemIndexPrivate::collect(qint64 first_row, qint64 last_row, double begin, double end,
+                                   QList<AbstractPlotItem *> *result) const
+{
+    QMap<qint64, Row>::const_iterator row_it = rows.lowerBound(first_row - max_row_span);
+
+    for (; (row_it != rows.constEnd()) && (row_it.key() <= last_row); ++ row_it) {
+        const Row &row = row_it.value();
+
+        // ни один интервал строки, начавшийся раньше этой границы, не достает до begin
+        QMultiMap<double, Entry>::const_iterator entry_it = row.entries.lowerBound(begin - row.max_length);
+
+        for (; (entry_it != row.entries.constEnd()) && (entry_it.key() <= end); ++ entry_it) {
+            const Entry &entry = entry_it.value();
+            if ((entry.end >= begin) && (entry.row_end >= first_row))
+                result->append(entry.item);
+        }
+    }
+}
+
+
+
+PlotItemIndex::PlotItemIndex() :
+    d_ptr(new PlotItemIndexPrivate())
+{
+}
+
+PlotItemIndex::~PlotItemIndex()
+{
+    delete d_ptr;
+}
+
+Qt::Orientation PlotItemIndex::orientation() const
+{
+    Q_D(const PlotItemIndex);
+    return d->orientation;
+}
+
+void PlotItemIndex::setOrientation(Qt::Orientation orientation)
+{
+    Q_D(PlotItemIndex);
+    if (d->orientation != orientation) {
+        d->orientation = orientation;
+        d->rebuild();
+    }
+}
+
+bool PlotItemIndex::isRowBucketed() const
+{
+    Q_D(const PlotItemIndex);
+    return d->is_row_bucketed;
+}
+
+void PlotItemIndex::setRowBucketed(bool on)
+{
+    Q_D(PlotItemIndex);
+    if (d->is_row_bucketed != on) {
+        d->is_row_bucketed = on;
+        d->rebuild();
+    }
+}
+
+int PlotItemIndex::count() const
+{
+    Q_D(const PlotItemIndex);
+    return d->item_keys.size();
+}
+
+bool PlotItemIndex::contains(AbstractPlotItem *item) const
+{
+    Q_D(const PlotItemIndex);
+    return d->item_keys.contains(item);
+}
+
+void PlotItemIndex::clear()
+{
+    Q_D(PlotItemIndex);
+    d->rows.clear();
+    d->item_keys.clear();
+    d->max_row_span = 0;
+}
+
+void PlotItemIndex::insert(AbstractPlotItem *item)
+{
+    Q_D(PlotItemIndex);
+
+    if ((item == 0) || d->item_keys.contains(item))
+        return;
+
+    d->insert(item, d->key(item));
+}
+
+void PlotItemIndex::remove(AbstractPlotItem *item)
+{
+    Q_D(PlotItemIndex);
+
+    QHash<AbstractPlotItem *, PlotItemIndexPrivate::Key>::const_iterator key_it = d->item_keys.constFind(item);
+    if (key_it == d->item_keys.constEnd())
+        return;
+
+    d->remove(item, key_it.value());
+}
+
+void PlotItemIndex::update(AbstractPlotItem *item)
+{
+    Q_D(PlotItemIndex);
+
+    QHash<AbstractPlotItem *, PlotItemIndexPrivate::Key>::const_iterator key_it = d->item_keys.constFind(item);
+    if (key_it == d->item_keys.constEnd())
+        return;
+
+    const PlotItemIndexPrivate::Key new_key = d->key(item);
+    if (new_key == key_it.value())
+        return;
+
+    d->remove(item, key_it.value());
+    d->insert(item, new_key);
+}
+
+QList<AbstractPlotItem *> PlotItemIndex::items(const QPointF &scale_values) const
+{
+    return items(QRectF(scale_values, QSizeF(0.0, 0.0)));
+}
+
+QList<AbstractPlotItem *> PlotItemIndex::items(const QRectF &value_rect) const
+{
+    Q_D(const PlotItemIndex);
+
+    const QRectF rect = value_rect.normalized();
+    const bool is_horizontal = (d->orientation == Qt::Horizontal);
+
+    const double begin = is_horizontal ? rect.left() : rect.top();
+    const double end = is_horizontal ? rect.right() : rect.bottom();
+
+    qint64 first_row = 0;
+    qint64 last_row = 0;
+
+    if (d->is_row_bucketed) {
+        first_row = qint64(floor(is_horizontal ? rect.top() : rect.left()));
+        last_row = qint64(floor(is_horizontal ? rect.bottom() : rect.right()));
+    }
+
+    QList<AbstractPlotItem *> result;
+    d->collect(first_row, last_row, begin, end, &result);
+    return result;
+}
+
+} // namespace Graphics
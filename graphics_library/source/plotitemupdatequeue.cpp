@@ -0,0 +1,248 @@
+#include <QHash>
+#include <QObject>
+#include <QByteArray>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+
+#include "include/plotitemupdatequeue.h"
+#include "include/abstractplotitem.h"
+
+
+namespace Graphics {
+
+PlotItemUpdate::PlotItemUpdate(AbstractPlotItem *item) :
+    item(item), fields(0), z_value(0.0), is_visible(true)
+{
+}
+
+void PlotItemUpdate::merge(const PlotItemUpdate &other)
+{
+    if (other.fields & BeginCoordinates)
+        begin_coordinates = other.begin_coordinates;
+
+    if (other.fields & EndCoordinates)
+        end_coordinates = other.end_coordinates;
+
+    if (other.fields & ZValue)
+        z_value = other.z_value;
+
+    if (other.fields & Visibility)
+        is_visible = other.is_visible;
+
+    for (QMap<int, QVariant>::const_iterator it = other.data.constBegin(); it != other.data.constEnd(); ++ it)
+        data.insert(it.key(), it.value());
+
+    fields |= other.fields;
+}
+
+void PlotItemUpdate::apply() const
+{
+    if (item == 0)
+        return;
+
+    if (fields & BeginCoordinates)
+        item->setBeginCoordinates(begin_coordinates.x(), begin_coordinates.y());
+
+    if (fields & EndCoordinates)
+        item->setEndCoordinates(end_coordinates.x(), end_coordinates.y());
+
+    if (fields & ZValue)
+        item->setZValue(z_value);
+
+    if (fields & Visibility)
+        item->setVisible(is_visible);
+
+    for (QMap<int, QVariant>::const_iterator it = data.constBegin(); it != data.constEnd(); ++ it)
+        item->setData(it.key(), it.value());
+}
+
+
+
+namespace {
+
+//! Узел списка изменений.
+struct UpdateNode {
+    //! Изменение.
+    PlotItemUpdate update;
+    //! Следующий (добавленный раньше) узел.
+    UpdateNode *next;
+
+    //! Конструктор узла изменения \c update.
+    explicit UpdateNode(const PlotItemUpdate &update) : update(update), next(0) {}
+};
+
+//! Чтение указателя \c pointer.
+template <class T>
+inline T *loadPointer(const QAtomicPointer<T> &pointer)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    return pointer.loadAcquire();
+#else
+    return pointer;
+#endif
+}
+
+} // namespace
+
+//! Реализация очереди изменений элементов графика.
+class PlotItemUpdateQueuePrivate {
+public:
+    //! Последний добавленный узел (список связан в обратном порядке).
+    QAtomicPointer<UpdateNode> head;
+    //! Флаг отправленного и еще не обработанного уведомления получателя.
+    QAtomicInt is_notified;
+
+    //! Уведомляемый объект.
+    QObject *receiver;
+    //! Имя слота уведомляемого объекта.
+    QByteArray member;
+
+    //! Конструктор.
+    PlotItemUpdateQueuePrivate(QObject *receiver, const char *member) :
+        head(0), is_notified(0), receiver(receiver), member(member)
+    {}
+
+    //! Удаление узлов списка, начиная с \c node.
+    static void deleteNodes(UpdateNode *node)
+    {
+        while (node != 0) {
+            UpdateNode *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+};
+
+
+
+PlotItemUpdateQueue::PlotItemUpdateQueue(QObject *receiver, const char *member) :
+    d_ptr(new PlotItemUpdateQueuePrivate(receiver, member))
+{
+}
+
+PlotItemUpdateQueue::~PlotItemUpdateQueue()
+{
+    Q_D(PlotItemUpdateQueue);
+
+    PlotItemUpdateQueuePrivate::deleteNodes(d->head.fetchAndStoreAcquire(0));
+
+    delete d_ptr;
+}
+
+void PlotItemUpdateQueue::setBeginCoordinates(AbstractPlotItem *item, const QPointF &coordinates)
+{
+    PlotItemUpdate update(item);
+    update.fields = PlotItemUpdate::BeginCoordinates;
+    update.begin_coordinates = coordinates;
+    push(update);
+}
+
+void PlotItemUpdateQueue::setEndCoordinates(AbstractPlotItem *item, const QPointF &coordinates)
+{
+    PlotItemUpdate update(item);
+    update.fields = PlotItemUpdate::EndCoordinates;
+    update.end_coordinates = coordinates;
+    push(update);
+}
+
+void PlotItemUpdateQueue::setCoordinates(AbstractPlotItem *item, const QPointF &begin, const QPointF &end)
+{
+    PlotItemUpdate update(item);
+    update.fields = PlotItemUpdate::BeginCoordinates | PlotItemUpdate::EndCoordinates;
+    update.begin_coordinates = begin;
+    update.end_coordinates = end;
+    push(update);
+}
+
+void PlotItemUpdateQueue::setZValue(AbstractPlotItem *item, qreal z)
+{
+    PlotItemUpdate update(item);
+    update.fields = PlotItemUpdate::ZValue;
+    update.z_value = z;
+    push(update);
+}
+
+void PlotItemUpdateQueue::setVisible(AbstractPlotItem *item, bool visible)
+{
+    PlotItemUpdate update(item);
+    update.fields = PlotItemUpdate::Visibility;
+    update.is_visible = visible;
+    push(update);
+}
+
+void PlotItemUpdateQueue::setData(AbstractPlotItem *item, int key, const QVariant &value)
+{
+    PlotItemUpdate update(item);
+    update.fields = PlotItemUpdate::Data;
+    update.data.insert(key, value);
+    push(update);
+}
+
+void PlotItemUpdateQueue::push(const PlotItemUpdate &update)
+{
+    Q_D(PlotItemUpdateQueue);
+
+    if ((update.item == 0) || (update.fields == 0))
+        return;
+
+    UpdateNode *node = new UpdateNode(update);
+
+    // стек Трайбера: узел подставляется в голову списка, пока голова не изменится другим потоком
+    for (;;) {
+        UpdateNode *head = loadPointer(d->head);
+        node->next = head;
+
+        if (d->head.testAndSetRelease(head, node))
+            break;
+    }
+
+    if ((d->receiver != 0) && !d->member.isEmpty() && d->is_notified.testAndSetOrdered(0, 1))
+        QMetaObject::invokeMethod(d->receiver, d->member.constData(), Qt::QueuedConnection);
+}
+
+bool PlotItemUpdateQueue::isEmpty() const
+{
+    Q_D(const PlotItemUpdateQueue);
+    return loadPointer(d->head) == 0;
+}
+
+QList<PlotItemUpdate> PlotItemUpdateQueue::take()
+{
+    Q_D(PlotItemUpdateQueue);
+
+    // флаг сбрасывается до извлечения, чтобы изменение, добавленное после извлечения,
+    // вызвало новое уведомление (лишнее уведомление приводит лишь к пустому извлечению)
+    d->is_notified.fetchAndStoreOrdered(0);
+
+    UpdateNode *node = d->head.fetchAndStoreAcquire(0);
+
+    // восстановление порядка добавления
+    UpdateNode *first = 0;
+    while (node != 0) {
+        UpdateNode *next = node->next;
+        node->next = first;
+        first = node;
+        node = next;
+    }
+
+    QList<PlotItemUpdate> updates;
+    QHash<AbstractPlotItem *, int> update_indexes;
+
+    for (node = first; node != 0; node = node->next) {
+        QHash<AbstractPlotItem *, int>::const_iterator it = update_indexes.constFind(node->update.item);
+
+        if (it == update_indexes.constEnd()) {
+            update_indexes.insert(node->update.item, updates.size());
+            updates.append(node->update);
+        }
+        else {
+            updates[it.value()].merge(node->update);
+        }
+    }
+
+    PlotItemUpdateQueuePrivate::deleteNodes(first);
+
+    return updates;
+}
+
+} // namespace Graphics
@@ -0,0 +1,225 @@
+#include <QSet>
+
+#include "include/plotselectionmodel.h"
+#include "include/abstractplotscene.h"
+#include "include/abstractplotitem.h"
+#include "include/interactiveplotitem.h"
+
+
+namespace Graphics {
+
+//! Реализация класса модели выделения элементов графика.
+class PlotSelectionModelPrivate {
+    Q_DECLARE_PUBLIC(PlotSelectionModel)
+
+    //! Указатель на объявление.
+    PlotSelectionModel *q_ptr;
+
+    //! Сцена графика.
+    AbstractPlotScene *plot_scene;
+
+    //! Выделенные элементы.
+    QSet<const AbstractPlotItem *> selected_items;
+
+    //! Область элементов, выделение которых изменилось в текущей операции.
+    QRectF dirty_rect;
+    //! Флаг изменения выделения в текущей операции.
+    bool is_changed;
+
+    //! Конструктор с указателем на объявление \c q.
+    PlotSelectionModelPrivate(PlotSelectionModel *q, AbstractPlotScene *plot_scene) :
+        q_ptr(q),
+        plot_scene(plot_scene),
+        is_changed(false)
+    {}
+    //! Деструктор.
+    ~PlotSelectionModelPrivate() {}
+
+    //! Изменение выделения элемента \c item на \c on.
+    void setSelected(AbstractPlotItem *item, bool on);
+    //! Снятие выделения со всех элементов, кроме \c kept_items.
+    void clearExcept(const QSet<AbstractPlotItem *> &kept_items);
+    //! Завершение операции: перерисовка измененной области и сигнал об изменении.
+    void commit();
+};
+
+void PlotSelectionModelPrivate::setSelected(AbstractPlotItem *item, bool on)
+{
+    if (on == selected_items.contains(item))
+        return;
+
+    if (on)
+        selected_items.insert(item);
+    else
+        selected_items.remove(item);
+
+    dirty_rect |= item->sceneBoundingRect();
+    is_changed = true;
+}
+
+void PlotSelectionModelPrivate::clearExcept(const QSet<AbstractPlotItem *> &kept_items)
+{
+    QSet<const AbstractPlotItem *>::iterator it = selected_items.begin();
+    while (it != selected_items.end()) {
+        AbstractPlotItem *item = const_cast<AbstractPlotItem *>(*it);
+
+        if (kept_items.contains(item)) {
+            ++ it;
+            continue;
+        }
+
+        dirty_rect |= item->sceneBoundingRect();
+        is_changed = true;
+
+        it = selected_items.erase(it);
+    }
+}
+
+void PlotSelectionModelPrivate::commit()
+{
+    Q_Q(PlotSelectionModel);
+
+    if (!is_changed)
+        return;
+
+    // одна общая область вместо перерисовки каждого элемента
+    if (!dirty_rect.isEmpty())
+        plot_scene->update(dirty_rect);
+
+    dirty_rect = QRectF();
+    is_changed = false;
+
+    emit q->selectionChanged();
+}
+
+
+
+PlotSelectionModel::PlotSelectionModel(AbstractPlotScene *plot_scene) :
+    QObject(plot_scene),
+    d_ptr(new PlotSelectionModelPrivate(this, plot_scene))
+{
+}
+
+PlotSelectionModel::~PlotSelectionModel()
+{
+    delete d_ptr;
+}
+
+AbstractPlotScene *PlotSelectionModel::plotScene() const
+{
+    Q_D(const PlotSelectionModel);
+    return d->plot_scene;
+}
+
+int PlotSelectionModel::count() const
+{
+    Q_D(const PlotSelectionModel);
+    return d->selected_items.size();
+}
+
+QList<AbstractPlotItem *> PlotSelectionModel::selectedItems() const
+{
+    Q_D(const PlotSelectionModel);
+
+    QList<AbstractPlotItem *> items;
+    items.reserve(d->selected_items.size());
+
+    foreach (const AbstractPlotItem *item, d->selected_items)
+        items.append(const_cast<AbstractPlotItem *>(item));
+
+    return items;
+}
+
+bool PlotSelectionModel::isSelected(const AbstractPlotItem *item) const
+{
+    Q_D(const PlotSelectionModel);
+    return d->selected_items.contains(item);
+}
+
+bool PlotSelectionModel::isSelectable(const AbstractPlotItem *item)
+{
+    const InteractivePlotItem *interactive_item = dynamic_cast<const InteractivePlotItem *>(item);
+    return (interactive_item != 0) && interactive_item->interactionFlags().testFlag(InteractionSelect);
+}
+
+void PlotSelectionModel::select(AbstractPlotItem *item, SelectionCommand command)
+{
+    select(QList<AbstractPlotItem *>() << item, command);
+}
+
+void PlotSelectionModel::select(const QList<AbstractPlotItem *> &items, SelectionCommand command)
+{
+    Q_D(PlotSelectionModel);
+
+    QSet<AbstractPlotItem *> selectable_items;
+    selectable_items.reserve(items.size());
+
+    foreach (AbstractPlotItem *item, items) {
+        if ((item != 0) && (item->plotScene() == d->plot_scene) && isSelectable(item))
+            selectable_items.insert(item);
+    }
+
+    if (command == ClearAndSelect)
+        d->clearExcept(selectable_items);
+
+    foreach (AbstractPlotItem *item, selectable_items) {
+        switch (command) {
+            case Select:
+            case ClearAndSelect:
+                d->setSelected(item, true);
+                break;
+            case Deselect:
+                d->setSelected(item, false);
+                break;
+            case Toggle:
+                d->setSelected(item, !d->selected_items.contains(item));
+                break;
+        }
+    }
+
+    d->commit();
+}
+
+void PlotSelectionModel::select(const QRectF &value_rect, SelectionCommand command, bool exact)
+{
+    Q_D(PlotSelectionModel);
+
+    // сцена отвечает по индексу значений, не обходя все элементы
+    select(d->plot_scene->plotItems(value_rect.normalized(), exact), command);
+}
+
+void PlotSelectionModel::clear()
+{
+    Q_D(PlotSelectionModel);
+
+    d->clearExcept(QSet<AbstractPlotItem *>());
+    d->commit();
+}
+
+void PlotSelectionModel::forget(const AbstractPlotItem *item)
+{
+    Q_D(PlotSelectionModel);
+
+    if (d->selected_items.remove(item))
+        emit selectionChanged();
+}
+
+void PlotSelectionModel::forget(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(PlotSelectionModel);
+
+    if (d->selected_items.isEmpty())
+        return;
+
+    bool is_changed = false;
+
+    foreach (const AbstractPlotItem *item, items) {
+        if (d->selected_items.remove(item))
+            is_changed = true;
+    }
+
+    if (is_changed)
+        emit selectionChanged();
+}
+
+} // namespace Graphics
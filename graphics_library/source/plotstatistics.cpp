@@ -0,0 +1,78 @@
+#include <cmath>
+
+#include "include/plotstatistics.h"
+
+
+namespace Graphics {
+
+PlotStatistics::PlotStatistics()
+{
+    reset();
+}
+
+bool PlotStatistics::isEnabled()
+{
+#ifdef GRAPHICS_STATISTICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 PlotStatistics::counter(PlotStatistics::Counter counter) const
+{
+    return counters[counter];
+}
+
+void PlotStatistics::addCounter(PlotStatistics::Counter counter, qint64 value)
+{
+    counters[counter] += value;
+}
+
+qint64 PlotStatistics::elapsed(PlotStatistics::Timer timer) const
+{
+    return timers[timer];
+}
+
+void PlotStatistics::addElapsed(PlotStatistics::Timer timer, qint64 nsecs)
+{
+    timers[timer] += nsecs;
+}
+
+double PlotStatistics::extent(PlotStatistics::Extent extent) const
+{
+    return extents[extent];
+}
+
+void PlotStatistics::addExtent(PlotStatistics::Extent extent, double begin_value, double end_value)
+{
+    extents[extent] += fabs(end_value - begin_value);
+}
+
+void PlotStatistics::reset()
+{
+    for (int i = 0; i < CountersCount; ++ i)
+        counters[i] = 0;
+
+    for (int i = 0; i < TimersCount; ++ i)
+        timers[i] = 0;
+
+    for (int i = 0; i < ExtentsCount; ++ i)
+        extents[i] = 0.0;
+}
+
+
+
+PlotStatisticsTimer::PlotStatisticsTimer(PlotStatistics *statistics, PlotStatistics::Timer timer) :
+    statistics(statistics),
+    timer(timer)
+{
+    elapsed_timer.start();
+}
+
+PlotStatisticsTimer::~PlotStatisticsTimer()
+{
+    statistics->addElapsed(timer, elapsed_timer.nsecsElapsed());
+}
+
+} // namespace Graphics
@@ -0,0 +1,823 @@
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QVector>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QSharedPointer>
+
+#include "include/scheduleimporter.h"
+#include "include/abstractplotscene.h"
+#include "include/abstractplotitem.h"
+#include "include/abstractplotitemfactory.h"
+#include "include/timelinefile.h"
+#include "include/civiltime.h"
+#include "include/converter.h"
+
+
+namespace Graphics {
+
+namespace {
+
+//! Поле строки расписания.
+enum ScheduleField {
+    //! Номер секции.
+    SectionField,
+    //! Начало.
+    BeginField,
+    //! Конец.
+    EndField,
+    //! Подпись.
+    LabelField,
+    //! Количество полей.
+    FieldsCount
+};
+
+//! Имена полей строки расписания.
+const char * const field_names[FieldsCount] = { "section", "begin", "end", "label" };
+
+//! Пачка разобранных строк.
+struct ImportBatch {
+    //! Записи.
+    QVector<TimelineRecord> records;
+    //! Подписи записей.
+    QVector<QString> labels;
+    //! Количество прочитанных байт файла.
+    qint64 bytes_read;
+    //! Количество пропущенных строк.
+    qint64 skipped_count;
+    //! Флаг последней пачки.
+    bool is_last;
+    //! Описание ошибки чтения файла.
+    QString error_string;
+
+    //! Конструктор.
+    ImportBatch() : bytes_read(0), skipped_count(0), is_last(false) {}
+};
+
+//! Задание импорта.
+struct ImportJob {
+    //! Имя файла.
+    QString file_name;
+    //! Формат файла.
+    ScheduleImporter::Format format;
+    //! Разделитель полей CSV.
+    char csv_separator;
+    //! Трактовка времени без смещения.
+    Qt::TimeSpec time_spec;
+    //! Количество строк в пачке.
+    int batch_size;
+    //! Размер файла.
+    qint64 bytes_total;
+
+    //! Свободные места в очереди пачек.
+    QSemaphore free_batches;
+    //! Флаг прерывания импорта.
+    mutable QAtomicInt is_cancelled;
+
+    //! Защита очереди пачек.
+    QMutex batches_mutex;
+    //! Пачки, ожидающие добавления на график.
+    QQueue<QSharedPointer<ImportBatch> > ready_batches;
+
+    //! Конструктор задания с очередью из \c pending_batches пачек.
+    explicit ImportJob(int pending_batches) :
+        format(ScheduleImporter::FormatCsv), csv_separator(','), time_spec(Qt::LocalTime),
+        batch_size(1), bytes_total(0), free_batches(pending_batches), is_cancelled(0)
+    {}
+
+    //! Проверка прерывания импорта.
+    bool isCancelled() const { return is_cancelled.fetchAndAddOrdered(0) != 0; }
+};
+
+//! Разбор \c count десятичных цифр с позиции \c pos в \c value.
+bool parseDigits(const char *&pos, const char *end, int count, int *value)
+{
+    if (end - pos < count)
+        return false;
+
+    int result = 0;
+
+    for (int i = 0; i < count; ++ i, ++ pos) {
+        if ((*pos < '0') || (*pos > '9'))
+            return false;
+
+        result = result * 10 + (*pos - '0');
+    }
+
+    *value = result;
+
+    return true;
+}
+
+//! Пропуск символа \c symbol на позиции \c pos, false - если на позиции другой символ.
+bool skipSymbol(const char *&pos, const char *end, char symbol)
+{
+    if ((pos == end) || (*pos != symbol))
+        return false;
+
+    ++ pos;
+
+    return true;
+}
+
+/*!
+ * \brief Разбор момента \c text в формате ISO 8601 в микросекунды \c usecs.
+ *
+ * Флаг \c has_offset устанавливается, если в записи указано смещение или Z,
+ * тогда \c usecs - момент UTC, иначе - "настенное" время.
+ */
+bool parseIsoDateTime(const QByteArray &text, qint64 *usecs, bool *has_offset)
+{
+    const char *pos = text.constData();
+    const char *end = pos + text.size();
+
+    CivilTime::Fields fields = { 0, 0, 0, 0, 0, 0, 0 };
+
+    if (!parseDigits(pos, end, 4, &fields.year) || !skipSymbol(pos, end, '-') ||
+        !parseDigits(pos, end, 2, &fields.month) || !skipSymbol(pos, end, '-') ||
+        !parseDigits(pos, end, 2, &fields.day))
+        return false;
+
+    if ((pos != end) && ((*pos == 'T') || (*pos == ' '))) {
+        ++ pos;
+
+        if (!parseDigits(pos, end, 2, &fields.hour) || !skipSymbol(pos, end, ':') ||
+            !parseDigits(pos, end, 2, &fields.minute))
+            return false;
+
+        if (skipSymbol(pos, end, ':') && !parseDigits(pos, end, 2, &fields.second))
+            return false;
+
+        if (skipSymbol(pos, end, '.') || skipSymbol(pos, end, ',')) {
+            // учитываются первые шесть знаков дробной части
+            int scale = 100000;
+            const char *fraction_begin = pos;
+
+            for (; (pos != end) && (*pos >= '0') && (*pos <= '9'); ++ pos, scale /= 10)
+                fields.usec += (*pos - '0') * scale;
+
+            if (pos == fraction_begin)
+                return false;
+        }
+    }
+
+    qint64 offset_usecs = 0;
+    *has_offset = false;
+
+    if (skipSymbol(pos, end, 'Z')) {
+        *has_offset = true;
+    }
+    else if ((pos != end) && ((*pos == '+') || (*pos == '-'))) {
+        const int sign = (*pos == '-') ? -1 : 1;
+        ++ pos;
+
+        int offset_hours = 0;
+        int offset_minutes = 0;
+
+        if (!parseDigits(pos, end, 2, &offset_hours))
+            return false;
+
+        skipSymbol(pos, end, ':');
+
+        if ((pos != end) && !parseDigits(pos, end, 2, &offset_minutes))
+            return false;
+
+        offset_usecs = sign * (qint64(offset_hours) * 3600 + qint64(offset_minutes) * 60) * CivilTime::usecs_per_second;
+        *has_offset = true;
+    }
+
+    if (pos != end)
+        return false;
+
+    if ((fields.month < 1) || (fields.month > 12) ||
+        (fields.day < 1) || (fields.day > CivilTime::daysInMonth(fields.year, fields.month)) ||
+        (fields.hour > 23) || (fields.minute > 59) || (fields.second > 59))
+        return false;
+
+    *usecs = CivilTime::usecs(fields) - offset_usecs;
+
+    return true;
+}
+
+//! Перевод меток времени в значения шкалы с кэшем смещений местного времени.
+class TimestampParser {
+public:
+    //! Конструктор с трактовкой времени без смещения \c time_spec.
+    explicit TimestampParser(Qt::TimeSpec time_spec) : time_spec(time_spec) {}
+
+    //! Разбор метки времени \c text в значение шкалы \c value.
+    bool parse(const QByteArray &text, double *value)
+    {
+        qint64 usecs = 0;
+        bool has_offset = false;
+
+        if (parseIsoDateTime(text, &usecs, &has_offset)) {
+            if (!has_offset && (time_spec == Qt::LocalTime)) {
+                // таблица покрывает год в обе стороны и при выходе за нее только дополняется,
+                // поэтому каждый участок времени рассчитывается один раз за импорт
+                if (!offsets.covers(usecs - CivilTime::usecs_per_day, usecs + CivilTime::usecs_per_day))
+                    offsets.extendLocal(usecs - 366 * CivilTime::usecs_per_day, usecs + 366 * CivilTime::usecs_per_day);
+
+                usecs = offsets.toUtc(usecs);
+            }
+
+            *value = Converter::usecsToScale(usecs);
+            return true;
+        }
+
+        bool ok = false;
+        *value = text.toDouble(&ok);
+
+        return ok;
+    }
+private:
+    //! Трактовка времени без смещения.
+    Qt::TimeSpec time_spec;
+    //! Смещения местного времени.
+    UtcOffsetTable offsets;
+};
+
+//! Разбиение строки CSV \c line с разделителем \c separator на поля \c fields.
+void splitCsvLine(const QByteArray &line, char separator, QList<QByteArray> *fields)
+{
+    fields->clear();
+
+    QByteArray field;
+    bool is_quoted = false;
+
+    for (int i = 0; i < line.size(); ++ i) {
+        const char symbol = line.at(i);
+
+        if (is_quoted) {
+            if (symbol != '"')
+                field.append(symbol);
+            else if ((i + 1 < line.size()) && (line.at(i + 1) == '"'))
+                field.append(line.at(++ i));
+            else
+                is_quoted = false;
+        }
+        else if (symbol == '"') {
+            is_quoted = true;
+        }
+        else if (symbol == separator) {
+            fields->append(field);
+            field.clear();
+        }
+        else {
+            field.append(symbol);
+        }
+    }
+
+    fields->append(field);
+}
+
+//! Проверка строки CSV \c fields на заголовок с заполнением номеров столбцов полей \c columns.
+bool parseCsvHeader(const QList<QByteArray> &fields, int columns[FieldsCount])
+{
+    int header_columns[FieldsCount] = { -1, -1, -1, -1 };
+
+    for (int i = 0; i < fields.size(); ++ i) {
+        const QByteArray name = fields.at(i).trimmed().toLower();
+
+        for (int field = 0; field < FieldsCount; ++ field) {
+            if (name == field_names[field])
+                header_columns[field] = i;
+        }
+    }
+
+    if ((header_columns[SectionField] < 0) || (header_columns[BeginField] < 0) || (header_columns[EndField] < 0))
+        return false;
+
+    for (int field = 0; field < FieldsCount; ++ field)
+        columns[field] = header_columns[field];
+
+    return true;
+}
+
+//! Пропуск пробельных символов с позиции \c pos.
+void skipSpaces(const char *&pos, const char *end)
+{
+    while ((pos != end) && ((*pos == ' ') || (*pos == '\t') || (*pos == '\r') || (*pos == '\n')))
+        ++ pos;
+}
+
+//! Разбор строки JSON с позиции \c pos (на открывающей кавычке) в \c value в UTF-8.
+bool parseJsonString(const char *&pos, const char *end, QByteArray *value)
+{
+    if (!skipSymbol(pos, end, '"'))
+        return false;
+
+    value->clear();
+
+    // коды \uXXXX собираются подряд, чтобы суррогатные пары перекодировались вместе
+    QString utf16_units;
+
+    while (pos != end) {
+        const char symbol = *pos ++;
+
+        if ((symbol == '\\') && (pos != end) && (*pos == 'u')) {
+            ++ pos;
+
+            ushort unit = 0;
+            for (int i = 0; i < 4; ++ i, ++ pos) {
+                if (pos == end)
+                    return false;
+
+                const char digit = *pos;
+                unit <<= 4;
+
+                if ((digit >= '0') && (digit <= '9'))
+                    unit |= ushort(digit - '0');
+                else if ((digit >= 'a') && (digit <= 'f'))
+                    unit |= ushort(digit - 'a' + 10);
+                else if ((digit >= 'A') && (digit <= 'F'))
+                    unit |= ushort(digit - 'A' + 10);
+                else
+                    return false;
+            }
+
+            utf16_units.append(QChar(unit));
+            continue;
+        }
+
+        if (!utf16_units.isEmpty()) {
+            value->append(utf16_units.toUtf8());
+            utf16_units.clear();
+        }
+
+        if (symbol == '"')
+            return true;
+
+        if (symbol != '\\') {
+            value->append(symbol);
+            continue;
+        }
+
+        if (pos == end)
+            return false;
+
+        switch (*pos ++) {
+            case 'b': value->append('\b'); break;
+            case 'f': value->append('\f'); break;
+            case 'n': value->append('\n'); break;
+            case 'r': value->append('\r'); break;
+            case 't': value->append('\t'); break;
+            default: value->append(*(pos - 1)); break;
+        }
+    }
+
+    return false;
+}
+
+//! Разбор плоского объекта JSON \c line в значения полей \c values.
+bool parseJsonLine(const QByteArray &line, QByteArray values[FieldsCount])
+{
+    for (int field = 0; field < FieldsCount; ++ field)
+        values[field].clear();
+
+    const char *pos = line.constData();
+    const char *end = pos + line.size();
+
+    skipSpaces(pos, end);
+    if (!skipSymbol(pos, end, '{'))
+        return false;
+
+    skipSpaces(pos, end);
+    if (skipSymbol(pos, end, '}'))
+        return true;
+
+    QByteArray key;
+    QByteArray value;
+
+    for (;;) {
+        skipSpaces(pos, end);
+        if (!parseJsonString(pos, end, &key))
+            return false;
+
+        skipSpaces(pos, end);
+        if (!skipSymbol(pos, end, ':'))
+            return false;
+
+        skipSpaces(pos, end);
+
+        if ((pos != end) && (*pos == '"')) {
+            if (!parseJsonString(pos, end, &value))
+                return false;
+        }
+        else {
+            // числа, true, false и null; вложенные объекты и массивы не поддерживаются
+            const char *value_begin = pos;
+            while ((pos != end) && (*pos != ',') && (*pos != '}') && (*pos != ' ') && (*pos != '\t')) {
+                if ((*pos == '{') || (*pos == '['))
+                    return false;
+                ++ pos;
+            }
+
+            value = QByteArray(value_begin, int(pos - value_begin));
+        }
+
+        for (int field = 0; field < FieldsCount; ++ field) {
+            if (key == field_names[field])
+                values[field] = value;
+        }
+
+        skipSpaces(pos, end);
+
+        if (skipSymbol(pos, end, '}'))
+            return true;
+
+        if (!skipSymbol(pos, end, ','))
+            return false;
+    }
+}
+
+//! Фоновый разбор файла расписания.
+class ImportTask : public QRunnable {
+public:
+    //! Конструктор задачи для задания \c job с уведомлением объекта \c receiver.
+    ImportTask(const QSharedPointer<ImportJob> &job, QObject *receiver) :
+        job(job), receiver(receiver)
+    {}
+
+    void run()
+    {
+        QSharedPointer<ImportBatch> batch(new ImportBatch());
+
+        QFile file(job->file_name);
+        if (!file.open(QIODevice::ReadOnly)) {
+            batch->error_string = file.errorString();
+            batch->is_last = true;
+            push(batch);
+            return;
+        }
+
+        TimestampParser timestamp_parser(job->time_spec);
+
+        QList<QByteArray> csv_fields;
+        QByteArray values[FieldsCount];
+        int columns[FieldsCount] = { SectionField, BeginField, EndField, LabelField };
+
+        bool is_first_line = true;
+        quint64 row = 0;
+
+        batch->records.reserve(job->batch_size);
+        batch->labels.reserve(job->batch_size);
+
+        while (!file.atEnd()) {
+            if (job->isCancelled())
+                return;
+
+            QByteArray line = file.readLine();
+            while (line.endsWith('\n') || line.endsWith('\r'))
+                line.chop(1);
+
+            if (line.trimmed().isEmpty())
+                continue;
+
+            bool is_parsed = true;
+
+            if (job->format == ScheduleImporter::FormatCsv) {
+                splitCsvLine(line, job->csv_separator, &csv_fields);
+
+                const bool is_header = is_first_line && parseCsvHeader(csv_fields, columns);
+                is_first_line = false;
+
+                if (is_header)
+                    continue;
+
+                for (int field = 0; field < FieldsCount; ++ field) {
+                    values[field] = ((columns[field] >= 0) && (columns[field] < csv_fields.size()))
+                                    ? csv_fields.at(columns[field])
+                                    : QByteArray();
+                }
+            }
+            else {
+                is_parsed = parseJsonLine(line, values);
+            }
+
+            TimelineRecord record;
+            bool is_section_valid = false;
+
+            if (is_parsed) {
+                record.section = values[SectionField].trimmed().toUInt(&is_section_valid);
+                is_parsed = is_section_valid &&
+                            timestamp_parser.parse(values[BeginField].trimmed(), &record.begin_value) &&
+                            timestamp_parser.parse(values[EndField].trimmed(), &record.end_value) &&
+                            (record.begin_value <= record.end_value);
+            }
+
+            if (!is_parsed) {
+                ++ batch->skipped_count;
+                continue;
+            }
+
+            record.id = row ++;
+
+            batch->records.append(record);
+            batch->labels.append(QString::fromUtf8(values[LabelField].constData(), values[LabelField].size()));
+
+            if (batch->records.size() >= job->batch_size) {
+                batch->bytes_read = file.pos();
+
+                if (!push(batch))
+                    return;
+
+                batch = QSharedPointer<ImportBatch>(new ImportBatch());
+                batch->records.reserve(job->batch_size);
+                batch->labels.reserve(job->batch_size);
+            }
+        }
+
+        if (file.error() != QFile::NoError)
+            batch->error_string = file.errorString();
+
+        batch->bytes_read = file.pos();
+        batch->is_last = true;
+
+        push(batch);
+    }
+private:
+    //! Передача пачки \c batch в поток сцены, false - если импорт прерван.
+    bool push(const QSharedPointer<ImportBatch> &batch)
+    {
+        // ожидание освобождения места в очереди с проверкой прерывания
+        while (!job->free_batches.tryAcquire(1, 100)) {
+            if (job->isCancelled())
+                return false;
+        }
+
+        {
+            QMutexLocker locker(&job->batches_mutex);
+            job->ready_batches.enqueue(batch);
+        }
+
+        QMetaObject::invokeMethod(receiver, "processBatches", Qt::QueuedConnection);
+
+        return true;
+    }
+
+    //! Задание импорта.
+    QSharedPointer<ImportJob> job;
+    //! Объект, уведомляемый о готовых пачках.
+    QObject *receiver;
+};
+
+} // namespace
+
+//! Реализация класса фонового импорта расписания.
+class ScheduleImporterPrivate {
+public:
+    //! Сцена графика.
+    AbstractPlotScene *plot_scene;
+    //! Фабрика элементов графика.
+    AbstractPlotItemFactory *factory;
+
+    //! Количество строк в пачке.
+    int batch_size;
+    //! Наибольшее количество ожидающих пачек.
+    int maximum_pending_batches;
+    //! Разделитель полей CSV.
+    char csv_separator;
+    //! Трактовка времени без смещения.
+    Qt::TimeSpec time_spec;
+
+    //! Количество добавленных строк.
+    qint64 imported_count;
+    //! Количество пропущенных строк.
+    qint64 skipped_count;
+    //! Описание ошибки последнего импорта.
+    QString error_string;
+
+    //! Пул рабочего потока.
+    QThreadPool pool;
+    //! Текущее задание импорта.
+    QSharedPointer<ImportJob> job;
+
+    //! Конструктор.
+    ScheduleImporterPrivate() :
+        plot_scene(0), factory(0),
+        batch_size(2000), maximum_pending_batches(4),
+        csv_separator(','), time_spec(Qt::LocalTime),
+        imported_count(0), skipped_count(0)
+    {
+        pool.setMaxThreadCount(1);
+    }
+};
+
+
+
+ScheduleImporter::ScheduleImporter(QObject *parent) :
+    QObject(parent),
+    d_ptr(new ScheduleImporterPrivate())
+{
+}
+
+ScheduleImporter::~ScheduleImporter()
+{
+    Q_D(ScheduleImporter);
+
+    cancel();
+
+    if (d->factory != 0)
+        delete d->factory;
+
+    delete d_ptr;
+}
+
+AbstractPlotScene *ScheduleImporter::plotScene() const
+{
+    Q_D(const ScheduleImporter);
+    return d->plot_scene;
+}
+
+void ScheduleImporter::setPlotScene(AbstractPlotScene *plot_scene)
+{
+    Q_D(ScheduleImporter);
+    d->plot_scene = plot_scene;
+}
+
+AbstractPlotItemFactory *ScheduleImporter::plotItemFactory() const
+{
+    Q_D(const ScheduleImporter);
+    return d->factory;
+}
+
+void ScheduleImporter::setPlotItemFactory(AbstractPlotItemFactory *factory)
+{
+    Q_D(ScheduleImporter);
+
+    if (d->factory == factory)
+        return;
+
+    if (d->factory != 0)
+        delete d->factory;
+
+    d->factory = factory;
+}
+
+int ScheduleImporter::batchSize() const
+{
+    Q_D(const ScheduleImporter);
+    return d->batch_size;
+}
+
+void ScheduleImporter::setBatchSize(int size)
+{
+    Q_D(ScheduleImporter);
+    d->batch_size = qMax(size, 1);
+}
+
+int ScheduleImporter::maximumPendingBatches() const
+{
+    Q_D(const ScheduleImporter);
+    return d->maximum_pending_batches;
+}
+
+void ScheduleImporter::setMaximumPendingBatches(int count)
+{
+    Q_D(ScheduleImporter);
+    d->maximum_pending_batches = qMax(count, 1);
+}
+
+char ScheduleImporter::csvSeparator() const
+{
+    Q_D(const ScheduleImporter);
+    return d->csv_separator;
+}
+
+void ScheduleImporter::setCsvSeparator(char separator)
+{
+    Q_D(ScheduleImporter);
+    d->csv_separator = separator;
+}
+
+Qt::TimeSpec ScheduleImporter::timeSpec() const
+{
+    Q_D(const ScheduleImporter);
+    return d->time_spec;
+}
+
+void ScheduleImporter::setTimeSpec(Qt::TimeSpec spec)
+{
+    Q_D(ScheduleImporter);
+    d->time_spec = spec;
+}
+
+bool ScheduleImporter::isRunning() const
+{
+    Q_D(const ScheduleImporter);
+    return !d->job.isNull();
+}
+
+qint64 ScheduleImporter::importedCount() const
+{
+    Q_D(const ScheduleImporter);
+    return d->imported_count;
+}
+
+qint64 ScheduleImporter::skippedCount() const
+{
+    Q_D(const ScheduleImporter);
+    return d->skipped_count;
+}
+
+QString ScheduleImporter::errorString() const
+{
+    Q_D(const ScheduleImporter);
+    return d->error_string;
+}
+
+void ScheduleImporter::start(const QString &file_name, Format format)
+{
+    Q_D(ScheduleImporter);
+
+    cancel();
+
+    d->imported_count = 0;
+    d->skipped_count = 0;
+    d->error_string.clear();
+
+    QSharedPointer<ImportJob> job(new ImportJob(d->maximum_pending_batches));
+    job->file_name = file_name;
+    job->format = format;
+    job->csv_separator = d->csv_separator;
+    job->time_spec = d->time_spec;
+    job->batch_size = d->batch_size;
+    job->bytes_total = QFileInfo(file_name).size();
+
+    d->job = job;
+    d->pool.start(new ImportTask(job, this));
+}
+
+void ScheduleImporter::cancel()
+{
+    Q_D(ScheduleImporter);
+
+    if (d->job.isNull())
+        return;
+
+    d->job->is_cancelled.fetchAndStoreOrdered(1);
+    d->pool.waitForDone();
+    d->job.clear();
+}
+
+void ScheduleImporter::processBatches()
+{
+    Q_D(ScheduleImporter);
+
+    // задание удерживается на время обработки: обработчики сигналов могут прервать импорт
+    const QSharedPointer<ImportJob> job = d->job;
+    if (job.isNull())
+        return;
+
+    QQueue<QSharedPointer<ImportBatch> > batches;
+    {
+        QMutexLocker locker(&job->batches_mutex);
+        batches = job->ready_batches;
+        job->ready_batches.clear();
+    }
+
+    foreach (const QSharedPointer<ImportBatch> &batch, batches) {
+        if ((d->plot_scene != 0) && (d->plot_scene->layout() != 0) && (d->factory != 0)) {
+            const Qt::Orientation orientation = d->plot_scene->sceneOrientation();
+
+            QList<AbstractPlotItem *> items;
+            items.reserve(batch->records.size());
+
+            for (int i = 0; i < batch->records.size(); ++ i) {
+                AbstractPlotItem *item = d->factory->createPlotItem(batch->records.at(i), batch->labels.at(i), orientation);
+                if (item != 0)
+                    items.append(item);
+            }
+
+            d->plot_scene->addPlotItems(items);
+            d->imported_count += items.size();
+        }
+
+        d->skipped_count += batch->skipped_count;
+
+        job->free_batches.release();
+
+        if (batch->is_last) {
+            d->error_string = batch->error_string;
+            d->job.clear();
+            d->pool.waitForDone();
+
+            emit progress(batch->bytes_read, job->bytes_total);
+            emit finished(batch->error_string.isEmpty());
+            return;
+        }
+
+        emit progress(batch->bytes_read, job->bytes_total);
+
+        if (d->job != job)
+            return;
+    }
+}
+
+} // namespace Graphics
@@ -1,3 +1,4 @@
+#include <typeinfo>
 #include <cmath>
 #include <QMap>
 
@@ -145,6 +146,18 @@ void SectionScale::setSectionSizeAdjusted(uint section)
     }
 }
 
+double SectionScale::sectionPosition(uint section) const
+{
+    Q_D(const SectionScale);
+    return d->section_position_cache.value(section);
+}
+
+double SectionScale::sectionSize(uint section) const
+{
+    Q_D(const SectionScale);
+    return d->section_size_cache.value(section);
+}
+
 double SectionScale::position(double value) const
 {
     Q_D(const SectionScale);
@@ -161,19 +174,18 @@ double SectionScale::value(double position) const
 
 double SectionScale::position(const AbstractPlotItem *item) const
 {
-    const double section = (orientation() == Qt::Horizontal) ? item->beginCoordinateX()
-                                                             : item->beginCoordinateY();
-
-    const double alignment_offset = (orientation() == Qt::Horizontal) ? item->width() * 0.5
-                                                                      : item->height() * 0.5;
+    return (orientation() == Qt::Horizontal) ? position(item->beginCoordinateX(), item->endCoordinateX(), item->width())
+                                             : position(item->beginCoordinateY(), item->endCoordinateY(), item->height());
+}
 
-    const double section_width = (orientation() == Qt::Horizontal)
-                                 ? distance(item->beginCoordinateX(), item->endCoordinateX())
-                                 : distance(item->beginCoordinateY(), item->endCoordinateY());
+double SectionScale::position(double value_from, double value_to, double extent) const
+{
+    const double alignment_offset = extent * 0.5;
+    const double section_width = distance(value_from, value_to);
 
-    double item_position = position(section);
+    double item_position = position(value_from);
 
-    switch (sectionAlignment(section)) {
+    switch (sectionAlignment(value_from)) {
         case SectionAlignStart:
             item_position = item_position + alignment_offset;
             break;
@@ -205,4 +217,29 @@ QString SectionScale::label(double position) const
     return sectionLabel(value(position));
 }
 
+SectionScale *SectionScale::clone() const
+{
+    Q_D(const SectionScale);
+
+    // копия наследника была бы усечена до SectionScale и иначе отображала бы значения
+    if (typeid(*this) != typeid(SectionScale))
+        return 0;
+
+    SectionScale *scale = new SectionScale();
+    scale->setOrientation(orientation());
+    scale->setPrecision(precision());
+    scale->NumericScale::setLength(length());
+    scale->setRange(minimum(), maximum());
+
+    SectionScalePrivate *clone_d = scale->d_func();
+    clone_d->sections_count = d->sections_count;
+    clone_d->section_label = d->section_label;
+    clone_d->section_alignment = d->section_alignment;
+    clone_d->section_fixed_size = d->section_fixed_size;
+    clone_d->section_size_cache = d->section_size_cache;
+    clone_d->section_position_cache = d->section_position_cache;
+
+    return scale;
+}
+
 } // namespace Graphics
@@ -2,6 +2,8 @@
 #include <QStyleOptionGraphicsItem>
 
 #include "include/standardplotitem.h"
+#include "include/abstractplotscene.h"
+#include "include/plotselectionmodel.h"
 
 
 namespace Graphics {
@@ -41,6 +43,13 @@ class StandardPlotItemPrivate {
 
     //! Деструктор.
     ~StandardPlotItemPrivate() {}
+
+    //! Уведомление сцены о смене координат элемента \c item.
+    void notifyCoordinatesChanged(StandardPlotItem *item)
+    {
+        if (plot_scene != 0)
+            plot_scene->plotItemCoordinatesChanged(item);
+    }
 };
 
 
@@ -82,7 +91,10 @@ double StandardPlotItem::beginCoordinateX() const
 void StandardPlotItem::setBeginCoordinateX(double x)
 {
     Q_D(StandardPlotItem);
-    d->begin_coodrinate_x = x;
+    if (d->begin_coodrinate_x != x) {
+        d->begin_coodrinate_x = x;
+        d->notifyCoordinatesChanged(this);
+    }
 }
 
 double StandardPlotItem::beginCoordinateY() const
@@ -94,7 +106,10 @@ double StandardPlotItem::beginCoordinateY() const
 void StandardPlotItem::setBeginCoordinateY(double y)
 {
     Q_D(StandardPlotItem);
-    d->begin_coodrinate_y = y;
+    if (d->begin_coodrinate_y != y) {
+        d->begin_coodrinate_y = y;
+        d->notifyCoordinatesChanged(this);
+    }
 }
 
 QPointF StandardPlotItem::endCoordinates() const
@@ -123,7 +138,10 @@ double StandardPlotItem::endCoordinateX() const
 void StandardPlotItem::setEndCoordinateX(double x)
 {
     Q_D(StandardPlotItem);
-    d->end_coordinate_x = x;
+    if (d->end_coordinate_x != x) {
+        d->end_coordinate_x = x;
+        d->notifyCoordinatesChanged(this);
+    }
 }
 
 double StandardPlotItem::endCoordinateY() const
@@ -135,7 +153,10 @@ double StandardPlotItem::endCoordinateY() const
 void StandardPlotItem::setEndCoordinateY(double y)
 {
     Q_D(StandardPlotItem);
-    d->end_coordinate_y = y;
+    if (d->end_coordinate_y != y) {
+        d->end_coordinate_y = y;
+        d->notifyCoordinatesChanged(this);
+    }
 }
 
 bool StandardPlotItem::isWidthCalculated() const
@@ -214,10 +235,38 @@ void StandardPlotItem::setPlotScene(AbstractPlotScene *plot_scene)
     d->plot_scene = plot_scene;
 }
 
+bool StandardPlotItem::isPlotSelected() const
+{
+    Q_D(const StandardPlotItem);
+    if ((d->plot_scene != 0) && (d->plot_scene->selectionModel() != 0))
+        return d->plot_scene->selectionModel()->isSelected(this);
+
+    return isSelected();
+}
+
 QRectF StandardPlotItem::boundingRect() const
 {
     Q_D(const StandardPlotItem);
     return QRectF(QPointF(- d->size.width() * 0.5, - d->size.height() * 0.5), d->size);
 }
 
+void StandardPlotItem::drawText(QPainter *painter, const QRectF &rect, int flags, const QString &text)
+{
+    const QTransform &world_transform = painter->worldTransform();
+
+    const double x_factor = (world_transform.m11() > 0.0) ? world_transform.m11() : 1.0;
+    const double y_factor = (world_transform.m22() > 0.0) ? world_transform.m22() : 1.0;
+
+    if ((x_factor == 1.0) && (y_factor == 1.0)) {
+        painter->drawText(rect, flags, text);
+        return;
+    }
+
+    painter->save();
+    painter->scale(1.0 / x_factor, 1.0 / y_factor);
+    painter->drawText(QRectF(rect.x() * x_factor, rect.y() * y_factor,
+                             rect.width() * x_factor, rect.height() * y_factor), flags, text);
+    painter->restore();
+}
+
 } // namespace Graphics
@@ -1,9 +1,15 @@
+#include <typeinfo>
 #include <QList>
+#include <QVector>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include "include/standardplotlayout.h"
 #include "include/abstractplotscene.h"
 #include "include/abstractscale.h"
 #include "include/abstractplotitem.h"
+#include "include/plotstatistics.h"
+#include "include/plotitemgeometry.h"
 
 
 namespace Graphics {
@@ -12,15 +18,154 @@ namespace Graphics {
 class StandardPlotLayoutPrivate {
     friend class StandardPlotLayout;
 
+    //! Расчет геометрии части элементов в рабочем потоке.
+    struct GeometryChunk {
+        //! Тип результата для QtConcurrent.
+        typedef void result_type;
+
+        //! Объект позиционирования.
+        const AbstractPlotLayout *layout;
+        //! Шкала X.
+        const AbstractScale *x_scale;
+        //! Шкала Y.
+        const AbstractScale *y_scale;
+        //! Элементы графика.
+        const QList<AbstractPlotItem *> *items;
+        //! Рассчитанная геометрия элементов.
+        PlotItemGeometry *geometry;
+        //! Индекс первого элемента части.
+        int begin;
+        //! Индекс за последним элементом части.
+        int end;
+
+        //! Расчет геометрии элементов части \c chunk.
+        void operator()(const GeometryChunk &chunk) const;
+    };
+
     //! Графическая сцена.
     AbstractPlotScene *plot_scene;
 
+    //! Флаг расчета геометрии элементов в рабочих потоках.
+    bool is_concurrent;
+    //! Минимальное количество элементов для расчета в рабочих потоках.
+    int concurrent_threshold;
+
     //! Конструктор.
-    StandardPlotLayoutPrivate() : plot_scene(0) {}
+    StandardPlotLayoutPrivate() :
+        plot_scene(0),
+        is_concurrent(false),
+        concurrent_threshold(10000)
+    {}
     //! Деструктор.
     ~StandardPlotLayoutPrivate() {}
+
+    /*!
+     * \brief Проверка того, что объект \c layout - в точности StandardPlotLayout.
+     *
+     * Наследник может переопределить refresh(AbstractPlotItem*) или geometry(), поэтому
+     * общий проход по элементам и расчет в рабочих потоках применяются только без наследования.
+     */
+    static bool isExactType(const StandardPlotLayout *layout)
+    {
+        return typeid(*layout) == typeid(StandardPlotLayout);
+    }
+
+    //! Проверка наличия сцены и обеих шкал.
+    bool hasScales() const
+    {
+        return (plot_scene != 0) && (plot_scene->xScale() != 0) && (plot_scene->yScale() != 0);
+    }
+
+    //! Пересчет позиции элемента \c item.
+    void layoutItem(AbstractPlotItem *item);
+    //! Пересчет позиций элементов \c items объектом \c layout.
+    void layoutItems(const AbstractPlotLayout *layout, const QList<AbstractPlotItem *> &items);
+    //! Пересчет позиций элементов \c items объектом \c layout с расчетом геометрии в рабочих потоках.
+    void layoutItemsConcurrent(const AbstractPlotLayout *layout, const QList<AbstractPlotItem *> &items);
 };
 
+void StandardPlotLayoutPrivate::GeometryChunk::operator()(const GeometryChunk &chunk) const
+{
+    for (int i = chunk.begin; i < chunk.end; ++ i) {
+        const AbstractPlotItem *item = chunk.items->at(i);
+        if (item != 0)
+            chunk.geometry[i] = chunk.layout->geometry(PlotItemValues(item), chunk.x_scale, chunk.y_scale);
+    }
+}
+
+void StandardPlotLayoutPrivate::layoutItem(AbstractPlotItem *item)
+{
+    if (item->isWidthCalculated()) {
+        const double item_width = plot_scene->xScale()->distance(item->beginCoordinateX(),
+                                                                 item->endCoordinateX());
+        item->setWidth(item_width);
+    }
+
+    if (item->isHeightCalculated()) {
+        const double item_height = plot_scene->yScale()->distance(item->beginCoordinateY(),
+                                                                  item->endCoordinateY());
+        item->setHeight(item_height);
+    }
+
+    const double item_pos_x = plot_scene->xScale()->position(item);
+    const double item_pos_y = plot_scene->yScale()->position(item);
+
+    item->setPos(item_pos_x, item_pos_y);
+
+    item->update();
+}
+
+void StandardPlotLayoutPrivate::layoutItems(const AbstractPlotLayout *layout, const QList<AbstractPlotItem *> &items)
+{
+    if (is_concurrent && (items.size() >= concurrent_threshold)) {
+        layoutItemsConcurrent(layout, items);
+        return;
+    }
+
+    foreach (AbstractPlotItem *item, items) {
+        if (item != 0)
+            layoutItem(item);
+    }
+
+    GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), ItemsLaidOut, items.size());
+}
+
+void StandardPlotLayoutPrivate::layoutItemsConcurrent(const AbstractPlotLayout *layout,
+                                                      const QList<AbstractPlotItem *> &items)
+{
+    QVector<PlotItemGeometry> geometry(items.size());
+
+    // части с запасом относительно числа потоков, чтобы потоки не простаивали на неравных частях
+    const int chunks_count = qMax(1, QThread::idealThreadCount() * 4);
+    const int chunk_size = qMax(1, (items.size() + chunks_count - 1) / chunks_count);
+
+    QVector<GeometryChunk> chunks;
+    chunks.reserve(chunks_count);
+
+    for (int begin = 0; begin < items.size(); begin += chunk_size) {
+        GeometryChunk chunk;
+        chunk.layout = layout;
+        chunk.x_scale = plot_scene->xScale();
+        chunk.y_scale = plot_scene->yScale();
+        chunk.items = &items;
+        chunk.geometry = geometry.data();
+        chunk.begin = begin;
+        chunk.end = qMin(begin + chunk_size, items.size());
+        chunks.append(chunk);
+    }
+
+    // шкалы и элементы в рабочих потоках только читаются, изменение элементов - в потоке GUI
+    QtConcurrent::blockingMap(chunks, GeometryChunk());
+
+    for (int i = 0; i < items.size(); ++ i) {
+        AbstractPlotItem *item = items.at(i);
+        if (item != 0)
+            geometry.at(i).applyTo(item);
+    }
+
+    GRAPHICS_STATISTICS_COUNT(plot_scene->statistics(), ItemsLaidOut, items.size());
+}
+
 
 
 StandardPlotLayout::StandardPlotLayout() :
@@ -46,50 +191,88 @@ void StandardPlotLayout::setPlotScene(AbstractPlotScene *plot_scene)
     d->plot_scene = plot_scene;
 }
 
+bool StandardPlotLayout::isConcurrent() const
+{
+    Q_D(const StandardPlotLayout);
+    return d->is_concurrent;
+}
+
+void StandardPlotLayout::setConcurrent(bool on)
+{
+    Q_D(StandardPlotLayout);
+    d->is_concurrent = on;
+}
+
+int StandardPlotLayout::concurrentThreshold() const
+{
+    Q_D(const StandardPlotLayout);
+    return d->concurrent_threshold;
+}
+
+void StandardPlotLayout::setConcurrentThreshold(int count)
+{
+    Q_D(StandardPlotLayout);
+    d->concurrent_threshold = qMax(1, count);
+}
+
+bool StandardPlotLayout::isGeometryReentrant() const
+{
+    return StandardPlotLayoutPrivate::isExactType(this);
+}
+
 void StandardPlotLayout::refresh()
 {
     Q_D(StandardPlotLayout);
 
-    if (d->plot_scene == 0)
+    if (!d->hasScales())
         return;
 
-    if ((d->plot_scene->xScale() == 0) || (d->plot_scene->yScale() == 0))
-        return;
+    GRAPHICS_STATISTICS_COUNT(d->plot_scene->statistics(), LayoutRefreshes, 1);
+    GRAPHICS_STATISTICS_TIMER(d->plot_scene->statistics(), LayoutTime);
+
+    const AbstractScale *x_scale = d->plot_scene->xScale();
+    const AbstractScale *y_scale = d->plot_scene->yScale();
+
+    d->plot_scene->setSceneRect(x_scale->minimumPosition(), y_scale->minimumPosition(),
+                                x_scale->length(), y_scale->length());
 
-    d->plot_scene->setSceneRect(0.0, 0.0, d->plot_scene->xScale()->length(), d->plot_scene->yScale()->length());
+    if (!StandardPlotLayoutPrivate::isExactType(this)) {
+        foreach (AbstractPlotItem *item, d->plot_scene->plotItems())
+            refresh(item);
+        return;
+    }
 
-    foreach (AbstractPlotItem *item, d->plot_scene->plotItems())
-        refresh(item);
+    d->layoutItems(this, d->plot_scene->plotItems());
 }
 
 void StandardPlotLayout::refresh(AbstractPlotItem *item)
 {
     Q_D(StandardPlotLayout);
 
-    if ((d->plot_scene == 0) || (item == 0))
+    if (!d->hasScales() || (item == 0))
         return;
 
-    if ((d->plot_scene->xScale() == 0) || (d->plot_scene->yScale() == 0))
-        return;
+    d->layoutItem(item);
 
-    if (item->isWidthCalculated()) {
-        const double item_width = d->plot_scene->xScale()->distance(item->beginCoordinateX(),
-                                                                    item->endCoordinateX());
-        item->setWidth(item_width);
-    }
+    GRAPHICS_STATISTICS_COUNT(d->plot_scene->statistics(), ItemsLaidOut, 1);
+}
 
-    if (item->isHeightCalculated()) {
-        const double item_height = d->plot_scene->yScale()->distance(item->beginCoordinateY(),
-                                                                     item->endCoordinateY());
-        item->setHeight(item_height);
-    }
+void StandardPlotLayout::refresh(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(StandardPlotLayout);
+
+    if (!d->hasScales())
+        return;
 
-    const double item_pos_x = d->plot_scene->xScale()->position(item);
-    const double item_pos_y = d->plot_scene->yScale()->position(item);
+    GRAPHICS_STATISTICS_TIMER(d->plot_scene->statistics(), LayoutTime);
 
-    item->setPos(item_pos_x, item_pos_y);
+    if (!StandardPlotLayoutPrivate::isExactType(this)) {
+        foreach (AbstractPlotItem *item, items)
+            refresh(item);
+        return;
+    }
 
-    item->update();
+    d->layoutItems(this, items);
 }
 
 } // namespace Graphics
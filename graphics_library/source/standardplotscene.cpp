@@ -1,14 +1,107 @@
+#include <cmath>
+#include <algorithm>
+#include <QSet>
+#include <QVector>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include <QGraphicsView>
+#include <QGraphicsSceneMouseEvent>
+#include <QGraphicsSceneHoverEvent>
+
 #include "include/standardplotscene.h"
 #include "include/abstractscale.h"
+#include "include/abstractscaleengine.h"
+#include "include/sectionscale.h"
 #include "include/abstractplotlayout.h"
 #include "include/abstractplotitem.h"
+#include "include/plotitemindex.h"
+#include "include/plotstatistics.h"
+#include "include/plotitemgeometry.h"
+#include "include/plotitemupdatequeue.h"
+#include "include/interactiveplotitem.h"
+#include "include/plotselectionmodel.h"
 
 
 namespace Graphics {
 
+namespace {
+
+//! Задание фонового пересчета геометрии элементов.
+struct DeferredLayoutJob {
+    //! Номер пересчета.
+    int generation;
+    //! Номер последнего запрошенного пересчета.
+    QAtomicInt *current_generation;
+
+    //! Объект позиционирования.
+    const AbstractPlotLayout *layout;
+    //! Копия шкалы X.
+    AbstractScale *x_scale;
+    //! Копия шкалы Y.
+    AbstractScale *y_scale;
+
+    //! Пересчитываемые элементы (в фоновом потоке не используются).
+    QList<AbstractPlotItem *> items;
+    //! Значения элементов.
+    QVector<PlotItemValues> values;
+    //! Рассчитанная геометрия элементов.
+    QVector<PlotItemGeometry> geometry;
+
+    //! Конструктор.
+    DeferredLayoutJob() : generation(0), current_generation(0), layout(0), x_scale(0), y_scale(0) {}
+    //! Деструктор.
+    ~DeferredLayoutJob()
+    {
+        delete x_scale;
+        delete y_scale;
+    }
+
+    //! Проверка на появление более позднего пересчета.
+    bool isStale() const { return current_generation->fetchAndAddOrdered(0) != generation; }
+};
+
+//! Фоновый пересчет геометрии элементов.
+class DeferredLayoutTask : public QRunnable {
+public:
+    //! Конструктор задачи для задания \c job с уведомлением объекта \c receiver.
+    DeferredLayoutTask(const QSharedPointer<DeferredLayoutJob> &job, QObject *receiver) :
+        job(job), receiver(receiver)
+    {}
+
+    void run()
+    {
+        // устаревшее задание бросается, не дожидаясь конца расчета
+        const int stale_check_step = 1024;
+
+        job->geometry.resize(job->values.size());
+
+        for (int i = 0; i < job->values.size(); ++ i) {
+            if (((i % stale_check_step) == 0) && job->isStale())
+                return;
+
+            job->geometry[i] = job->layout->geometry(job->values.at(i), job->x_scale, job->y_scale);
+        }
+
+        QMetaObject::invokeMethod(receiver, "applyDeferredLayout", Qt::QueuedConnection,
+                                  Q_ARG(int, job->generation));
+    }
+private:
+    //! Задание пересчета.
+    QSharedPointer<DeferredLayoutJob> job;
+    //! Объект, уведомляемый о завершении пересчета.
+    QObject *receiver;
+};
+
+} // namespace
+
 //! Реализация класса сцены графика.
 class StandardPlotScenePrivate {
-    friend class StandardPlotScene;
+    Q_DECLARE_PUBLIC(StandardPlotScene)
+
+    //! Указатель на объявление.
+    StandardPlotScene *q_ptr;
 
     //! Шкала X.
     AbstractScale *x_scale;
@@ -21,8 +114,15 @@ class StandardPlotScenePrivate {
     //! Ориентация сцены.
     Qt::Orientation orientation;
 
+    //! Способ масштабирования.
+    AbstractPlotScene::ZoomMode zoom_mode;
+
     //! Приращение масштабирования.
     double zoom_extent;
+    //! Длина активной шкалы в начале масштабирования преобразованием.
+    double zoom_length;
+    //! Приращение масштабирования преобразованием в единицах сцены.
+    double zoom_transform_extent;
 
     //! Текущий шаг масштабирования.
     int zoom_step;
@@ -33,34 +133,626 @@ class StandardPlotScenePrivate {
 
     //! Графические элементы.
     QList<AbstractPlotItem *> plot_items;
-
-    //! Конструктор.
-    StandardPlotScenePrivate() :
+    //! Элементы, координаты которых зависят от диапазона шкал.
+    QList<AbstractPlotItem *> range_dependent_items;
+
+    //! Способ индексации элементов.
+    StandardPlotScene::PlotIndexMethod index_method;
+    //! Глубина BSP-дерева.
+    int index_bsp_depth;
+
+    //! Индекс элементов в пространстве значений шкал.
+    mutable PlotItemIndex item_index;
+    //! Элементы, координаты которых сменились после последнего обновления индекса значений.
+    mutable QSet<AbstractPlotItem *> stale_items;
+
+    //! Статистика работы графика.
+    PlotStatistics statistics;
+
+    //! Пул потока фонового пересчета геометрии.
+    QThreadPool deferred_pool;
+    //! Номер последнего запрошенного пересчета геометрии.
+    QAtomicInt layout_generation;
+    //! Незавершенный фоновый пересчет геометрии.
+    QSharedPointer<DeferredLayoutJob> deferred_job;
+
+    //! Элементы, добавленные во время предпросмотра отложенного пересчета и скрытые до его применения.
+    QList<AbstractPlotItem *> deferred_items;
+
+    //! Минимальное значение активной шкалы при расчете текущей геометрии элементов.
+    double laid_out_minimum;
+    //! Максимальное значение активной шкалы при расчете текущей геометрии элементов.
+    double laid_out_maximum;
+    //! Длина активной шкалы при расчете текущей геометрии элементов.
+    double laid_out_length;
+    //! Значение в нулевой позиции активной шкалы при расчете текущей геометрии элементов.
+    double laid_out_origin;
+
+    //! Очередь изменений элементов.
+    PlotItemUpdateQueue *update_queue;
+
+    //! Флаг поиска элемента под курсором сценой.
+    bool is_hover_resolved;
+    //! Элемент под курсором.
+    AbstractPlotItem *hovered_item;
+    //! Положение курсора на сцене в последнем событии наведения.
+    QPointF hover_scene_pos;
+    //! Положение курсора на экране в последнем событии наведения.
+    QPoint hover_screen_pos;
+    //! Модификаторы клавиатуры в последнем событии наведения.
+    Qt::KeyboardModifiers hover_modifiers;
+
+    //! Модель выделения элементов.
+    PlotSelectionModel *selection_model;
+    //! Флаг выделения элементов моделью выделения.
+    bool is_selection_model_enabled;
+
+    //! Перетаскиваемый элемент с координатами до начала перетаскивания.
+    struct MovedItem {
+        //! Элемент.
+        AbstractPlotItem *item;
+        //! Координаты начала элемента до перетаскивания.
+        QPointF begin_coordinates;
+        //! Координаты конца элемента до перетаскивания.
+        QPointF end_coordinates;
+    };
+
+    //! Флаг перемещения элементов в значениях шкал.
+    bool is_value_move_enabled;
+    //! Движок шкалы для привязки перемещаемых элементов.
+    AbstractScaleEngine *snap_engine;
+    //! Перетаскиваемые элементы (первый - элемент под курсором).
+    QList<MovedItem> moved_items;
+    //! Значения шкал в точке начала перетаскивания.
+    QPointF move_origin;
+    //! Примененное смещение перетаскиваемых элементов.
+    QPointF move_delta;
+
+    //! Накопленная область сцены, требующая перерисовки.
+    QRectF damage_rect;
+
+    //! Конструктор с указателем на объявление \c q.
+    StandardPlotScenePrivate(StandardPlotScene *q) :
+        q_ptr(q),
         x_scale(0), y_scale(0),
         layout(0),
         orientation(Qt::Horizontal),
+        zoom_mode(AbstractPlotScene::ZoomRelayout),
         zoom_extent(100.0),
+        zoom_length(0.0),
+        zoom_transform_extent(0.0),
         zoom_step(0),
         minimum_zoom_step(-20),
-        maximum_zoom_step(20)
-    {}
+        maximum_zoom_step(20),
+        index_method(StandardPlotScene::PlotIndexBspTree),
+        index_bsp_depth(0),
+        layout_generation(0),
+        laid_out_minimum(0.0), laid_out_maximum(0.0), laid_out_length(0.0), laid_out_origin(0.0),
+        update_queue(0),
+        is_hover_resolved(false),
+        hovered_item(0),
+        hover_modifiers(Qt::NoModifier),
+        selection_model(0),
+        is_selection_model_enabled(false),
+        is_value_move_enabled(false),
+        snap_engine(0)
+    {
+        deferred_pool.setMaxThreadCount(1);
+    }
 
     //! Деструктор.
     ~StandardPlotScenePrivate() {}
+
+    //! Шкала, вдоль которой выполняется масштабирование.
+    AbstractScale *activeScale() const
+    { return (orientation == Qt::Horizontal) ? x_scale : y_scale; }
+
+    //! Применение способа индексации к графической сцене.
+    void applyIndexMethod();
+
+    /*!
+     * \brief Приостановка индексации сцены на время изменения \c changed_count элементов (-1 - всех).
+     *
+     * Возвращает true, если индексация приостановлена и ее нужно возобновить.
+     */
+    bool suspendSceneIndex(int changed_count = -1);
+    //! Возобновление индексации сцены, если она была приостановлена (\c suspended).
+    void resumeSceneIndex(bool suspended);
+
+    //! Актуальный индекс элементов в пространстве значений шкал.
+    const PlotItemIndex &valueIndex() const;
+
+    //! Отмена фонового пересчета геометрии с ожиданием его остановки.
+    void cancelDeferredLayout();
+    //! Запоминание состояния активной шкалы \c active_scale, для которого рассчитана геометрия элементов.
+    void rememberLayout(const AbstractScale *active_scale);
+    //! Растяжение прежней геометрии элементов до текущего состояния активной шкалы.
+    QTransform previewTransform() const;
+    //! Показ элементов, скрытых до применения отложенного пересчета, с расчетом их положения при \c lay_out.
+    void releaseDeferredItems(bool lay_out);
+
+    //! Элемент с типом взаимодействия InteractionHover в точке сцены \c scene_pos.
+    AbstractPlotItem *hoverItemAt(const QPointF &scene_pos) const;
+    //! Отправка элементу \c item события наведения курсора типа \c type по событию мыши \c mouse_event.
+    void sendHoverEvent(AbstractPlotItem *item, QEvent::Type type, const QGraphicsSceneMouseEvent *mouse_event);
+    //! Отправка события выхода курсора элементу под курсором.
+    void leaveHoveredItem();
+
+    //! Проверка наличия у элемента \c item типа взаимодействия InteractionHover.
+    static bool isHoverable(const AbstractPlotItem *item);
+    //! Проверка наличия у элемента \c item типа взаимодействия InteractionMove.
+    static bool isMovable(const AbstractPlotItem *item);
+
+    //! Изменение выделения по нажатию в точке сцены \c scene_pos с модификаторами клавиатуры \c modifiers.
+    void selectAt(const QPointF &scene_pos, Qt::KeyboardModifiers modifiers);
+
+    //! Начало перетаскивания элементов из точки сцены \c scene_pos, возвращает false, если перемещать нечего.
+    bool beginValueMove(const QPointF &scene_pos);
+    //! Смещение перетаскиваемых элементов в значениях шкал для точки сцены \c scene_pos с учетом привязки.
+    QPointF valueMoveDelta(const QPointF &scene_pos) const;
+    //! Смещение перетаскиваемых элементов на \c delta с пересчетом только их положения.
+    void applyValueMove(const QPointF &delta);
+    //! Завершение перетаскивания с обновлением индекса значений.
+    void endValueMove();
+
+    //! Исключение удаляемого с графика элемента \c item из состояния взаимодействия.
+    void forgetItem(AbstractPlotItem *item);
+    //! Повторное применение флагов взаимодействия элементов после смены режима сцены.
+    void updateInteractionFlags();
+
+    //! Добавление текущей области элемента \c item к области перерисовки.
+    void addDamage(const AbstractPlotItem *item);
+    //! Добавление текущих областей элементов \c items к области перерисовки.
+    void addDamage(const QList<AbstractPlotItem *> &items);
+    //! Перерисовка накопленной области сцены.
+    void flushDamage();
+
+    //! Упорядочивание элементов \c items по возрастанию z-координаты.
+    static void sortByZValue(QList<AbstractPlotItem *> *items);
+    //! Сравнение элементов \c left и \c right по z-координате.
+    static bool lessZValue(const AbstractPlotItem *left, const AbstractPlotItem *right);
 };
 
+void StandardPlotScenePrivate::applyIndexMethod()
+{
+    Q_Q(StandardPlotScene);
+
+    item_index.setRowBucketed(index_method == StandardPlotScene::PlotIndexRows);
+
+    if (index_method == StandardPlotScene::PlotIndexBspTree) {
+        q->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+        q->setBspTreeDepth(index_bsp_depth);
+    }
+    else {
+        q->setItemIndexMethod(QGraphicsScene::NoIndex);
+    }
+}
+
+bool StandardPlotScenePrivate::suspendSceneIndex(int changed_count)
+{
+    Q_Q(StandardPlotScene);
+
+    if ((index_method != StandardPlotScene::PlotIndexBspTree) ||
+        (q->itemIndexMethod() != QGraphicsScene::BspTreeIndex))
+        return false;
+
+    // BSP-дерево обновляется при каждом setPos/prepareGeometryChange, но при возобновлении
+    // строится заново по всем элементам сцены, поэтому отключается только при изменении
+    // значительной части элементов; небольшие пакеты (например, при поэтапном заполнении)
+    // обновляют дерево по элементу
+    if ((changed_count >= 0) && ((changed_count * 4) < plot_items.size()))
+        return false;
+
+    q->setItemIndexMethod(QGraphicsScene::NoIndex);
+    return true;
+}
+
+void StandardPlotScenePrivate::resumeSceneIndex(bool suspended)
+{
+    if (suspended)
+        applyIndexMethod();
+}
+
+const PlotItemIndex &StandardPlotScenePrivate::valueIndex() const
+{
+    item_index.setOrientation(orientation);
+
+    if (!stale_items.isEmpty()) {
+        foreach (AbstractPlotItem *item, stale_items)
+            item_index.update(item);
+        stale_items.clear();
+    }
+
+    return item_index;
+}
+
+void StandardPlotScenePrivate::cancelDeferredLayout()
+{
+    layout_generation.fetchAndAddOrdered(1);
+    deferred_job.clear();
+    deferred_pool.waitForDone();
+}
+
+void StandardPlotScenePrivate::rememberLayout(const AbstractScale *active_scale)
+{
+    if (active_scale == 0)
+        return;
+
+    laid_out_minimum = active_scale->minimum();
+    laid_out_maximum = active_scale->maximum();
+    laid_out_length = active_scale->length();
+    laid_out_origin = active_scale->origin();
+}
+
+QTransform StandardPlotScenePrivate::previewTransform() const
+{
+    AbstractScale *active_scale = activeScale();
+    if (active_scale == 0)
+        return QTransform();
+
+    const double laid_out_range = laid_out_maximum - laid_out_minimum;
+    const double range = active_scale->maximum() - active_scale->minimum();
+
+    if ((laid_out_length <= 0.0) || (laid_out_range == 0.0) || (range == 0.0))
+        return QTransform();
+
+    // для линейной шкалы новое положение выражается через прежнее растяжением и сдвигом
+    const double unit_length = active_scale->length() / range;
+    const double factor = unit_length / (laid_out_length / laid_out_range);
+    const double offset = (laid_out_origin - active_scale->origin()) * unit_length;
+
+    return (orientation == Qt::Horizontal) ? QTransform(factor, 0.0, 0.0, 1.0, offset, 0.0)
+                                           : QTransform(1.0, 0.0, 0.0, factor, 0.0, offset);
+}
+
+void StandardPlotScenePrivate::releaseDeferredItems(bool lay_out)
+{
+    if (deferred_items.isEmpty())
+        return;
+
+    const QList<AbstractPlotItem *> items = deferred_items;
+    deferred_items.clear();
+
+    if (lay_out && (layout != 0))
+        layout->refresh(items);
+
+    foreach (AbstractPlotItem *item, items)
+        item->setVisible(true);
+}
+
+AbstractPlotItem *StandardPlotScenePrivate::hoverItemAt(const QPointF &scene_pos) const
+{
+    Q_Q(const StandardPlotScene);
+
+    // пока курсор остается в последнем найденном элементе, индекс не запрашивается
+    if ((hovered_item != 0) && hovered_item->isVisible() &&
+        hovered_item->contains(hovered_item->mapFromScene(scene_pos)))
+        return hovered_item;
+
+    if ((x_scale == 0) || (y_scale == 0))
+        return 0;
+
+    AbstractPlotItem *hit_item = 0;
+
+    foreach (AbstractPlotItem *item, valueIndex().items(q->mapToScales(scene_pos))) {
+        if ((hit_item != 0) && (item->zValue() < hit_item->zValue()))
+            continue;
+
+        if (item->isVisible() && isHoverable(item) && item->contains(item->mapFromScene(scene_pos)))
+            hit_item = item;
+    }
+
+    return hit_item;
+}
+
+void StandardPlotScenePrivate::sendHoverEvent(AbstractPlotItem *item, QEvent::Type type,
+                                              const QGraphicsSceneMouseEvent *mouse_event)
+{
+    Q_Q(StandardPlotScene);
+
+    QGraphicsSceneHoverEvent hover_event(type);
+    hover_event.setWidget(mouse_event->widget());
+    hover_event.setScenePos(mouse_event->scenePos());
+    hover_event.setLastScenePos(mouse_event->lastScenePos());
+    hover_event.setScreenPos(mouse_event->screenPos());
+    hover_event.setLastScreenPos(mouse_event->lastScreenPos());
+    hover_event.setPos(item->mapFromScene(mouse_event->scenePos()));
+    hover_event.setLastPos(item->mapFromScene(mouse_event->lastScenePos()));
+    hover_event.setModifiers(mouse_event->modifiers());
+
+    hover_scene_pos = mouse_event->scenePos();
+    hover_screen_pos = mouse_event->screenPos();
+    hover_modifiers = mouse_event->modifiers();
+
+    q->sendEvent(item, &hover_event);
+}
+
+void StandardPlotScenePrivate::leaveHoveredItem()
+{
+    Q_Q(StandardPlotScene);
+
+    if (hovered_item == 0)
+        return;
+
+    AbstractPlotItem *item = hovered_item;
+    hovered_item = 0;
+
+    // событие выхода не связано с событием мыши, поэтому положение берется из последнего наведения
+    QGraphicsSceneHoverEvent hover_event(QEvent::GraphicsSceneHoverLeave);
+    hover_event.setScenePos(hover_scene_pos);
+    hover_event.setLastScenePos(hover_scene_pos);
+    hover_event.setScreenPos(hover_screen_pos);
+    hover_event.setLastScreenPos(hover_screen_pos);
+    hover_event.setPos(item->mapFromScene(hover_scene_pos));
+    hover_event.setLastPos(item->mapFromScene(hover_scene_pos));
+    hover_event.setModifiers(hover_modifiers);
+
+    q->sendEvent(item, &hover_event);
+}
+
+bool StandardPlotScenePrivate::isHoverable(const AbstractPlotItem *item)
+{
+    const InteractivePlotItem *interactive_item = dynamic_cast<const InteractivePlotItem *>(item);
+    return (interactive_item != 0) && interactive_item->interactionFlags().testFlag(InteractionHover);
+}
+
+bool StandardPlotScenePrivate::isMovable(const AbstractPlotItem *item)
+{
+    const InteractivePlotItem *interactive_item = dynamic_cast<const InteractivePlotItem *>(item);
+    return (interactive_item != 0) && interactive_item->interactionFlags().testFlag(InteractionMove);
+}
+
+void StandardPlotScenePrivate::selectAt(const QPointF &scene_pos, Qt::KeyboardModifiers modifiers)
+{
+    Q_Q(StandardPlotScene);
+
+    AbstractPlotItem *hit_item = 0;
+
+    if ((x_scale != 0) && (y_scale != 0)) {
+        foreach (AbstractPlotItem *item, valueIndex().items(q->mapToScales(scene_pos))) {
+            if ((hit_item != 0) && (item->zValue() < hit_item->zValue()))
+                continue;
+
+            if (item->isVisible() && PlotSelectionModel::isSelectable(item) &&
+                item->contains(item->mapFromScene(scene_pos)))
+                hit_item = item;
+        }
+    }
+
+    // как в QGraphicsScene: Ctrl инвертирует выделение, нажатие на выделенный элемент
+    // сохраняет выделение для перетаскивания группы, нажатие вне элементов снимает его
+    const bool is_toggled = modifiers.testFlag(Qt::ControlModifier);
+
+    if (hit_item == 0) {
+        if (!is_toggled)
+            selection_model->clear();
+    }
+    else if (is_toggled)
+        selection_model->select(hit_item, PlotSelectionModel::Toggle);
+    else if (!selection_model->isSelected(hit_item))
+        selection_model->select(hit_item, PlotSelectionModel::ClearAndSelect);
+}
+
+bool StandardPlotScenePrivate::beginValueMove(const QPointF &scene_pos)
+{
+    Q_Q(StandardPlotScene);
+
+    if ((layout == 0) || (x_scale == 0) || (y_scale == 0))
+        return false;
+
+    const QPointF scale_values = q->mapToScales(scene_pos);
+
+    AbstractPlotItem *hit_item = 0;
+
+    foreach (AbstractPlotItem *item, valueIndex().items(scale_values)) {
+        if ((hit_item != 0) && (item->zValue() < hit_item->zValue()))
+            continue;
+
+        if (item->isVisible() && isMovable(item) && item->contains(item->mapFromScene(scene_pos)))
+            hit_item = item;
+    }
+
+    if (hit_item == 0)
+        return false;
+
+    QList<AbstractPlotItem *> items;
+    items.append(hit_item);
+
+    // выделенный элемент перетаскивается вместе с остальными выделенными
+    if (is_selection_model_enabled) {
+        if (selection_model->isSelected(hit_item)) {
+            foreach (AbstractPlotItem *item, selection_model->selectedItems()) {
+                if ((item != hit_item) && isMovable(item))
+                    items.append(item);
+            }
+        }
+    }
+    else if (hit_item->isSelected()) {
+        foreach (QGraphicsItem *graphics_item, q->selectedItems()) {
+            AbstractPlotItem *item = dynamic_cast<AbstractPlotItem *>(graphics_item);
+            if ((item != 0) && (item != hit_item) && isMovable(item))
+                items.append(item);
+        }
+    }
+
+    moved_items.clear();
+    moved_items.reserve(items.size());
+
+    foreach (AbstractPlotItem *item, items) {
+        MovedItem moved_item;
+        moved_item.item = item;
+        moved_item.begin_coordinates = item->beginCoordinates();
+        moved_item.end_coordinates = item->endCoordinates();
+        moved_items.append(moved_item);
+    }
+
+    move_origin = scale_values;
+    move_delta = QPointF();
+
+    return true;
+}
+
+QPointF StandardPlotScenePrivate::valueMoveDelta(const QPointF &scene_pos) const
+{
+    Q_Q(const StandardPlotScene);
+
+    const QPointF delta = q->mapToScales(scene_pos) - move_origin;
+
+    const bool is_horizontal = (orientation == Qt::Horizontal);
+
+    double scroll_delta = is_horizontal ? delta.x() : delta.y();
+    double section_delta = is_horizontal ? delta.y() : delta.x();
+
+    // к засечке привязывается начало элемента под курсором, остальные смещаются так же
+    if (snap_engine != 0) {
+        const QPointF &anchor_begin = moved_items.first().begin_coordinates;
+        const double anchor_value = is_horizontal ? anchor_begin.x() : anchor_begin.y();
+
+        scroll_delta = snap_engine->snapped(anchor_value + scroll_delta) - anchor_value;
+    }
+
+    const AbstractScale *section_scale = is_horizontal ? y_scale : x_scale;
+    if (dynamic_cast<const SectionScale *>(section_scale) != 0)
+        section_delta = floor(section_delta + 0.5);
+
+    return is_horizontal ? QPointF(scroll_delta, section_delta)
+                         : QPointF(section_delta, scroll_delta);
+}
+
+void StandardPlotScenePrivate::applyValueMove(const QPointF &delta)
+{
+    if (delta == move_delta)
+        return;
+
+    move_delta = delta;
+
+    QList<AbstractPlotItem *> items;
+    items.reserve(moved_items.size());
+
+    foreach (const MovedItem &moved_item, moved_items) {
+        moved_item.item->setBeginCoordinates(moved_item.begin_coordinates + delta);
+        moved_item.item->setEndCoordinates(moved_item.end_coordinates + delta);
+        items.append(moved_item.item);
+    }
+
+    addDamage(items);
+    layout->refresh(items);
+    addDamage(items);
+    flushDamage();
+}
+
+void StandardPlotScenePrivate::endValueMove()
+{
+    Q_Q(StandardPlotScene);
+
+    QList<AbstractPlotItem *> items;
+    items.reserve(moved_items.size());
+
+    foreach (const MovedItem &moved_item, moved_items)
+        items.append(moved_item.item);
+
+    moved_items.clear();
+
+    if (move_delta.isNull())
+        return;
+
+    foreach (AbstractPlotItem *item, items)
+        item_index.update(item);
+
+    q->plotItemsMoved(items);
+}
+
+void StandardPlotScenePrivate::forgetItem(AbstractPlotItem *item)
+{
+    if (item == hovered_item)
+        hovered_item = 0;
+
+    if (deferred_items.removeOne(item))
+        item->setVisible(true);
+
+    stale_items.remove(item);
+
+    if (item->isScaleRangeDependent())
+        range_dependent_items.removeOne(item);
+
+    for (int i = moved_items.size() - 1; i >= 0; -- i) {
+        if (moved_items.at(i).item == item)
+            moved_items.removeAt(i);
+    }
+}
+
+void StandardPlotScenePrivate::updateInteractionFlags()
+{
+    foreach (AbstractPlotItem *item, plot_items) {
+        InteractivePlotItem *interactive_item = dynamic_cast<InteractivePlotItem *>(item);
+        if (interactive_item != 0)
+            interactive_item->setInteractionFlags(interactive_item->interactionFlags());
+    }
+}
+
+void StandardPlotScenePrivate::addDamage(const AbstractPlotItem *item)
+{
+    if (item->isVisible())
+        damage_rect |= item->sceneBoundingRect();
+}
+
+void StandardPlotScenePrivate::addDamage(const QList<AbstractPlotItem *> &items)
+{
+    foreach (const AbstractPlotItem *item, items)
+        addDamage(item);
+}
+
+void StandardPlotScenePrivate::flushDamage()
+{
+    Q_Q(StandardPlotScene);
+
+    if (damage_rect.isNull())
+        return;
+
+    q->update(damage_rect);
+    damage_rect = QRectF();
+}
+
+void StandardPlotScenePrivate::sortByZValue(QList<AbstractPlotItem *> *items)
+{
+    std::stable_sort(items->begin(), items->end(), lessZValue);
+}
+
+bool StandardPlotScenePrivate::lessZValue(const AbstractPlotItem *left, const AbstractPlotItem *right)
+{
+    return left->zValue() < right->zValue();
+}
+
 
 
 StandardPlotScene::StandardPlotScene(QObject *parent) :
     AbstractPlotScene(parent),
-    d_ptr(new StandardPlotScenePrivate())
+    d_ptr(new StandardPlotScenePrivate(this))
 {
+    Q_D(StandardPlotScene);
+    d->update_queue = new PlotItemUpdateQueue(this, "processPlotItemUpdates");
+    d->selection_model = new PlotSelectionModel(this);
 }
 
 StandardPlotScene::~StandardPlotScene()
 {
     Q_D(StandardPlotScene);
 
+    d->cancelDeferredLayout();
+
+    // элементы удаляются, пока сцена еще цела: их деструкторы (например, TaskTableItem)
+    // могут обращаться к сцене, а удаление элементов графика после очистки списка ничего не делает
+    d->plot_items.clear();
+    d->range_dependent_items.clear();
+    d->deferred_items.clear();
+    d->item_index.clear();
+    d->stale_items.clear();
+    d->hovered_item = 0;
+    d->moved_items.clear();
+    clear();
+
+    delete d->update_queue;
+
     if (d->x_scale != 0)
         delete d->x_scale;
 
@@ -107,13 +799,21 @@ void StandardPlotScene::setLayout(AbstractPlotLayout *layout)
 {
     Q_D(StandardPlotScene);
 
+    // фоновый пересчет обращается к прежнему объекту позиционирования
+    d->cancelDeferredLayout();
+    d->releaseDeferredItems(false);
+
     if (d->layout != 0)
         d->layout->setPlotScene(0);
 
     d->layout = layout;
 
-    if (d->layout != 0)
+    if (d->layout != 0) {
         d->layout->setPlotScene(this);
+
+        foreach (AbstractPlotItem *item, d->plot_items)
+            d->layout->itemAdded(item);
+    }
 }
 
 Qt::Orientation StandardPlotScene::sceneOrientation() const
@@ -128,6 +828,46 @@ void StandardPlotScene::setSceneOrientation(Qt::Orientation orientation)
     d->orientation = orientation;
 }
 
+AbstractPlotScene::ZoomMode StandardPlotScene::zoomMode() const
+{
+    Q_D(const StandardPlotScene);
+    return d->zoom_mode;
+}
+
+void StandardPlotScene::setZoomMode(AbstractPlotScene::ZoomMode mode)
+{
+    Q_D(StandardPlotScene);
+    if (d->zoom_mode != mode) {
+        resetZoom();
+        d->zoom_mode = mode;
+
+        // виджеты отображения должны сбросить преобразование прежнего способа
+        emit zoomTransformChanged();
+    }
+}
+
+QTransform StandardPlotScene::zoomTransform() const
+{
+    Q_D(const StandardPlotScene);
+
+    if (d->zoom_mode == ZoomDeferred)
+        return d->previewTransform();
+
+    if (d->zoom_mode != ZoomTransform)
+        return QTransform();
+
+    AbstractScale *active_scale = d->activeScale();
+    if ((active_scale == 0) || (active_scale->length() <= 0.0))
+        return QTransform();
+
+    // коэффициент считается от длины в начале масштабирования, которую может менять подгрузка данных
+    const double zoom_length = (d->zoom_length > 0.0) ? d->zoom_length : active_scale->length();
+    const double zoom_factor = (zoom_length + d->zoom_step * d->zoom_transform_extent) / zoom_length;
+
+    return (d->orientation == Qt::Horizontal) ? QTransform::fromScale(zoom_factor, 1.0)
+                                              : QTransform::fromScale(1.0, zoom_factor);
+}
+
 double StandardPlotScene::zoomExtent() const
 {
     Q_D(const StandardPlotScene);
@@ -140,6 +880,37 @@ void StandardPlotScene::setZoomExtent(double extent)
     d->zoom_extent = extent;
 }
 
+StandardPlotScene::PlotIndexMethod StandardPlotScene::plotIndexMethod() const
+{
+    Q_D(const StandardPlotScene);
+    return d->index_method;
+}
+
+void StandardPlotScene::setPlotIndexMethod(StandardPlotScene::PlotIndexMethod method)
+{
+    Q_D(StandardPlotScene);
+    if (d->index_method != method) {
+        d->index_method = method;
+        d->applyIndexMethod();
+    }
+}
+
+int StandardPlotScene::plotIndexBspDepth() const
+{
+    Q_D(const StandardPlotScene);
+    return d->index_bsp_depth;
+}
+
+void StandardPlotScene::setPlotIndexBspDepth(int depth)
+{
+    Q_D(StandardPlotScene);
+    if (d->index_bsp_depth != depth) {
+        d->index_bsp_depth = depth;
+        if (d->index_method == PlotIndexBspTree)
+            setBspTreeDepth(depth);
+    }
+}
+
 void StandardPlotScene::addPlotItem(AbstractPlotItem *item)
 {
     Q_D(StandardPlotScene);
@@ -150,12 +921,19 @@ void StandardPlotScene::addPlotItem(AbstractPlotItem *item)
     if (d->layout == 0)
         return;
 
-    if (d->plot_items.contains(item))
+    if (d->item_index.contains(item))
         return;
 
+    // элемент узнает о сцене до добавления, чтобы решить, принимать ли события наведения
     d->plot_items.append(item);
-    AbstractPlotScene::addItem(item);
     item->setPlotScene(this);
+    AbstractPlotScene::addItem(item);
+
+    d->item_index.insert(item);
+    d->layout->itemAdded(item);
+
+    if (item->isScaleRangeDependent())
+        d->range_dependent_items.append(item);
 }
 
 void StandardPlotScene::removePlotItem(AbstractPlotItem *item)
@@ -164,10 +942,131 @@ void StandardPlotScene::removePlotItem(AbstractPlotItem *item)
 
     int item_index = d->plot_items.indexOf(item);
     if (item_index != -1) {
+        d->forgetItem(item);
+        d->selection_model->forget(item);
+
         d->plot_items.removeAt(item_index);
         AbstractPlotScene::removeItem(item);
         item->setPlotScene(0);
+
+        d->item_index.remove(item);
+
+        if (d->layout != 0)
+            d->layout->itemRemoved(item);
+    }
+}
+
+void StandardPlotScene::addPlotItems(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(StandardPlotScene);
+
+    if (d->layout == 0)
+        return;
+
+    QList<AbstractPlotItem *> added_items;
+    added_items.reserve(items.size());
+
+    const bool suspended = d->suspendSceneIndex(items.size());
+
+    // индекс значений хранит элементы в хеше, поэтому проверка на повтор не требует поиска по списку
+    foreach (AbstractPlotItem *item, items) {
+        if ((item == 0) || d->item_index.contains(item))
+            continue;
+
+        item->setPlotScene(this);
+        AbstractPlotScene::addItem(item);
+
+        d->item_index.insert(item);
+        d->layout->itemAdded(item);
+        added_items.append(item);
+
+        if (item->isScaleRangeDependent())
+            d->range_dependent_items.append(item);
+    }
+
+    d->plot_items.append(added_items);
+
+    // во время предпросмотра отложенного пересчета прежняя геометрия растягивается преобразованием,
+    // а новые элементы были бы рассчитаны уже для новой шкалы и растянуты повторно,
+    // поэтому они скрываются и располагаются при применении пересчета
+    QList<AbstractPlotItem *> laid_out_items;
+
+    if ((d->zoom_mode == ZoomDeferred) && !d->previewTransform().isIdentity()) {
+        laid_out_items.reserve(added_items.size());
+
+        foreach (AbstractPlotItem *item, added_items) {
+            if (item->isVisible()) {
+                item->setVisible(false);
+                d->deferred_items.append(item);
+            }
+            else {
+                laid_out_items.append(item);
+            }
+        }
+    }
+    else {
+        laid_out_items = added_items;
+    }
+
+    d->layout->refresh(laid_out_items);
+
+    d->resumeSceneIndex(suspended);
+
+    d->addDamage(laid_out_items);
+    d->flushDamage();
+}
+
+void StandardPlotScene::removePlotItems(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(StandardPlotScene);
+
+    QSet<AbstractPlotItem *> removed_items;
+    removed_items.reserve(items.size());
+
+    QList<AbstractPlotItem *> removed_list;
+    removed_list.reserve(items.size());
+
+    const bool suspended = d->suspendSceneIndex(items.size());
+
+    foreach (AbstractPlotItem *item, items) {
+        if ((item == 0) || !d->item_index.contains(item))
+            continue;
+
+        d->forgetItem(item);
+
+        AbstractPlotScene::removeItem(item);
+        item->setPlotScene(0);
+
+        d->item_index.remove(item);
+        removed_items.insert(item);
+        removed_list.append(item);
     }
+
+    if (!removed_items.isEmpty()) {
+        QList<AbstractPlotItem *> rest_items;
+        rest_items.reserve(d->plot_items.size() - removed_items.size());
+
+        foreach (AbstractPlotItem *item, d->plot_items) {
+            if (!removed_items.contains(item))
+                rest_items.append(item);
+        }
+
+        d->plot_items = rest_items;
+
+        // одно уведомление модели выделения и объекта позиционирования на всю операцию
+        d->selection_model->forget(removed_list);
+
+        if (d->layout != 0)
+            d->layout->itemsRemoved(removed_list);
+    }
+
+    d->resumeSceneIndex(suspended);
+}
+
+QList<AbstractPlotItem *> StandardPlotScene::rangeDependentPlotItems() const
+{
+    Q_D(const StandardPlotScene);
+    return d->range_dependent_items;
 }
 
 QList<AbstractPlotItem *> StandardPlotScene::plotItems() const
@@ -178,8 +1077,25 @@ QList<AbstractPlotItem *> StandardPlotScene::plotItems() const
 
 QList<AbstractPlotItem *> StandardPlotScene::plotItems(const QPointF &scale_values, bool exact) const
 {
+    Q_D(const StandardPlotScene);
+
     QPointF lookup_point = mapFromScales(scale_values);
 
+    if (d->index_method != PlotIndexBspTree) {
+        QList<AbstractPlotItem *> result;
+
+        foreach (AbstractPlotItem *plot_item, d->valueIndex().items(scale_values)) {
+            const bool is_hit = exact ? plot_item->contains(plot_item->mapFromScene(lookup_point))
+                                      : plot_item->sceneBoundingRect().contains(lookup_point);
+            if (is_hit)
+                result.append(plot_item);
+        }
+
+        StandardPlotScenePrivate::sortByZValue(&result);
+
+        return result;
+    }
+
     QList<QGraphicsItem *> graphics_items = items(lookup_point,
                                                   exact ? Qt::ContainsItemShape
                                                         : Qt::IntersectsItemShape,
@@ -197,9 +1113,31 @@ QList<AbstractPlotItem *> StandardPlotScene::plotItems(const QPointF &scale_valu
 
 QList<AbstractPlotItem *> StandardPlotScene::plotItems(const QRectF &value_rect, bool exact) const
 {
+    Q_D(const StandardPlotScene);
+
     QRectF lookup_rect(QPointF(xScale()->position(value_rect.left()), yScale()->position(value_rect.top())),
                        QPointF(xScale()->position(value_rect.right()), yScale()->position(value_rect.bottom())));
 
+    if (d->index_method != PlotIndexBspTree) {
+        const QRectF normalized_rect = lookup_rect.normalized();
+
+        QList<AbstractPlotItem *> result;
+
+        foreach (AbstractPlotItem *plot_item, d->valueIndex().items(value_rect)) {
+            const QRectF item_rect = plot_item->sceneBoundingRect();
+
+            const bool is_hit = exact ? normalized_rect.contains(item_rect)
+                                      : ((item_rect.left() <= normalized_rect.right()) &&
+                                         (item_rect.right() >= normalized_rect.left()) &&
+                                         (item_rect.top() <= normalized_rect.bottom()) &&
+                                         (item_rect.bottom() >= normalized_rect.top()));
+            if (is_hit)
+                result.append(plot_item);
+        }
+
+        return result;
+    }
+
     QList<QGraphicsItem *> graphics_items = items(lookup_rect, exact ? Qt::ContainsItemShape
                                                                      : Qt::IntersectsItemShape);
     QList<AbstractPlotItem *> result;
@@ -217,20 +1155,41 @@ void StandardPlotScene::refresh()
 {
     Q_D(StandardPlotScene);
 
-    if (d->layout != 0)
+    // геометрия рассчитывается заново, результат фонового пересчета больше не нужен
+    d->layout_generation.fetchAndAddOrdered(1);
+    d->deferred_job.clear();
+
+    if (d->layout != 0) {
+        const bool suspended = d->suspendSceneIndex();
         d->layout->refresh();
+        d->resumeSceneIndex(suspended);
+    }
+
+    d->releaseDeferredItems(false);
+
+    // при полном пересчете меняются почти все элементы, поэтому сцена перерисовывается целиком
+    // без двух проходов по элементам для накопления области; область накапливается только
+    // при изменении отдельных элементов
+    update();
 
-    AbstractPlotScene::update();
+    d->rememberLayout(d->activeScale());
+
+    emit layoutChanged();
 }
 
 void StandardPlotScene::refresh(AbstractPlotItem *item)
 {
     Q_D(StandardPlotScene);
 
+    d->addDamage(item);
+
     if (d->layout != 0)
         d->layout->refresh(item);
 
-    AbstractPlotScene::update();
+    d->addDamage(item);
+    d->flushDamage();
+
+    d->item_index.update(item);
 }
 
 void StandardPlotScene::zoomIn()
@@ -240,13 +1199,27 @@ void StandardPlotScene::zoomIn()
     if (d->zoom_step >= d->maximum_zoom_step)
         return;
 
-    AbstractScale *active_scale = (d->orientation == Qt::Horizontal) ? d->x_scale : d->y_scale;
+    AbstractScale *active_scale = d->activeScale();
     if (active_scale == 0)
         return;
 
+    // длина шкалы и геометрия элементов не меняются, масштаб задает zoomTransform()
+    if (d->zoom_mode == ZoomTransform) {
+        if (d->zoom_step == 0) {
+            d->zoom_length = active_scale->length();
+            d->zoom_transform_extent = transformZoomExtent(active_scale);
+        }
+
+        setZoomStep(d->zoom_step + 1);
+        return;
+    }
+
     active_scale->setLength(active_scale->length() + d->zoom_extent);
 
     setZoomStep(d->zoom_step + 1);
+
+    if (d->zoom_mode == ZoomDeferred)
+        refreshDeferred();
 }
 
 void StandardPlotScene::zoomOut()
@@ -256,26 +1229,47 @@ void StandardPlotScene::zoomOut()
     if (d->zoom_step <= d->minimum_zoom_step)
         return;
 
-    AbstractScale *active_scale = (d->orientation == Qt::Horizontal) ? d->x_scale : d->y_scale;
+    AbstractScale *active_scale = d->activeScale();
     if (active_scale == 0)
         return;
 
+    if (d->zoom_mode == ZoomTransform) {
+        if (d->zoom_step == 0) {
+            d->zoom_length = active_scale->length();
+            d->zoom_transform_extent = transformZoomExtent(active_scale);
+        }
+
+        if ((d->zoom_length + (d->zoom_step - 1) * d->zoom_transform_extent) <= 0)
+            return;
+
+        setZoomStep(d->zoom_step - 1);
+        return;
+    }
+
     if ((active_scale->length() - d->zoom_extent) <= 0)
         return;
 
     active_scale->setLength(active_scale->length() - d->zoom_extent);
 
     setZoomStep(d->zoom_step - 1);
+
+    if (d->zoom_mode == ZoomDeferred)
+        refreshDeferred();
 }
 
 void StandardPlotScene::resetZoom()
 {
     Q_D(StandardPlotScene);
 
+    if (d->zoom_step == 0)
+        return;
+
     while (d->zoom_step < 0)
         zoomIn();
     while (d->zoom_step > 0)
         zoomOut();
+
+    emit zoomTransformChanged();
 }
 
 int StandardPlotScene::zoomStep() const
@@ -314,6 +1308,24 @@ void StandardPlotScene::setMaximumZoomStep(int step)
     d->maximum_zoom_step = step;
 }
 
+const PlotStatistics &StandardPlotScene::statistics() const
+{
+    Q_D(const StandardPlotScene);
+    return d->statistics;
+}
+
+PlotStatistics &StandardPlotScene::statistics()
+{
+    Q_D(StandardPlotScene);
+    return d->statistics;
+}
+
+void StandardPlotScene::resetStatistics()
+{
+    Q_D(StandardPlotScene);
+    d->statistics.reset();
+}
+
 QPointF StandardPlotScene::mapToScales(const QPointF &scene_pos) const
 {
     Q_D(const StandardPlotScene);
@@ -342,4 +1354,304 @@ QPointF StandardPlotScene::mapFromScales(const QPointF &scale_values) const
     return res;
 }
 
+PlotItemUpdateQueue *StandardPlotScene::updateQueue() const
+{
+    Q_D(const StandardPlotScene);
+    return d->update_queue;
+}
+
+void StandardPlotScene::refreshDeferred()
+{
+    Q_D(StandardPlotScene);
+
+    const int generation = d->layout_generation.fetchAndAddOrdered(1) + 1;
+
+    if ((d->layout == 0) || !d->layout->isGeometryReentrant() || (d->x_scale == 0) || (d->y_scale == 0)) {
+        refresh();
+        return;
+    }
+
+    QSharedPointer<DeferredLayoutJob> job(new DeferredLayoutJob());
+    job->x_scale = d->x_scale->clone();
+    job->y_scale = d->y_scale->clone();
+
+    if ((job->x_scale == 0) || (job->y_scale == 0)) {
+        refresh();
+        return;
+    }
+
+    job->generation = generation;
+    job->current_generation = &d->layout_generation;
+    job->layout = d->layout;
+    job->items = d->plot_items;
+
+    job->values.reserve(d->plot_items.size());
+    foreach (const AbstractPlotItem *item, d->plot_items)
+        job->values.append(PlotItemValues(item));
+
+    d->deferred_job = job;
+    d->deferred_pool.start(new DeferredLayoutTask(job, this));
+}
+
+void StandardPlotScene::applyDeferredLayout(int generation)
+{
+    Q_D(StandardPlotScene);
+
+    if (d->deferred_job.isNull() || (d->deferred_job->generation != generation))
+        return;
+
+    const QSharedPointer<DeferredLayoutJob> job = d->deferred_job;
+    d->deferred_job.clear();
+
+    const bool suspended = d->suspendSceneIndex();
+
+    setSceneRect(job->x_scale->minimumPosition(), job->y_scale->minimumPosition(),
+                 job->x_scale->length(), job->y_scale->length());
+
+    // элементы, удаленные со сцены во время пересчета, пропускаются
+    for (int i = 0; i < job->items.size(); ++ i) {
+        AbstractPlotItem *item = job->items.at(i);
+        if (d->item_index.contains(item))
+            job->geometry.at(i).applyTo(item);
+    }
+
+    // элементы, добавленные во время пересчета, могли в него не попасть
+    d->releaseDeferredItems(true);
+
+    d->resumeSceneIndex(suspended);
+
+    // применяется геометрия всех элементов, поэтому сцена перерисовывается целиком
+    update();
+
+    d->rememberLayout((d->orientation == Qt::Horizontal) ? job->x_scale : job->y_scale);
+
+    emit layoutChanged();
+    emit zoomTransformChanged();
+}
+
+bool StandardPlotScene::isHoverResolved() const
+{
+    Q_D(const StandardPlotScene);
+    return d->is_hover_resolved;
+}
+
+void StandardPlotScene::setHoverResolved(bool on)
+{
+    Q_D(StandardPlotScene);
+
+    if (d->is_hover_resolved == on)
+        return;
+
+    d->leaveHoveredItem();
+    d->is_hover_resolved = on;
+
+    // элементы принимают события наведения сами, только пока их не находит сцена
+    d->updateInteractionFlags();
+
+    // без элементов, принимающих события наведения, виджеты не отслеживают курсор сами
+    if (on) {
+        foreach (QGraphicsView *view, views())
+            view->viewport()->setMouseTracking(true);
+    }
+}
+
+AbstractPlotItem *StandardPlotScene::hoveredPlotItem() const
+{
+    Q_D(const StandardPlotScene);
+    return d->hovered_item;
+}
+
+PlotSelectionModel *StandardPlotScene::selectionModel() const
+{
+    Q_D(const StandardPlotScene);
+    return d->is_selection_model_enabled ? d->selection_model : 0;
+}
+
+bool StandardPlotScene::isSelectionModelEnabled() const
+{
+    Q_D(const StandardPlotScene);
+    return d->is_selection_model_enabled;
+}
+
+void StandardPlotScene::setSelectionModelEnabled(bool on)
+{
+    Q_D(StandardPlotScene);
+
+    if (d->is_selection_model_enabled == on)
+        return;
+
+    // выделение не переносится между моделью и флагами QGraphicsItem
+    if (on)
+        clearSelection();
+    else
+        d->selection_model->clear();
+
+    d->is_selection_model_enabled = on;
+
+    // флаг ItemIsSelectable элементов зависит от наличия модели выделения
+    d->updateInteractionFlags();
+}
+
+void StandardPlotScene::plotItemCoordinatesChanged(AbstractPlotItem *item)
+{
+    Q_D(StandardPlotScene);
+    if (d->item_index.contains(item))
+        d->stale_items.insert(item);
+}
+
+bool StandardPlotScene::isValueMoveEnabled() const
+{
+    Q_D(const StandardPlotScene);
+    return d->is_value_move_enabled;
+}
+
+void StandardPlotScene::setValueMoveEnabled(bool on)
+{
+    Q_D(StandardPlotScene);
+
+    if (d->is_value_move_enabled == on)
+        return;
+
+    if (!on)
+        d->endValueMove();
+
+    d->is_value_move_enabled = on;
+
+    // перемещаемые элементы перестают или снова начинают перетаскиваться QGraphicsScene
+    d->updateInteractionFlags();
+}
+
+AbstractScaleEngine *StandardPlotScene::snapEngine() const
+{
+    Q_D(const StandardPlotScene);
+    return d->snap_engine;
+}
+
+void StandardPlotScene::setSnapEngine(AbstractScaleEngine *engine)
+{
+    Q_D(StandardPlotScene);
+    d->snap_engine = engine;
+}
+
+bool StandardPlotScene::event(QEvent *event)
+{
+    Q_D(StandardPlotScene);
+
+    // виджет отображения сообщает сцене об уходе курсора из своей области
+    if (event->type() == QEvent::GraphicsSceneLeave)
+        d->leaveHoveredItem();
+
+    return AbstractPlotScene::event(event);
+}
+
+void StandardPlotScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
+{
+    Q_D(StandardPlotScene);
+
+    // нажатие меняет выделение в модели, флаги выделения QGraphicsItem не используются
+    if (d->is_selection_model_enabled && (event->button() == Qt::LeftButton) && (mouseGrabberItem() == 0))
+        d->selectAt(event->scenePos(), event->modifiers());
+
+    // перетаскивание решается до QGraphicsScene: иначе выделяемый элемент захватит мышь сам
+    if (d->is_value_move_enabled && (event->button() == Qt::LeftButton) && (mouseGrabberItem() == 0) &&
+        d->beginValueMove(event->scenePos())) {
+        event->accept();
+        return;
+    }
+
+    AbstractPlotScene::mousePressEvent(event);
+}
+
+void StandardPlotScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
+{
+    Q_D(StandardPlotScene);
+
+    if (!d->moved_items.isEmpty()) {
+        d->applyValueMove(d->valueMoveDelta(event->scenePos()));
+        event->accept();
+        return;
+    }
+
+    // при перетаскивании события получает захвативший мышь элемент, как и в QGraphicsScene
+    if (d->is_hover_resolved && (mouseGrabberItem() == 0) && (event->buttons() == Qt::NoButton)) {
+        AbstractPlotItem *item = d->hoverItemAt(event->scenePos());
+
+        if (item != d->hovered_item) {
+            d->leaveHoveredItem();
+
+            if (item != 0) {
+                d->hovered_item = item;
+                d->sendHoverEvent(item, QEvent::GraphicsSceneHoverEnter, event);
+            }
+        }
+
+        if (d->hovered_item != 0)
+            d->sendHoverEvent(d->hovered_item, QEvent::GraphicsSceneHoverMove, event);
+    }
+
+    AbstractPlotScene::mouseMoveEvent(event);
+}
+
+void StandardPlotScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+{
+    Q_D(StandardPlotScene);
+
+    if (!d->moved_items.isEmpty() && (event->button() == Qt::LeftButton)) {
+        d->applyValueMove(d->valueMoveDelta(event->scenePos()));
+        d->endValueMove();
+
+        event->accept();
+        return;
+    }
+
+    AbstractPlotScene::mouseReleaseEvent(event);
+}
+
+double StandardPlotScene::transformZoomExtent(const AbstractScale *scale) const
+{
+    Q_D(const StandardPlotScene);
+    Q_UNUSED(scale);
+    return d->zoom_extent;
+}
+
+void StandardPlotScene::processPlotItemUpdates()
+{
+    Q_D(StandardPlotScene);
+
+    const QList<PlotItemUpdate> updates = d->update_queue->take();
+    if (updates.isEmpty())
+        return;
+
+    GRAPHICS_STATISTICS_COUNT(d->statistics, ItemUpdatesApplied, updates.size());
+
+    QList<AbstractPlotItem *> moved_items;
+
+    foreach (const PlotItemUpdate &update, updates) {
+        // элемент мог быть удален с графика, пока изменение ждало в очереди
+        if (!d->item_index.contains(update.item))
+            continue;
+
+        update.apply();
+
+        if (update.changesGeometry())
+            moved_items.append(update.item);
+        else
+            update.item->update();
+    }
+
+    if (moved_items.isEmpty())
+        return;
+
+    d->addDamage(moved_items);
+
+    if (d->layout != 0)
+        d->layout->refresh(moved_items);
+
+    d->addDamage(moved_items);
+    d->flushDamage();
+
+    foreach (AbstractPlotItem *item, moved_items)
+        d->item_index.update(item);
+}
+
 } // namespace Graphics
@@ -1,13 +1,31 @@
+#include <QTimer>
 #include <QWheelEvent>
 #include <QScrollBar>
+#include <QMouseEvent>
+#include <QRubberBand>
+#include <QElapsedTimer>
+#include <cmath>
 
 #include "include/standardplotview.h"
 #include "include/abstractplotscene.h"
 #include "include/abstractscale.h"
+#include "include/plotstatistics.h"
+#include "include/plotselectionmodel.h"
 
 
 namespace Graphics {
 
+namespace {
+
+//! Интервал кадров инерционной прокрутки в миллисекундах.
+const int kinetic_frame_interval = 16;
+//! Скорость в пикселях в секунду, ниже которой инерционная прокрутка останавливается.
+const double minimum_kinetic_velocity = 20.0;
+//! Пауза перед отпусканием кнопки в миллисекундах, после которой инерция не начинается.
+const qint64 kinetic_release_delay = 100;
+
+} // namespace
+
 //! Реализация класса виджета для отображения графика.
 class StandardPlotViewPrivate {
     Q_DECLARE_PUBLIC(StandardPlotView)
@@ -22,6 +40,32 @@ class StandardPlotViewPrivate {
     //! Клавиша-модификатор для масштабирования.
     Qt::KeyboardModifier zoom_key_modifier;
 
+    //! Флаг выделения элементов рамкой.
+    bool is_rubber_band_selection_enabled;
+    //! Клавиша-модификатор для выделения элементов рамкой.
+    Qt::KeyboardModifier selection_key_modifier;
+    //! Рамка выделения (0 - если рамка не растягивается).
+    QRubberBand *rubber_band;
+    //! Точка начала рамки выделения в координатах виджета.
+    QPoint rubber_band_origin;
+
+    //! Флаг прокрутки перетаскиванием с инерцией.
+    bool is_kinetic_scroll_enabled;
+    //! Время затухания скорости инерционной прокрутки в миллисекундах.
+    int kinetic_decay_time;
+    //! Флаг перетаскивания графика.
+    bool is_dragging;
+    //! Последняя точка перетаскивания в координатах виджета.
+    QPoint drag_last_pos;
+    //! Замер времени между событиями перетаскивания и кадрами инерции.
+    QElapsedTimer kinetic_clock;
+    //! Скорость прокрутки в пикселях виджета в секунду (положительная - вперед).
+    double kinetic_velocity;
+    //! Дробный остаток смещения инерционной прокрутки в пикселях.
+    double kinetic_remainder;
+    //! Таймер кадров инерционной прокрутки.
+    QTimer kinetic_timer;
+
     //! Кэш текущей отображаемой позиции на графике.
     QPointF update_cache_view_position;
 
@@ -30,24 +74,53 @@ class StandardPlotViewPrivate {
         q_ptr(q),
         plot_scene(0),
         is_zoom_enabled(false),
-        zoom_key_modifier(Qt::ControlModifier)
-    {}
+        zoom_key_modifier(Qt::ControlModifier),
+        is_rubber_band_selection_enabled(false),
+        selection_key_modifier(Qt::ShiftModifier),
+        rubber_band(0),
+        is_kinetic_scroll_enabled(false),
+        kinetic_decay_time(325),
+        is_dragging(false),
+        kinetic_velocity(0.0),
+        kinetic_remainder(0.0)
+    {
+        kinetic_timer.setInterval(kinetic_frame_interval);
+    }
 
     //! Деструктор.
     ~StandardPlotViewPrivate() {}
 
+    //! Значения шкал в центре видимой области.
+    QPointF centerValues() const;
     //! Метод начала обновления графической сцены.
     void beginSceneUpdate();
     //! Метод завершения обновления графической сцены.
     void endSceneUpdate();
+
+    //! Применение преобразования масштабирования сцены с сохранением точки под курсором.
+    void applyZoomTransform();
+
+    //! Выделение элементов в рамке \c viewport_rect способом, заданным модификаторами \c modifiers.
+    void selectRubberBand(const QRect &viewport_rect, Qt::KeyboardModifiers modifiers);
+
+    //! Полоса прокрутки вдоль оси прокрутки графика.
+    QScrollBar *activeScrollBar() const;
+    //! Прокрутка графика на \c pixels пикселей виджета (положительное значение - вперед).
+    void scrollBy(int pixels);
+    //! Сообщение сцене текущей скорости прокрутки.
+    void predictScroll();
 };
 
-void StandardPlotViewPrivate::beginSceneUpdate()
+QPointF StandardPlotViewPrivate::centerValues() const
 {
-    Q_Q(StandardPlotView);
+    Q_Q(const StandardPlotView);
+    return plot_scene->mapToScales(q->mapToScene(q->viewport()->rect().center()));
+}
 
+void StandardPlotViewPrivate::beginSceneUpdate()
+{
     if (plot_scene != 0)
-        update_cache_view_position = plot_scene->mapToScales(q->mapToScene(q->viewport()->rect().center()));
+        update_cache_view_position = centerValues();
 }
 
 void StandardPlotViewPrivate::endSceneUpdate()
@@ -60,12 +133,96 @@ void StandardPlotViewPrivate::endSceneUpdate()
     }
 }
 
+void StandardPlotViewPrivate::applyZoomTransform()
+{
+    Q_Q(StandardPlotView);
+
+    if (plot_scene == 0)
+        return;
+
+    const QPoint viewport_cursor_pos = q->viewport()->mapFromGlobal(QCursor::pos());
+    const QPointF cursor_pos = q->mapToScene(viewport_cursor_pos);
+
+    q->setTransform(plot_scene->zoomTransform());
+
+    const QPointF offset = q->mapToScene(viewport_cursor_pos) - cursor_pos;
+    q->centerOn(q->mapToScene(q->viewport()->rect().center()) - offset);
+
+    plot_scene->visualize(q->mapToScene(q->viewport()->rect()).boundingRect());
+}
+
+void StandardPlotViewPrivate::selectRubberBand(const QRect &viewport_rect, Qt::KeyboardModifiers modifiers)
+{
+    Q_Q(StandardPlotView);
+
+    if ((plot_scene == 0) || (plot_scene->selectionModel() == 0))
+        return;
+
+    const QRectF scene_rect = q->mapToScene(viewport_rect).boundingRect();
+    const QRectF value_rect(plot_scene->mapToScales(scene_rect.topLeft()),
+                            plot_scene->mapToScales(scene_rect.bottomRight()));
+
+    const bool is_toggle = (selection_key_modifier != Qt::ControlModifier) && modifiers.testFlag(Qt::ControlModifier);
+
+    plot_scene->selectionModel()->select(value_rect, is_toggle ? PlotSelectionModel::Toggle
+                                                               : PlotSelectionModel::ClearAndSelect);
+}
+
+
+
+QScrollBar *StandardPlotViewPrivate::activeScrollBar() const
+{
+    Q_Q(const StandardPlotView);
+    return (plot_scene->sceneOrientation() == Qt::Horizontal) ? q->horizontalScrollBar()
+                                                              : q->verticalScrollBar();
+}
+
+void StandardPlotViewPrivate::scrollBy(int pixels)
+{
+    Q_Q(StandardPlotView);
+
+    QScrollBar *active_scroll_bar = activeScrollBar();
+    active_scroll_bar->setValue(active_scroll_bar->value() + pixels);
+
+    beginSceneUpdate();
+
+    QRectF visible_scene_rect = q->mapToScene(q->viewport()->rect()).boundingRect();
+
+    if (pixels < 0)
+        plot_scene->scrollBack(visible_scene_rect);
+    else
+        plot_scene->scrollForward(visible_scene_rect);
+
+    endSceneUpdate();
+}
+
+void StandardPlotViewPrivate::predictScroll()
+{
+    Q_Q(StandardPlotView);
+
+    const QTransform view_transform = q->transform();
+
+    // скорость переводится из пикселей виджета в единицы сцены с учетом масштабирования преобразованием
+    const QPointF velocity = (plot_scene->sceneOrientation() == Qt::Horizontal)
+                             ? QPointF(kinetic_velocity / view_transform.m11(), 0.0)
+                             : QPointF(0.0, kinetic_velocity / view_transform.m22());
+
+    beginSceneUpdate();
+    plot_scene->predictScroll(q->mapToScene(q->viewport()->rect()).boundingRect(), velocity);
+    endSceneUpdate();
+}
+
+
 
 StandardPlotView::StandardPlotView(QWidget *parent) :
     AbstractPlotView(parent),
     d_ptr(new StandardPlotViewPrivate(this))
 {
+    Q_D(StandardPlotView);
+
     setPlotSceneOrientation(Qt::Horizontal);
+
+    connect(&d->kinetic_timer, SIGNAL(timeout()), this, SLOT(kineticScrollStep()));
 }
 
 StandardPlotView::~StandardPlotView()
@@ -83,12 +240,24 @@ void StandardPlotView::setPlotScene(AbstractPlotScene *plot_scene)
 {
     Q_D(StandardPlotView);
     if (d->plot_scene != plot_scene) {
+        if (d->plot_scene != 0) {
+            disconnect(d->plot_scene, SIGNAL(zoomTransformChanged()), this, SLOT(updateZoomTransform()));
+            disconnect(d->plot_scene, SIGNAL(followRequested(QPointF)), this, SLOT(followScaleValues(QPointF)));
+        }
+
         d->plot_scene = plot_scene;
         d->plot_scene->resetZoom();
         AbstractPlotView::setScene(d->plot_scene);
 
-        if (d->plot_scene != 0)
+        if (d->plot_scene != 0) {
             setPlotSceneOrientation(d->plot_scene->sceneOrientation());
+            setTransform(d->plot_scene->zoomTransform());
+            connect(d->plot_scene, SIGNAL(zoomTransformChanged()), this, SLOT(updateZoomTransform()));
+            connect(d->plot_scene, SIGNAL(followRequested(QPointF)), this, SLOT(followScaleValues(QPointF)));
+
+            if (d->plot_scene->isHoverResolved())
+                viewport()->setMouseTracking(true);
+        }
     }
 }
 
@@ -109,6 +278,8 @@ void StandardPlotView::setPlotSceneOrientation(Qt::Orientation orientation)
 
     d->plot_scene->resetZoom();
 
+    setTransform(d->plot_scene->zoomTransform());
+
     setHorizontalScrollBarPolicy((orientation == Qt::Horizontal) ? Qt::ScrollBarAlwaysOff
                                                                  : Qt::ScrollBarAsNeeded);
     setVerticalScrollBarPolicy((orientation == Qt::Vertical) ? Qt::ScrollBarAlwaysOff
@@ -139,35 +310,89 @@ void StandardPlotView::setZoomKeyboardModifier(Qt::KeyboardModifier modifier)
     d->zoom_key_modifier = modifier;
 }
 
-void StandardPlotView::scrollPlot(int steps_count)
+bool StandardPlotView::isRubberBandSelectionEnabled() const
+{
+    Q_D(const StandardPlotView);
+    return d->is_rubber_band_selection_enabled;
+}
+
+void StandardPlotView::setRubberBandSelectionEnabled(bool on)
 {
     Q_D(StandardPlotView);
+    d->is_rubber_band_selection_enabled = on;
+}
 
-    if (d->plot_scene == 0)
-        return;
+Qt::KeyboardModifier StandardPlotView::selectionKeyboardModifier() const
+{
+    Q_D(const StandardPlotView);
+    return d->selection_key_modifier;
+}
 
-    QScrollBar *active_scroll_bar = (d->plot_scene->sceneOrientation() == Qt::Horizontal)
-                                    ? horizontalScrollBar()
-                                    : verticalScrollBar();
+void StandardPlotView::setSelectionKeyboardModifier(Qt::KeyboardModifier modifier)
+{
+    Q_D(StandardPlotView);
+    d->selection_key_modifier = modifier;
+}
 
-    active_scroll_bar->setValue(active_scroll_bar->value() - steps_count * active_scroll_bar->singleStep());
+bool StandardPlotView::isKineticScrollEnabled() const
+{
+    Q_D(const StandardPlotView);
+    return d->is_kinetic_scroll_enabled;
+}
 
-    d->beginSceneUpdate();
+void StandardPlotView::setKineticScrollEnabled(bool on)
+{
+    Q_D(StandardPlotView);
 
-    QRectF visible_scene_rect = mapToScene(viewport()->rect()).boundingRect();
+    if (!on) {
+        stopKineticScroll();
+        d->is_dragging = false;
+    }
 
-    if (steps_count > 0)
-        d->plot_scene->scrollBack(visible_scene_rect);
-    else
-        d->plot_scene->scrollForward(visible_scene_rect);
+    d->is_kinetic_scroll_enabled = on;
+}
+
+int StandardPlotView::kineticDecayTime() const
+{
+    Q_D(const StandardPlotView);
+    return d->kinetic_decay_time;
+}
+
+void StandardPlotView::setKineticDecayTime(int msecs)
+{
+    Q_D(StandardPlotView);
+    d->kinetic_decay_time = qMax(msecs, 1);
+}
 
-    d->endSceneUpdate();
+void StandardPlotView::stopKineticScroll()
+{
+    Q_D(StandardPlotView);
+
+    d->kinetic_timer.stop();
+    d->kinetic_velocity = 0.0;
+    d->kinetic_remainder = 0.0;
+}
+
+void StandardPlotView::scrollPlot(int steps_count)
+{
+    Q_D(StandardPlotView);
+
+    if (d->plot_scene == 0)
+        return;
+
+    d->scrollBy(-steps_count * d->activeScrollBar()->singleStep());
 }
 
 void StandardPlotView::zoomIn()
 {
     Q_D(StandardPlotView);
     if (d->plot_scene != 0) {
+        if (d->plot_scene->zoomMode() != AbstractPlotScene::ZoomRelayout) {
+            d->plot_scene->zoomIn();
+            d->applyZoomTransform();
+            return;
+        }
+
         QRectF view_rect = mapToScene(viewport()->rect()).boundingRect();
         QPointF cursor_pos = mapToScene(viewport()->mapFromGlobal(QCursor::pos()));
         QPointF cursor_value = d->plot_scene->mapToScales(cursor_pos);
@@ -186,6 +411,12 @@ void StandardPlotView::zoomOut()
 {
     Q_D(StandardPlotView);
     if (d->plot_scene != 0) {
+        if (d->plot_scene->zoomMode() != AbstractPlotScene::ZoomRelayout) {
+            d->plot_scene->zoomOut();
+            d->applyZoomTransform();
+            return;
+        }
+
         QRectF view_rect = mapToScene(viewport()->rect()).boundingRect();
         QPointF cursor_pos = mapToScene(viewport()->mapFromGlobal(QCursor::pos()));
         QPointF cursor_value = d->plot_scene->mapToScales(cursor_pos);
@@ -215,6 +446,23 @@ void StandardPlotView::scrollTo(const QPointF &scale_values)
     }
 }
 
+void StandardPlotView::updateZoomTransform()
+{
+    Q_D(StandardPlotView);
+
+    if (d->plot_scene == 0)
+        return;
+
+    // центр сохраняется в координатах экрана, чтобы смена геометрии не сдвигала изображение
+    const QPointF center = transform().map(mapToScene(viewport()->rect().center()));
+    const QTransform zoom_transform = d->plot_scene->zoomTransform();
+
+    setTransform(zoom_transform);
+    centerOn(zoom_transform.inverted().map(center));
+
+    d->plot_scene->visualize(mapToScene(viewport()->rect()).boundingRect());
+}
+
 void StandardPlotView::showEvent(QShowEvent *event)
 {
     AbstractPlotView::showEvent(event);
@@ -236,15 +484,214 @@ void StandardPlotView::wheelEvent(QWheelEvent *event)
         scrollPlot(steps_count);
 
     if (event->modifiers().testFlag(d->zoom_key_modifier) && d->is_zoom_enabled) {
+        const bool needs_refresh = (d->plot_scene->zoomMode() == AbstractPlotScene::ZoomRelayout);
+
         if (event->delta() < 0) {
             zoomIn();
-            d->plot_scene->refresh();
+            if (needs_refresh)
+                d->plot_scene->refresh();
         }
         if (event->delta() > 0) {
             zoomOut();
-            d->plot_scene->refresh();
+            if (needs_refresh)
+                d->plot_scene->refresh();
+        }
+    }
+}
+
+void StandardPlotView::paintEvent(QPaintEvent *event)
+{
+    Q_D(StandardPlotView);
+
+    if (d->plot_scene == 0) {
+        AbstractPlotView::paintEvent(event);
+        return;
+    }
+
+    GRAPHICS_STATISTICS_COUNT(d->plot_scene->statistics(), FramesPainted, 1);
+    GRAPHICS_STATISTICS_COUNT(d->plot_scene->statistics(), ItemsPainted, items(event->rect()).size());
+    GRAPHICS_STATISTICS_TIMER(d->plot_scene->statistics(), PaintTime);
+
+    AbstractPlotView::paintEvent(event);
+}
+
+void StandardPlotView::mousePressEvent(QMouseEvent *event)
+{
+    Q_D(StandardPlotView);
+
+    const bool starts_rubber_band = d->is_rubber_band_selection_enabled && (d->plot_scene != 0) &&
+                                    (d->plot_scene->selectionModel() != 0) &&
+                                    (event->button() == Qt::LeftButton) &&
+                                    event->modifiers().testFlag(d->selection_key_modifier);
+
+    // рамка перехватывает нажатие, чтобы элементы под курсором не начинали перетаскивание
+    if (starts_rubber_band) {
+        if (d->rubber_band == 0)
+            d->rubber_band = new QRubberBand(QRubberBand::Rectangle, viewport());
+
+        d->rubber_band_origin = event->pos();
+        d->rubber_band->setGeometry(QRect(d->rubber_band_origin, QSize()));
+        d->rubber_band->show();
+
+        event->accept();
+        return;
+    }
+
+    // нажатие во время инерции только останавливает график
+    const bool stops_kinetic_scroll = d->kinetic_timer.isActive();
+    stopKineticScroll();
+
+    if (!stops_kinetic_scroll)
+        AbstractPlotView::mousePressEvent(event);
+
+    // перетаскивание начинается, только если нажатие не приняли элементы и сцена
+    const bool starts_dragging = d->is_kinetic_scroll_enabled && (d->plot_scene != 0) &&
+                                 (event->button() == Qt::LeftButton) &&
+                                 (stops_kinetic_scroll || !event->isAccepted());
+
+    if (starts_dragging) {
+        d->is_dragging = true;
+        d->drag_last_pos = event->pos();
+        d->kinetic_clock.start();
+
+        event->accept();
+    }
+}
+
+void StandardPlotView::mouseMoveEvent(QMouseEvent *event)
+{
+    Q_D(StandardPlotView);
+
+    if ((d->rubber_band != 0) && d->rubber_band->isVisible()) {
+        d->rubber_band->setGeometry(QRect(d->rubber_band_origin, event->pos()).normalized());
+        event->accept();
+        return;
+    }
+
+    if (d->is_dragging) {
+        const QPoint offset = d->drag_last_pos - event->pos();
+        const int pixels = (d->plot_scene->sceneOrientation() == Qt::Horizontal) ? offset.x() : offset.y();
+
+        d->drag_last_pos = event->pos();
+
+        const qint64 elapsed = qMax(d->kinetic_clock.restart(), qint64(1));
+
+        // сглаживание скорости, чтобы единичный рывок перед отпусканием не задавал инерцию
+        d->kinetic_velocity = 0.8 * (pixels * 1000.0 / elapsed) + 0.2 * d->kinetic_velocity;
+
+        if (pixels != 0) {
+            d->scrollBy(pixels);
+            d->predictScroll();
         }
+
+        event->accept();
+        return;
+    }
+
+    AbstractPlotView::mouseMoveEvent(event);
+}
+
+void StandardPlotView::mouseReleaseEvent(QMouseEvent *event)
+{
+    Q_D(StandardPlotView);
+
+    if ((d->rubber_band != 0) && d->rubber_band->isVisible() && (event->button() == Qt::LeftButton)) {
+        d->rubber_band->hide();
+        d->selectRubberBand(QRect(d->rubber_band_origin, event->pos()).normalized(), event->modifiers());
+
+        event->accept();
+        return;
+    }
+
+    if (d->is_dragging && (event->button() == Qt::LeftButton)) {
+        d->is_dragging = false;
+
+        // график, остановленный перед отпусканием, не продолжает движение
+        if (d->kinetic_clock.elapsed() > kinetic_release_delay)
+            d->kinetic_velocity = 0.0;
+
+        if (qAbs(d->kinetic_velocity) >= minimum_kinetic_velocity) {
+            d->kinetic_remainder = 0.0;
+            d->kinetic_clock.start();
+            d->kinetic_timer.start();
+        }
+        else {
+            stopKineticScroll();
+        }
+
+        event->accept();
+        return;
+    }
+
+    AbstractPlotView::mouseReleaseEvent(event);
+}
+
+void StandardPlotView::kineticScrollStep()
+{
+    Q_D(StandardPlotView);
+
+    if (d->plot_scene == 0) {
+        stopKineticScroll();
+        return;
     }
+
+    // время кадра ограничивается, чтобы долгий кадр не превращался в скачок
+    const double elapsed = double(qMin(d->kinetic_clock.restart(), qint64(100)));
+
+    const double distance = d->kinetic_velocity * elapsed / 1000.0 + d->kinetic_remainder;
+    const int pixels = int(distance);
+
+    d->kinetic_remainder = distance - pixels;
+    d->kinetic_velocity *= exp(-elapsed / d->kinetic_decay_time);
+
+    if (pixels != 0) {
+        const QPointF old_values = d->centerValues();
+
+        d->scrollBy(pixels);
+
+        // бесконечная сцена расширяется уже после упора полосы прокрутки в границу, поэтому
+        // сдвиг повторяется по расширенной сцене; положение сравнивается в значениях шкал,
+        // так как расширение сцены меняет значение полосы прокрутки;
+        // у конечного графика инерция останавливается на границе сцены
+        if (d->centerValues() == old_values) {
+            d->scrollBy(pixels);
+
+            if (d->centerValues() == old_values) {
+                stopKineticScroll();
+                return;
+            }
+        }
+    }
+
+    if (qAbs(d->kinetic_velocity) < minimum_kinetic_velocity) {
+        stopKineticScroll();
+        return;
+    }
+
+    d->predictScroll();
+}
+
+void StandardPlotView::followScaleValues(const QPointF &scale_values)
+{
+    Q_D(StandardPlotView);
+
+    if (d->plot_scene == 0)
+        return;
+
+    const QRectF visible_scene_rect = mapToScene(viewport()->rect()).boundingRect();
+    const QPointF scene_pos = d->plot_scene->mapFromScales(scale_values);
+
+    // по второй оси положение не меняется, чтобы не сбивать просмотр строк
+    const QPointF target_pos = (d->plot_scene->sceneOrientation() == Qt::Horizontal)
+                               ? QPointF(scene_pos.x(), visible_scene_rect.center().y())
+                               : QPointF(visible_scene_rect.center().x(), scene_pos.y());
+
+    if (visible_scene_rect.contains(target_pos))
+        return;
+
+    ensureVisible(QRectF(target_pos, QSizeF(1.0, 1.0)), 0, 0);
+
+    d->plot_scene->visualize(mapToScene(viewport()->rect()).boundingRect());
 }
 
 } // namespace Graphics
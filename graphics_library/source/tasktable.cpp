@@ -0,0 +1,232 @@
+#include <algorithm>
+
+#include "include/tasktable.h"
+
+
+namespace Graphics {
+
+//! Реализация класса таблицы задач.
+class TaskTablePrivate {
+public:
+    //! Секции задач.
+    QVector<quint32> sections;
+    //! Начала задач.
+    QVector<double> begin_values;
+    //! Концы задач.
+    QVector<double> end_values;
+    //! Стили задач.
+    QVector<quint32> styles;
+    //! Идентификаторы задач.
+    QVector<quint64> ids;
+
+    //! Количество секций.
+    uint sections_count;
+
+    //! Строки задач каждой секции, упорядоченные по началу.
+    mutable QVector<QVector<int> > section_rows;
+    //! Наибольший конец задач секции от первой до текущей строки включительно.
+    mutable QVector<QVector<double> > section_end_values;
+    //! Флаг необходимости перестроения индекса.
+    mutable bool is_index_dirty;
+
+    //! Конструктор.
+    TaskTablePrivate() : sections_count(0), is_index_dirty(false) {}
+
+    //! Сравнение строк по началу задачи.
+    struct LessBegin {
+        //! Начала задач.
+        const QVector<double> *begin_values;
+
+        //! Сравнение строк \c left и \c right.
+        bool operator()(int left, int right) const { return begin_values->at(left) < begin_values->at(right); }
+    };
+};
+
+
+
+TaskTable::TaskTable() :
+    d_ptr(new TaskTablePrivate())
+{
+}
+
+TaskTable::~TaskTable()
+{
+    delete d_ptr;
+}
+
+int TaskTable::count() const
+{
+    Q_D(const TaskTable);
+    return d->sections.size();
+}
+
+void TaskTable::reserve(int count)
+{
+    Q_D(TaskTable);
+
+    d->sections.reserve(count);
+    d->begin_values.reserve(count);
+    d->end_values.reserve(count);
+    d->styles.reserve(count);
+    d->ids.reserve(count);
+}
+
+void TaskTable::clear()
+{
+    Q_D(TaskTable);
+
+    d->sections.clear();
+    d->begin_values.clear();
+    d->end_values.clear();
+    d->styles.clear();
+    d->ids.clear();
+
+    d->sections_count = 0;
+    d->is_index_dirty = true;
+}
+
+int TaskTable::append(uint section, double begin_value, double end_value, quint32 style, quint64 id)
+{
+    Q_D(TaskTable);
+
+    d->sections.append(section);
+    d->begin_values.append(qMin(begin_value, end_value));
+    d->end_values.append(qMax(begin_value, end_value));
+    d->styles.append(style);
+    d->ids.append(id);
+
+    d->sections_count = qMax(d->sections_count, section + 1);
+    d->is_index_dirty = true;
+
+    return d->sections.size() - 1;
+}
+
+void TaskTable::setInterval(int row, double begin_value, double end_value)
+{
+    Q_D(TaskTable);
+
+    d->begin_values[row] = qMin(begin_value, end_value);
+    d->end_values[row] = qMax(begin_value, end_value);
+
+    d->is_index_dirty = true;
+}
+
+void TaskTable::setSection(int row, uint section)
+{
+    Q_D(TaskTable);
+
+    d->sections[row] = section;
+
+    d->sections_count = qMax(d->sections_count, section + 1);
+    d->is_index_dirty = true;
+}
+
+void TaskTable::setStyle(int row, quint32 style)
+{
+    Q_D(TaskTable);
+    d->styles[row] = style;
+}
+
+uint TaskTable::section(int row) const
+{
+    Q_D(const TaskTable);
+    return d->sections.at(row);
+}
+
+double TaskTable::beginValue(int row) const
+{
+    Q_D(const TaskTable);
+    return d->begin_values.at(row);
+}
+
+double TaskTable::endValue(int row) const
+{
+    Q_D(const TaskTable);
+    return d->end_values.at(row);
+}
+
+quint32 TaskTable::style(int row) const
+{
+    Q_D(const TaskTable);
+    return d->styles.at(row);
+}
+
+quint64 TaskTable::id(int row) const
+{
+    Q_D(const TaskTable);
+    return d->ids.at(row);
+}
+
+uint TaskTable::sectionsCount() const
+{
+    Q_D(const TaskTable);
+    return d->sections_count;
+}
+
+void TaskTable::buildIndex() const
+{
+    Q_D(const TaskTable);
+
+    if (!d->is_index_dirty)
+        return;
+
+    d->section_rows.clear();
+    d->section_rows.resize(int(d->sections_count));
+    d->section_end_values.clear();
+    d->section_end_values.resize(int(d->sections_count));
+
+    for (int row = 0; row < d->sections.size(); ++ row)
+        d->section_rows[int(d->sections.at(row))].append(row);
+
+    TaskTablePrivate::LessBegin less_begin;
+    less_begin.begin_values = &d->begin_values;
+
+    for (int section = 0; section < d->section_rows.size(); ++ section) {
+        QVector<int> &rows = d->section_rows[section];
+        std::stable_sort(rows.begin(), rows.end(), less_begin);
+
+        QVector<double> &end_values = d->section_end_values[section];
+        end_values.resize(rows.size());
+
+        for (int i = 0; i < rows.size(); ++ i) {
+            const double end_value = d->end_values.at(rows.at(i));
+            end_values[i] = (i == 0) ? end_value : qMax(end_values.at(i - 1), end_value);
+        }
+    }
+
+    d->is_index_dirty = false;
+}
+
+QVector<int> TaskTable::find(double begin_value, double end_value, uint first_section, uint last_section) const
+{
+    Q_D(const TaskTable);
+
+    buildIndex();
+
+    QVector<int> rows;
+
+    last_section = qMin(last_section, d->sections_count - 1);
+
+    for (uint section = first_section; (section <= last_section) && (section < d->sections_count); ++ section) {
+        const QVector<int> &section_rows = d->section_rows.at(int(section));
+        const QVector<double> &end_values = d->section_end_values.at(int(section));
+
+        // наибольший конец не убывает, поэтому первая подходящая строка ищется двоичным поиском
+        const int first = int(std::lower_bound(end_values.constBegin(), end_values.constEnd(), begin_value) -
+                              end_values.constBegin());
+
+        for (int i = first; i < section_rows.size(); ++ i) {
+            const int row = section_rows.at(i);
+
+            if (d->begin_values.at(row) > end_value)
+                break;
+
+            if (d->end_values.at(row) >= begin_value)
+                rows.append(row);
+        }
+    }
+
+    return rows;
+}
+
+} // namespace Graphics
@@ -0,0 +1,406 @@
+#include <cmath>
+#include <QHash>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsSceneHoverEvent>
+
+#include "include/tasktableitem.h"
+#include "include/tasktable.h"
+#include "include/abstractplotscene.h"
+#include "include/abstractplotitem.h"
+#include "include/abstractplotitemfactory.h"
+#include "include/abstractscale.h"
+#include "include/plotstatistics.h"
+
+
+namespace Graphics {
+
+//! Реализация графического элемента, отрисовывающего таблицу задач.
+class TaskTableItemPrivate {
+    Q_DECLARE_PUBLIC(TaskTableItem)
+
+    //! Указатель на объявление.
+    TaskTableItem *q_ptr;
+
+    //! Таблица задач.
+    TaskTable *table;
+    //! Сцена графика.
+    AbstractPlotScene *plot_scene;
+    //! Фабрика элементов.
+    AbstractPlotItemFactory *factory;
+
+    //! Кисти стилей.
+    QHash<quint32, QBrush> style_brushes;
+    //! Перья стилей.
+    QHash<quint32, QPen> style_pens;
+
+    //! Элементы задач по номерам строк.
+    QHash<int, AbstractPlotItem *> materialized_items;
+
+    //! Флаг создания элемента для задачи под курсором.
+    bool is_hover_materialized;
+    //! Строка задачи, элемент которой создан при наведении курсора.
+    int hover_row;
+
+    //! Занимаемая область сцены.
+    QRectF bounding_rect;
+
+    //! Конструктор с указателем на объявление \c q.
+    TaskTableItemPrivate(TaskTableItem *q, TaskTable *table, AbstractPlotScene *plot_scene) :
+        q_ptr(q),
+        table(table), plot_scene(plot_scene), factory(0),
+        is_hover_materialized(false), hover_row(-1)
+    {}
+    //! Деструктор.
+    ~TaskTableItemPrivate() {}
+
+    //! Шкала, вдоль которой откладываются начало и конец задач.
+    AbstractScale *scrollScale() const
+    {
+        return (plot_scene->sceneOrientation() == Qt::Horizontal) ? plot_scene->xScale() : plot_scene->yScale();
+    }
+    //! Шкала, вдоль которой откладываются секции.
+    AbstractScale *sectionScale() const
+    {
+        return (plot_scene->sceneOrientation() == Qt::Horizontal) ? plot_scene->yScale() : plot_scene->xScale();
+    }
+
+    //! Создание элемента для задачи \c row.
+    AbstractPlotItem *createItem(int row);
+};
+
+AbstractPlotItem *TaskTableItemPrivate::createItem(int row)
+{
+    Q_Q(TaskTableItem);
+
+    AbstractPlotItem *item = materialized_items.value(row, 0);
+    if ((item != 0) || (factory == 0) || (row < 0) || (row >= table->count()))
+        return item;
+
+    TimelineRecord record;
+    record.begin_value = table->beginValue(row);
+    record.end_value = table->endValue(row);
+    record.id = table->id(row);
+    record.section = table->section(row);
+    record.kind = table->style(row);
+
+    item = factory->createPlotItem(record, plot_scene->sceneOrientation());
+    if (item == 0)
+        return 0;
+
+    plot_scene->addPlotItem(item);
+
+    // сцена без объекта позиционирования элементы не принимает
+    if (item->scene() != plot_scene) {
+        factory->destroyPlotItem(item);
+        return 0;
+    }
+
+    // элемент принадлежит таблице: при уничтожении сцены он удаляется вместе с ней, а не раньше
+    item->setParentItem(q);
+
+    plot_scene->refresh(item);
+
+    materialized_items.insert(row, item);
+    q->update(q->taskRect(row));
+
+    return item;
+}
+
+
+
+TaskTableItem::TaskTableItem(TaskTable *table, AbstractPlotScene *plot_scene) :
+    QGraphicsObject(),
+    d_ptr(new TaskTableItemPrivate(this, table, plot_scene))
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    setZValue(-1.0);
+
+    plot_scene->addItem(this);
+    connect(plot_scene, SIGNAL(layoutChanged()), this, SLOT(refresh()));
+    // сдвиг окна сцены с закрепленной нулевой позицией шкалы меняет только границы сцены
+    connect(plot_scene, SIGNAL(sceneRectChanged(QRectF)), this, SLOT(refresh()));
+
+    refresh();
+}
+
+TaskTableItem::~TaskTableItem()
+{
+    Q_D(TaskTableItem);
+
+    foreach (int row, d->materialized_items.keys())
+        release(row);
+
+    if (d->factory != 0)
+        delete d->factory;
+
+    delete d_ptr;
+}
+
+TaskTable *TaskTableItem::taskTable() const
+{
+    Q_D(const TaskTableItem);
+    return d->table;
+}
+
+AbstractPlotScene *TaskTableItem::plotScene() const
+{
+    Q_D(const TaskTableItem);
+    return d->plot_scene;
+}
+
+AbstractPlotItemFactory *TaskTableItem::plotItemFactory() const
+{
+    Q_D(const TaskTableItem);
+    return d->factory;
+}
+
+void TaskTableItem::setPlotItemFactory(AbstractPlotItemFactory *factory)
+{
+    Q_D(TaskTableItem);
+
+    if (d->factory == factory)
+        return;
+
+    // элементы уничтожаются той фабрикой, которой были созданы
+    foreach (int row, d->materialized_items.keys())
+        release(row);
+
+    if (d->factory != 0)
+        delete d->factory;
+
+    d->factory = factory;
+}
+
+QBrush TaskTableItem::styleBrush(quint32 style) const
+{
+    Q_D(const TaskTableItem);
+    return d->style_brushes.value(style, QBrush(Qt::gray));
+}
+
+void TaskTableItem::setStyleBrush(quint32 style, const QBrush &brush)
+{
+    Q_D(TaskTableItem);
+
+    d->style_brushes.insert(style, brush);
+    update();
+}
+
+QPen TaskTableItem::stylePen(quint32 style) const
+{
+    Q_D(const TaskTableItem);
+    return d->style_pens.value(style, QPen(Qt::NoPen));
+}
+
+void TaskTableItem::setStylePen(quint32 style, const QPen &pen)
+{
+    Q_D(TaskTableItem);
+
+    d->style_pens.insert(style, pen);
+    update();
+}
+
+bool TaskTableItem::isHoverMaterialized() const
+{
+    Q_D(const TaskTableItem);
+    return d->is_hover_materialized;
+}
+
+void TaskTableItem::setHoverMaterialized(bool on)
+{
+    Q_D(TaskTableItem);
+
+    d->is_hover_materialized = on;
+    setAcceptHoverEvents(on);
+
+    if (!on && (d->hover_row >= 0)) {
+        release(d->hover_row);
+        d->hover_row = -1;
+    }
+}
+
+int TaskTableItem::taskAt(const QPointF &scene_pos) const
+{
+    const QVector<int> rows = tasks(QRectF(scene_pos, QSizeF(0.0, 0.0)));
+
+    // задачи рисуются в порядке строк индекса, поэтому верхняя - последняя подходящая
+    for (int i = rows.size() - 1; i >= 0; -- i) {
+        const QRectF rect = taskRect(rows.at(i));
+
+        if ((scene_pos.x() >= rect.left()) && (scene_pos.x() <= rect.right()) &&
+            (scene_pos.y() >= rect.top()) && (scene_pos.y() <= rect.bottom()))
+            return rows.at(i);
+    }
+
+    return -1;
+}
+
+QVector<int> TaskTableItem::tasks(const QRectF &scene_rect) const
+{
+    Q_D(const TaskTableItem);
+
+    if ((d->plot_scene->xScale() == 0) || (d->plot_scene->yScale() == 0))
+        return QVector<int>();
+
+    const QPointF first_values = d->plot_scene->mapToScales(scene_rect.topLeft());
+    const QPointF last_values = d->plot_scene->mapToScales(scene_rect.bottomRight());
+
+    const bool is_horizontal = (d->plot_scene->sceneOrientation() == Qt::Horizontal);
+
+    const double first_scroll_value = is_horizontal ? first_values.x() : first_values.y();
+    const double last_scroll_value = is_horizontal ? last_values.x() : last_values.y();
+    const double first_section_value = is_horizontal ? first_values.y() : first_values.x();
+    const double last_section_value = is_horizontal ? last_values.y() : last_values.x();
+
+    const double section_from = qMax(0.0, floor(qMin(first_section_value, last_section_value)));
+    const double section_to = floor(qMax(first_section_value, last_section_value));
+
+    if (section_to < 0.0)
+        return QVector<int>();
+
+    return d->table->find(qMin(first_scroll_value, last_scroll_value), qMax(first_scroll_value, last_scroll_value),
+                          uint(section_from), uint(qMin(section_to, 4294967295.0)));
+}
+
+QRectF TaskTableItem::taskRect(int row) const
+{
+    Q_D(const TaskTableItem);
+
+    const AbstractScale *scroll_scale = d->scrollScale();
+    const AbstractScale *section_scale = d->sectionScale();
+
+    if ((scroll_scale == 0) || (section_scale == 0) || (row < 0) || (row >= d->table->count()))
+        return QRectF();
+
+    const double begin_value = d->table->beginValue(row);
+    const double end_value = d->table->endValue(row);
+    const double section = double(d->table->section(row));
+
+    const double scroll_position = scroll_scale->position(begin_value);
+    const double scroll_length = scroll_scale->distance(begin_value, end_value);
+
+    // у дискретной шкалы расстояние от секции до нее же - размер секции, у числовой - ноль
+    double section_length = section_scale->distance(section, section);
+    if (section_length <= 0.0)
+        section_length = section_scale->distance(section, section + 1.0);
+
+    const double section_position = section_scale->position(section);
+
+    const QRectF rect = (d->plot_scene->sceneOrientation() == Qt::Horizontal)
+                        ? QRectF(scroll_position, section_position, scroll_length, section_length)
+                        : QRectF(section_position, scroll_position, section_length, scroll_length);
+
+    return rect.normalized();
+}
+
+AbstractPlotItem *TaskTableItem::materialize(int row)
+{
+    Q_D(TaskTableItem);
+
+    // элемент, созданный наведением курсора, закрепляется
+    if (row == d->hover_row)
+        d->hover_row = -1;
+
+    return d->createItem(row);
+}
+
+void TaskTableItem::release(int row)
+{
+    Q_D(TaskTableItem);
+
+    AbstractPlotItem *item = d->materialized_items.take(row);
+    if (item == 0)
+        return;
+
+    if (row == d->hover_row)
+        d->hover_row = -1;
+
+    d->plot_scene->removePlotItem(item);
+
+    if (d->factory != 0)
+        d->factory->destroyPlotItem(item);
+    else
+        delete item;
+
+    update(taskRect(row));
+}
+
+AbstractPlotItem *TaskTableItem::materializedItem(int row) const
+{
+    Q_D(const TaskTableItem);
+    return d->materialized_items.value(row, 0);
+}
+
+QRectF TaskTableItem::boundingRect() const
+{
+    Q_D(const TaskTableItem);
+    return d->bounding_rect;
+}
+
+void TaskTableItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_D(TaskTableItem);
+    Q_UNUSED(widget);
+
+    const QVector<int> rows = tasks(option->exposedRect);
+
+    bool has_style = false;
+    quint32 current_style = 0;
+
+    foreach (int row, rows) {
+        if (d->materialized_items.contains(row))
+            continue;
+
+        // состояние рисования меняется только при смене стиля
+        const quint32 style = d->table->style(row);
+        if (!has_style || (style != current_style)) {
+            painter->setBrush(styleBrush(style));
+            painter->setPen(stylePen(style));
+            current_style = style;
+            has_style = true;
+        }
+
+        QRectF rect = taskRect(row);
+        if (rect.width() < 1.0)
+            rect.setWidth(1.0);
+        if (rect.height() < 1.0)
+            rect.setHeight(1.0);
+
+        painter->drawRect(rect);
+
+        // материализованные задачи учитываются виджетом отображения как обычные элементы
+        GRAPHICS_STATISTICS_COUNT(d->plot_scene->statistics(), ItemsPainted, 1);
+    }
+}
+
+void TaskTableItem::refresh()
+{
+    Q_D(TaskTableItem);
+
+    prepareGeometryChange();
+    d->bounding_rect = d->plot_scene->sceneRect();
+
+    update();
+}
+
+void TaskTableItem::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
+{
+    Q_D(TaskTableItem);
+
+    QGraphicsObject::hoverMoveEvent(event);
+
+    if (!d->is_hover_materialized)
+        return;
+
+    const int row = taskAt(event->scenePos());
+    if (row == d->hover_row)
+        return;
+
+    if (d->hover_row >= 0)
+        release(d->hover_row);
+
+    if ((row >= 0) && (d->materialized_items.value(row, 0) == 0) && (d->createItem(row) != 0))
+        d->hover_row = row;
+}
+
+} // namespace Graphics
@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <QFile>
+
+#include "include/timelinefile.h"
+
+
+namespace Graphics {
+
+namespace {
+
+//! Сигнатура файла расписания.
+const char timeline_magic[8] = { 'G', 'T', 'L', 'I', 'N', 'E', '\0', '\0' };
+//! Версия формата файла расписания.
+const quint32 timeline_version = 1;
+//! Метка порядка байтов платформы записи.
+const quint32 timeline_byte_order = 0x01020304;
+
+//! Заголовок файла расписания.
+struct FileHeader {
+    //! Сигнатура.
+    char magic[8];
+    //! Версия формата.
+    quint32 version;
+    //! Метка порядка байтов.
+    quint32 byte_order;
+    //! Количество записей.
+    quint64 records_count;
+    //! Количество блоков.
+    quint64 blocks_count;
+    //! Количество секций.
+    quint64 sections_count;
+    //! Смещение записей от начала файла.
+    quint64 records_offset;
+    //! Смещение таблицы блоков от начала файла.
+    quint64 blocks_offset;
+    //! Смещение таблицы секций от начала файла.
+    quint64 sections_offset;
+    //! Наименьшее начало записей.
+    double begin_value;
+    //! Наибольший конец записей.
+    double end_value;
+};
+
+//! Блок записей одной секции.
+struct FileBlock {
+    //! Номер первой записи блока.
+    quint64 first_record;
+    //! Количество записей блока.
+    quint64 records_count;
+    //! Начало первой записи блока.
+    double begin_value;
+    //! Наибольший конец записей секции от первого блока секции до этого блока включительно.
+    double end_value;
+};
+
+//! Диапазон блоков секции.
+struct FileSection {
+    //! Номер первого блока секции.
+    quint64 first_block;
+    //! Количество блоков секции.
+    quint64 blocks_count;
+};
+
+//! Наибольшее количество секций, таблица которых помещается в QVector.
+const quint64 timeline_max_sections_count = quint64(std::numeric_limits<int>::max()) / sizeof(FileSection);
+
+//! Сравнение записей \c left и \c right по секции и началу.
+bool lessRecord(const TimelineRecord &left, const TimelineRecord &right)
+{
+    if (left.section != right.section)
+        return left.section < right.section;
+
+    return left.begin_value < right.begin_value;
+}
+
+//! Сравнение наибольшего конца записей блока \c block со значением \c value.
+bool blockEndsBefore(const FileBlock &block, double value)
+{
+    return block.end_value <= value;
+}
+
+//! Сравнение значения \c value с началом блока \c block.
+bool blockBeginsAfter(double value, const FileBlock &block)
+{
+    return value <= block.begin_value;
+}
+
+//! Запись в файл \c file данных \c data размером \c size байт.
+bool writeData(QFile *file, const void *data, qint64 size)
+{
+    return file->write(static_cast<const char *>(data), size) == size;
+}
+
+} // namespace
+
+//! Реализация класса файла расписания.
+class TimelineFilePrivate {
+public:
+    //! Файл.
+    QFile file;
+    //! Отображение файла в память.
+    uchar *data;
+    //! Описание последней ошибки.
+    QString error_string;
+
+    //! Заголовок файла.
+    const FileHeader *header;
+    //! Записи.
+    const TimelineRecord *records;
+    //! Таблица блоков.
+    const FileBlock *blocks;
+    //! Таблица секций.
+    const FileSection *sections;
+
+    //! Конструктор.
+    TimelineFilePrivate() : data(0), header(0), records(0), blocks(0), sections(0) {}
+
+    //! Проверка размещения таблицы из \c count элементов по \c item_size байт со смещения \c offset в файле размером \c file_size.
+    static bool isTableInside(quint64 offset, quint64 count, quint64 item_size, quint64 file_size)
+    {
+        return (offset % 8 == 0) && (offset <= file_size) && (count <= (file_size - offset) / item_size);
+    }
+};
+
+
+
+TimelineFile::TimelineFile() :
+    d_ptr(new TimelineFilePrivate())
+{
+}
+
+TimelineFile::~TimelineFile()
+{
+    close();
+    delete d_ptr;
+}
+
+bool TimelineFile::open(const QString &file_name)
+{
+    Q_D(TimelineFile);
+
+    close();
+
+    d->file.setFileName(file_name);
+
+    if (!d->file.open(QIODevice::ReadOnly)) {
+        d->error_string = d->file.errorString();
+        return false;
+    }
+
+    const quint64 file_size = quint64(d->file.size());
+
+    if (file_size < sizeof(FileHeader)) {
+        d->error_string = QLatin1String("File is too small for a timeline header");
+        d->file.close();
+        return false;
+    }
+
+    // файл отображается целиком: страницы читаются системой только при обращении
+    d->data = d->file.map(0, qint64(file_size));
+    if (d->data == 0) {
+        d->error_string = d->file.errorString();
+        d->file.close();
+        return false;
+    }
+
+    const FileHeader *header = reinterpret_cast<const FileHeader *>(d->data);
+
+    bool is_valid = (std::memcmp(header->magic, timeline_magic, sizeof(timeline_magic)) == 0);
+    if (!is_valid)
+        d->error_string = QLatin1String("File is not a timeline file");
+
+    if (is_valid && ((header->version != timeline_version) || (header->byte_order != timeline_byte_order))) {
+        d->error_string = QLatin1String("Unsupported timeline file version or byte order");
+        is_valid = false;
+    }
+
+    if (is_valid && !(TimelineFilePrivate::isTableInside(header->records_offset, header->records_count,
+                                                         sizeof(TimelineRecord), file_size) &&
+                      TimelineFilePrivate::isTableInside(header->blocks_offset, header->blocks_count,
+                                                         sizeof(FileBlock), file_size) &&
+                      TimelineFilePrivate::isTableInside(header->sections_offset, header->sections_count,
+                                                         sizeof(FileSection), file_size))) {
+        d->error_string = QLatin1String("Timeline file is truncated");
+        is_valid = false;
+    }
+
+    if (!is_valid) {
+        d->file.unmap(d->data);
+        d->data = 0;
+        d->file.close();
+        return false;
+    }
+
+    d->header = header;
+    d->records = reinterpret_cast<const TimelineRecord *>(d->data + header->records_offset);
+    d->blocks = reinterpret_cast<const FileBlock *>(d->data + header->blocks_offset);
+    d->sections = reinterpret_cast<const FileSection *>(d->data + header->sections_offset);
+
+    // таблица секций мала, поэтому проверяется сразу, а блоки - при поиске
+    for (quint64 section = 0; section < header->sections_count; ++ section) {
+        const FileSection &file_section = d->sections[section];
+
+        if ((file_section.first_block > header->blocks_count) ||
+            (file_section.blocks_count > header->blocks_count - file_section.first_block)) {
+            d->error_string = QLatin1String("Timeline file has an invalid section table");
+            close();
+            return false;
+        }
+    }
+
+    d->error_string.clear();
+
+    return true;
+}
+
+void TimelineFile::close()
+{
+    Q_D(TimelineFile);
+
+    if (d->data != 0) {
+        d->file.unmap(d->data);
+        d->data = 0;
+    }
+
+    d->file.close();
+
+    d->header = 0;
+    d->records = 0;
+    d->blocks = 0;
+    d->sections = 0;
+}
+
+bool TimelineFile::isOpen() const
+{
+    Q_D(const TimelineFile);
+    return d->header != 0;
+}
+
+QString TimelineFile::errorString() const
+{
+    Q_D(const TimelineFile);
+    return d->error_string;
+}
+
+quint64 TimelineFile::recordsCount() const
+{
+    Q_D(const TimelineFile);
+    return (d->header != 0) ? d->header->records_count : 0;
+}
+
+uint TimelineFile::sectionsCount() const
+{
+    Q_D(const TimelineFile);
+    return (d->header != 0) ? uint(d->header->sections_count) : 0;
+}
+
+double TimelineFile::beginValue() const
+{
+    Q_D(const TimelineFile);
+    return (d->header != 0) ? d->header->begin_value : 0.0;
+}
+
+double TimelineFile::endValue() const
+{
+    Q_D(const TimelineFile);
+    return (d->header != 0) ? d->header->end_value : 0.0;
+}
+
+const TimelineRecord &TimelineFile::record(quint64 index) const
+{
+    Q_D(const TimelineFile);
+
+    Q_ASSERT(index < recordsCount());
+
+    return d->records[index];
+}
+
+QVector<quint64> TimelineFile::findRecords(double begin_value, double end_value) const
+{
+    Q_D(const TimelineFile);
+
+    QVector<quint64> indexes;
+
+    if (d->header == 0)
+        return indexes;
+
+    for (quint64 section = 0; section < d->header->sections_count; ++ section) {
+        const FileBlock *section_begin = d->blocks + d->sections[section].first_block;
+        const FileBlock *section_end = section_begin + d->sections[section].blocks_count;
+
+        // наибольший конец растет от блока к блоку, начало блоков тоже упорядочено
+        const FileBlock *first_block = std::lower_bound(section_begin, section_end, begin_value, blockEndsBefore);
+        const FileBlock *last_block = std::upper_bound(first_block, section_end, end_value, blockBeginsAfter);
+
+        for (const FileBlock *block = first_block; block != last_block; ++ block) {
+            if ((block->first_record > d->header->records_count) ||
+                (block->records_count > d->header->records_count - block->first_record))
+                continue;
+
+            const TimelineRecord *record = d->records + block->first_record;
+            const TimelineRecord *block_end = record + block->records_count;
+
+            for (; (record != block_end) && (record->begin_value < end_value); ++ record) {
+                if (record->end_value > begin_value)
+                    indexes.append(quint64(record - d->records));
+            }
+        }
+    }
+
+    return indexes;
+}
+
+bool TimelineFile::write(const QString &file_name, const QVector<TimelineRecord> &records,
+                         int block_size, QString *error_string)
+{
+    QVector<TimelineRecord> sorted_records = records;
+    std::stable_sort(sorted_records.begin(), sorted_records.end(), lessRecord);
+
+    block_size = qMax(block_size, 1);
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, timeline_magic, sizeof(timeline_magic));
+    header.version = timeline_version;
+    header.byte_order = timeline_byte_order;
+    header.records_count = quint64(sorted_records.size());
+    header.sections_count = sorted_records.isEmpty() ? 0 : (quint64(sorted_records.last().section) + 1);
+
+    // таблица секций плотная, поэтому номер последней секции задает ее размер
+    if (header.sections_count > timeline_max_sections_count) {
+        if (error_string != 0)
+            *error_string = QLatin1String("Timeline section number is too large");
+        return false;
+    }
+
+    QVector<FileSection> sections(int(header.sections_count));
+    QVector<FileBlock> blocks;
+
+    for (int i = 0; i < sorted_records.size(); ) {
+        const quint32 section = sorted_records.at(i).section;
+
+        FileSection &file_section = sections[int(section)];
+        file_section.first_block = quint64(blocks.size());
+
+        double section_end_value = sorted_records.at(i).end_value;
+
+        while ((i < sorted_records.size()) && (sorted_records.at(i).section == section)) {
+            FileBlock block;
+            block.first_record = quint64(i);
+            block.records_count = 0;
+            block.begin_value = sorted_records.at(i).begin_value;
+
+            for (; (i < sorted_records.size()) && (sorted_records.at(i).section == section) &&
+                   (block.records_count < quint64(block_size)); ++ i, ++ block.records_count)
+                section_end_value = qMax(section_end_value, sorted_records.at(i).end_value);
+
+            block.end_value = section_end_value;
+            blocks.append(block);
+        }
+
+        file_section.blocks_count = quint64(blocks.size()) - file_section.first_block;
+    }
+
+    header.blocks_count = quint64(blocks.size());
+    header.records_offset = sizeof(FileHeader);
+    header.blocks_offset = header.records_offset + header.records_count * sizeof(TimelineRecord);
+    header.sections_offset = header.blocks_offset + header.blocks_count * sizeof(FileBlock);
+
+    if (!sorted_records.isEmpty()) {
+        header.begin_value = sorted_records.first().begin_value;
+        header.end_value = sorted_records.first().end_value;
+
+        foreach (const TimelineRecord &record, sorted_records) {
+            header.begin_value = qMin(header.begin_value, record.begin_value);
+            header.end_value = qMax(header.end_value, record.end_value);
+        }
+    }
+
+    QFile file(file_name);
+
+    bool is_written = file.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+                      writeData(&file, &header, sizeof(header)) &&
+                      writeData(&file, sorted_records.constData(), qint64(sorted_records.size()) * sizeof(TimelineRecord)) &&
+                      writeData(&file, blocks.constData(), qint64(blocks.size()) * sizeof(FileBlock)) &&
+                      writeData(&file, sections.constData(), qint64(sections.size()) * sizeof(FileSection));
+
+    if (!is_written && (error_string != 0))
+        *error_string = file.errorString();
+
+    return is_written;
+}
+
+} // namespace Graphics
@@ -0,0 +1,253 @@
+#include <QHash>
+
+#include "include/timelineplotscene.h"
+#include "include/timelinefile.h"
+#include "include/abstractplotitemfactory.h"
+#include "include/abstractplotitem.h"
+#include "include/abstractscale.h"
+
+
+namespace Graphics {
+
+//! Реализация сцены, подгружающей элементы из файла расписания.
+class TimelinePlotScenePrivate {
+    Q_DECLARE_PUBLIC(TimelinePlotScene)
+
+    //! Указатель на объявление.
+    TimelinePlotScene *q_ptr;
+
+    //! Файл расписания.
+    TimelineFile *file;
+    //! Фабрика элементов графика.
+    AbstractPlotItemFactory *factory;
+
+    //! Созданные элементы по номерам записей.
+    QHash<quint64, AbstractPlotItem *> record_items;
+    //! Номера записей созданных элементов.
+    QHash<AbstractPlotItem *, quint64> item_records;
+
+    //! Конструктор с указателем на объявление \c q.
+    TimelinePlotScenePrivate(TimelinePlotScene *q) : q_ptr(q), file(0), factory(0) {}
+    //! Деструктор.
+    ~TimelinePlotScenePrivate() {}
+
+    //! Удаление элемента \c item из таблиц созданных элементов.
+    void forget(AbstractPlotItem *item);
+    //! Уничтожение элементов \c items фабрикой, которой они созданы.
+    void destroy(const QList<AbstractPlotItem *> &items);
+    //! Удаление с графика и уничтожение элементов \c items.
+    void destroyItems(const QList<AbstractPlotItem *> &items);
+};
+
+void TimelinePlotScenePrivate::forget(AbstractPlotItem *item)
+{
+    QHash<AbstractPlotItem *, quint64>::iterator it = item_records.find(item);
+    if (it == item_records.end())
+        return;
+
+    record_items.remove(it.value());
+    item_records.erase(it);
+}
+
+void TimelinePlotScenePrivate::destroy(const QList<AbstractPlotItem *> &items)
+{
+    foreach (AbstractPlotItem *item, items) {
+        if (factory != 0)
+            factory->destroyPlotItem(item);
+        else
+            delete item;
+    }
+}
+
+void TimelinePlotScenePrivate::destroyItems(const QList<AbstractPlotItem *> &items)
+{
+    Q_Q(TimelinePlotScene);
+
+    if (items.isEmpty())
+        return;
+
+    q->removePlotItems(items);
+
+    destroy(items);
+}
+
+
+
+TimelinePlotScene::TimelinePlotScene(QObject *parent) :
+    InfinitePlotScene(parent),
+    d_ptr(new TimelinePlotScenePrivate(this))
+{
+}
+
+TimelinePlotScene::~TimelinePlotScene()
+{
+    Q_D(TimelinePlotScene);
+
+    // деструктор базовой сцены уничтожил бы элементы очереди в обход фабрики
+    clearPendingPlotItems();
+
+    d->destroyItems(d->record_items.values());
+
+    if (d->factory != 0)
+        delete d->factory;
+
+    delete d_ptr;
+}
+
+TimelineFile *TimelinePlotScene::timelineFile() const
+{
+    Q_D(const TimelinePlotScene);
+    return d->file;
+}
+
+void TimelinePlotScene::setTimelineFile(TimelineFile *file)
+{
+    Q_D(TimelinePlotScene);
+
+    if (d->file == file)
+        return;
+
+    d->file = file;
+
+    reload();
+}
+
+AbstractPlotItemFactory *TimelinePlotScene::plotItemFactory() const
+{
+    Q_D(const TimelinePlotScene);
+    return d->factory;
+}
+
+void TimelinePlotScene::setPlotItemFactory(AbstractPlotItemFactory *factory)
+{
+    Q_D(TimelinePlotScene);
+
+    if (d->factory == factory)
+        return;
+
+    // элементы уничтожаются той фабрикой, которой были созданы
+    clearPendingPlotItems();
+    d->destroyItems(d->record_items.values());
+
+    if (d->factory != 0)
+        delete d->factory;
+
+    d->factory = factory;
+
+    reload();
+}
+
+void TimelinePlotScene::reload()
+{
+    Q_D(TimelinePlotScene);
+
+    clearPendingPlotItems();
+    d->destroyItems(d->record_items.values());
+
+    AbstractScale *scroll_scale = (sceneOrientation() == Qt::Horizontal) ? xScale() : yScale();
+    if (scroll_scale != 0)
+        populate(scroll_scale->minimum(), scroll_scale->maximum());
+}
+
+void TimelinePlotScene::removePlotItem(AbstractPlotItem *item)
+{
+    Q_D(TimelinePlotScene);
+
+    d->forget(item);
+
+    InfinitePlotScene::removePlotItem(item);
+}
+
+void TimelinePlotScene::removePlotItems(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(TimelinePlotScene);
+
+    foreach (AbstractPlotItem *item, items)
+        d->forget(item);
+
+    InfinitePlotScene::removePlotItems(items);
+}
+
+void TimelinePlotScene::cleanup(double begin_value, double end_value)
+{
+    Q_D(TimelinePlotScene);
+
+    if ((d->file == 0) || !d->file->isOpen())
+        return;
+
+    AbstractScale *scroll_scale = (sceneOrientation() == Qt::Horizontal) ? xScale() : yScale();
+    if (scroll_scale == 0)
+        return;
+
+    // очищается начало или конец диапазона шкалы (или весь диапазон), поэтому остающаяся
+    // область - диапазон шкалы без очищаемой области
+    double kept_begin_value = scroll_scale->minimum();
+    double kept_end_value = scroll_scale->maximum();
+
+    if (begin_value <= kept_begin_value)
+        kept_begin_value = qMax(kept_begin_value, end_value);
+    if (end_value >= kept_end_value)
+        kept_end_value = qMin(kept_end_value, begin_value);
+
+    // элемент, выступающий за очищаемую область, остается, пока пересекает остающуюся,
+    // и удаляется следующей очисткой, которая его не оставит;
+    // элементы очереди подгрузки уничтожаются только через discard()
+    QList<AbstractPlotItem *> cleaned_items;
+
+    const bool is_range_cleaned = (kept_begin_value >= kept_end_value);
+
+    for (QHash<quint64, AbstractPlotItem *>::const_iterator it = d->record_items.constBegin();
+         it != d->record_items.constEnd(); ++ it) {
+        if (it.value()->plotScene() == 0)
+            continue;
+
+        const TimelineRecord &record = d->file->record(it.key());
+
+        if (is_range_cleaned || (record.end_value <= kept_begin_value) || (record.begin_value >= kept_end_value))
+            cleaned_items.append(it.value());
+    }
+
+    d->destroyItems(cleaned_items);
+}
+
+void TimelinePlotScene::populate(double begin_value, double end_value)
+{
+    Q_D(TimelinePlotScene);
+
+    if ((d->file == 0) || !d->file->isOpen() || (d->factory == 0) || (layout() == 0) ||
+        (begin_value >= end_value))
+        return;
+
+    const QVector<quint64> indexes = d->file->findRecords(begin_value, end_value);
+
+    QList<AbstractPlotItem *> created_items;
+    created_items.reserve(indexes.size());
+
+    foreach (quint64 index, indexes) {
+        if (d->record_items.contains(index))
+            continue;
+
+        AbstractPlotItem *item = d->factory->createPlotItem(d->file->record(index), sceneOrientation());
+        if (item == 0)
+            continue;
+
+        d->record_items.insert(index, item);
+        d->item_records.insert(item, index);
+        created_items.append(item);
+    }
+
+    // элементы добавляются на график порциями, начиная с ближайших к видимой области
+    queuePlotItems(created_items);
+}
+
+void TimelinePlotScene::discard(const QList<AbstractPlotItem *> &items)
+{
+    Q_D(TimelinePlotScene);
+
+    foreach (AbstractPlotItem *item, items)
+        d->forget(item);
+
+    d->destroy(items);
+}
+
+} // namespace Graphics